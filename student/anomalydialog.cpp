@@ -0,0 +1,108 @@
+#include "anomalydialog.h"
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QDateTime>
+
+AnomalyDialog::AnomalyDialog(QWidget *parent)
+    : QDialog(parent)
+    , m_table(new QTableWidget(this))
+    , m_labStatus(new QLabel(this))
+    , m_btnExport(new QPushButton("导出 CSV...", this))
+{
+    setWindowTitle("成绩异常检测");
+    resize(900, 560);
+
+    m_table->setColumnCount(7);
+    m_table->setHorizontalHeaderLabels({"考试日期", "类型", "班级", "科目", "学号", "姓名", "说明"});
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->horizontalHeader()->setStretchLastSection(true);
+
+    m_btnExport->setEnabled(false);
+    connect(m_btnExport, &QPushButton::clicked, this, &AnomalyDialog::exportCsv);
+
+    QHBoxLayout *top = new QHBoxLayout();
+    top->addWidget(m_labStatus, 1);
+    top->addWidget(m_btnExport);
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(top);
+    layout->addWidget(m_table);
+}
+
+AnomalyDialog::~AnomalyDialog()
+{
+    m_progress->canceled = true;
+    if (m_thread) m_thread->wait();
+}
+
+void AnomalyDialog::scan(const AnomalyOptions& options)
+{
+    if (m_thread) return;
+    m_progress = std::make_shared<TaskProgress>();
+    m_btnExport->setEnabled(false);
+    m_labStatus->setText("正在扫描...");
+
+    auto report = std::make_shared<AnomalyReport>();
+    m_thread = runInBackground(
+        this, m_progress,
+        [options, report](TaskProgress& progress) {
+            *report = AnomalyScanner::scan(options, [&progress](qint64 rows) { return progress.update(rows); });
+        },
+        [this](qint64 scanned) { m_labStatus->setText(QString("正在扫描... 已检查 %1 条成绩").arg(scanned)); },
+        [this, report]() {
+            m_thread = nullptr;
+            showReport(*report);
+        });
+}
+
+void AnomalyDialog::showReport(const AnomalyReport& report)
+{
+    m_report = report;
+    if (!report.error.isEmpty()) {
+        m_labStatus->setText("扫描失败：" + report.error);
+        return;
+    }
+
+    m_table->setUpdatesEnabled(false);
+    m_table->setRowCount(report.findings.size());
+    for (int row = 0; row < report.findings.size(); row++) {
+        const AnomalyFinding& finding = report.findings.at(row);
+        QStringList texts{finding.examDate.toString("yyyy-MM-dd"), finding.kindText(), finding.className,
+                          finding.courseName, finding.isBatch() ? QString() : QString::number(finding.studentId),
+                          finding.studentName, finding.description()};
+        for (int col = 0; col < texts.size(); col++) {
+            QTableWidgetItem *item = new QTableWidgetItem(texts.at(col));
+            // 批次异常影响整班，优先处理
+            if (finding.isBatch()) item->setForeground(Qt::red);
+            m_table->setItem(row, col, item);
+        }
+    }
+    m_table->setUpdatesEnabled(true);
+    m_table->resizeColumnsToContents();
+    m_btnExport->setEnabled(!report.findings.isEmpty());
+
+    QString text = QString("扫描 %1 条成绩（%2 个学生×科目序列、%3 个考试批次），发现 %4 处异常，耗时 %5 ms")
+                       .arg(report.scannedRows).arg(report.streams).arg(report.batches)
+                       .arg(report.findings.size() + report.truncated).arg(report.elapsedMs);
+    if (report.truncated > 0) text += QString("（仅列出前 %1 处）").arg(report.findings.size());
+    m_labStatus->setText(text);
+}
+
+void AnomalyDialog::exportCsv()
+{
+    QString defaultName = QString("anomalies_%1.csv").arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+    QString filePath = QFileDialog::getSaveFileName(this, "导出异常列表", defaultName, "CSV 文件 (*.csv)");
+    if (filePath.isEmpty()) return;
+
+    QString error;
+    if (!m_report.writeCsv(filePath, &error)) {
+        QMessageBox::critical(this, "错误", "导出失败：" + error);
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef ANOMALYDIALOG_H
+#define ANOMALYDIALOG_H
+
+#include <QDialog>
+#include <QPointer>
+#include <QThread>
+#include <memory>
+#include "anomalyscanner.h"
+#include "backgroundtask.h"
+
+class QTableWidget;
+class QLabel;
+class QPushButton;
+
+// 成绩异常列表：可在对话框内后台扫描，也可直接显示录入后自动检测的结果
+class AnomalyDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit AnomalyDialog(QWidget *parent = nullptr);
+    ~AnomalyDialog() override;
+
+    // 后台扫描并显示进度；关闭对话框时中止
+    void scan(const AnomalyOptions& options);
+    void showReport(const AnomalyReport& report);
+
+private slots:
+    void exportCsv();
+
+private:
+    QTableWidget *m_table;
+    QLabel *m_labStatus;
+    QPushButton *m_btnExport;
+    AnomalyReport m_report;
+    QPointer<QThread> m_thread;
+    std::shared_ptr<TaskProgress> m_progress = std::make_shared<TaskProgress>();
+};
+
+#endif // ANOMALYDIALOG_H
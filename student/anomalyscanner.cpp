@@ -0,0 +1,302 @@
+#include "anomalyscanner.h"
+#include "dbmanager.h"
+#include "schema.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSaveFile>
+#include <QSet>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 指数加权均值/方差（增量形式），每个序列 O(1) 状态
+struct EwmaStats {
+    double mean = 0;
+    double var = 0;
+    int count = 0;
+
+    double zScore(double x, double minSd) const { return (x - mean) / std::sqrt(std::max(var, minSd * minSd)); }
+    void add(double x, double alpha)
+    {
+        if (count++ == 0) {
+            mean = x;
+            return;
+        }
+        double diff = x - mean;
+        double increment = alpha * diff;
+        mean += increment;
+        var = (1 - alpha) * (var + diff * increment);
+    }
+};
+
+// 扫描过程中收集异常：超过上限只计数
+class FindingSink
+{
+public:
+    FindingSink(const AnomalyOptions& options, AnomalyReport& report) : m_options(options), m_report(report) {}
+
+    void add(const AnomalyFinding& finding)
+    {
+        if (m_options.reportFrom.isValid() && finding.examDate < m_options.reportFrom) return;
+        if (m_report.findings.size() >= m_options.maxFindings) {
+            m_report.truncated++;
+            return;
+        }
+        m_report.findings.append(finding);
+    }
+
+private:
+    const AnomalyOptions& m_options;
+    AnomalyReport& m_report;
+};
+
+// 班级/科目/日期条件（以 " AND " 开头）；班级名需绑定
+QString filterSql(const AnomalyOptions& options, const QString& classCondition, const QString& courseColumn,
+                  const QString& dateColumn)
+{
+    QString sql;
+    if (!options.className.isEmpty()) sql += " AND " + classCondition;
+    if (!options.courseIds.isEmpty()) {
+        QStringList ids;
+        for (int id : options.courseIds) ids << QString::number(id);
+        sql += QString(" AND %1 IN (%2)").arg(courseColumn, ids.join(", "));
+    }
+    return sql + DBManager::dateRangeSql(dateColumn, options.from, options.to);
+}
+
+QByteArray csvText(const QString& text)
+{
+    QByteArray utf8 = text.toUtf8();
+    if (!utf8.contains(',') && !utf8.contains('"') && !utf8.contains('\n')) return utf8;
+    return '"' + utf8.replace("\"", "\"\"") + '"';
+}
+
+} // namespace
+
+QString AnomalyFinding::kindText() const
+{
+    switch (kind) {
+    case ScoreDrop: return "成绩骤降";
+    case ScoreSpike: return "成绩骤升";
+    case BatchAllZero: return "整批0分";
+    case BatchUniform: return "整批同分";
+    case BatchLowScores: return "大量极低分";
+    case BatchShift: return "班级均分骤变";
+    }
+    return QString();
+}
+
+QString AnomalyFinding::description() const
+{
+    switch (kind) {
+    case ScoreDrop:
+    case ScoreSpike:
+        return QString("%1 分，近期基线 %2 分（z=%3）").arg(value, 0, 'f', 1).arg(expected, 0, 'f', 1).arg(zScore, 0, 'f', 1);
+    case BatchAllZero:
+        return QString("%1 人全部为 0 分，疑似提交错误").arg(count);
+    case BatchUniform:
+        return QString("%1 人全部为 %2 分，疑似批量填充").arg(count).arg(value, 0, 'f', 1);
+    case BatchLowScores:
+        return QString("%1 人中 %2% 低于 10 分").arg(count).arg(zScore * 100, 0, 'f', 0);
+    case BatchShift:
+        return QString("%1 人平均 %2 分，该班该科历次平均 %3 分（z=%4）")
+            .arg(count).arg(value, 0, 'f', 1).arg(expected, 0, 'f', 1).arg(zScore, 0, 'f', 1);
+    }
+    return QString();
+}
+
+bool AnomalyReport::writeCsv(const QString& filePath, QString *errorMessage) const
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+    QByteArray out("\xEF\xBB\xBF");
+    out += csvText("类型") + ',' + csvText("考试日期") + ',' + csvText("班级") + ',' + csvText("科目") + ','
+           + csvText("学号") + ',' + csvText("姓名") + ',' + csvText("说明") + '\n';
+    for (const AnomalyFinding& finding : findings) {
+        out += csvText(finding.kindText()) + ',' + finding.examDate.toString("yyyy-MM-dd").toLatin1() + ','
+               + csvText(finding.className) + ',' + csvText(finding.courseName) + ','
+               + (finding.isBatch() ? QByteArray() : QByteArray::number(finding.studentId)) + ','
+               + csvText(finding.studentName) + ',' + csvText(finding.description()) + '\n';
+    }
+    file.write(out);
+    if (!file.commit()) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+AnomalyReport AnomalyScanner::scan(const AnomalyOptions& options, const std::function<bool(qint64)>& progress)
+{
+    QElapsedTimer timer;
+    timer.start();
+    AnomalyReport report;
+    FindingSink sink(options, report);
+    DBManager& db = DBManager::getInstance();
+    QSqlDatabase connection = db.threadConnection();
+
+    // 1. 学生成绩序列：学号→科目→日期 有序（主表走 idx_scores_student），同一序列连续出现，
+    //    任一时刻只保留当前序列的统计量
+    QString sql = QString(
+                      "SELECT sc.student_id, sc.course_id, sc.exam_date, sc.score FROM %1 sc "
+                      "WHERE sc.course_id IS NOT NULL AND sc.score >= 0 AND sc.score <= 100%2 "
+                      "ORDER BY sc.student_id, sc.course_id, sc.exam_date, sc.score_id")
+                      .arg(db.scoreSource(options.from, options.to),
+                           filterSql(options, "sc.student_id IN (SELECT student_id FROM students WHERE class_name = ?)",
+                                     "sc.course_id", "sc.exam_date"));
+    QSqlQuery query(connection);
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    if (!options.className.isEmpty()) query.addBindValue(options.className);
+    if (!query.exec()) {
+        report.error = "查询成绩失败：" + query.lastError().text();
+        return report;
+    }
+
+    EwmaStats stream;
+    qint64 currentStudent = -1;
+    int currentCourse = -1;
+    while (query.next()) {
+        qint64 studentId = query.value(0).toLongLong();
+        int courseId = query.value(1).toInt();
+        if (studentId != currentStudent || courseId != currentCourse) {
+            currentStudent = studentId;
+            currentCourse = courseId;
+            stream = EwmaStats();
+            report.streams++;
+        }
+        double score = DBManager::scoreAt(query, 3);
+        if (stream.count >= options.minHistory) {
+            double z = stream.zScore(score, options.minSd);
+            if (std::abs(z) >= options.zThreshold && std::abs(score - stream.mean) >= options.minDelta) {
+                AnomalyFinding finding;
+                finding.kind = z < 0 ? AnomalyFinding::ScoreDrop : AnomalyFinding::ScoreSpike;
+                finding.studentId = studentId;
+                finding.courseId = courseId;
+                finding.examDate = DBManager::dateAt(query, 2);
+                finding.value = score;
+                finding.expected = stream.mean;
+                finding.zScore = z;
+                sink.add(finding);
+            }
+        }
+        stream.add(score, options.alpha);
+
+        if ((++report.scannedRows & 0xFFF) == 0 && progress && !progress(report.scannedRows)) {
+            report.error = "已取消";
+            return report;
+        }
+    }
+    if (query.lastError().isValid()) {
+        report.error = "读取成绩失败：" + query.lastError().text();
+        return report;
+    }
+    query.finish();
+
+    // 2. 批次：score_summary 按 班级→科目→日期 有序（主键顺序），每个 班级×科目 的历次平均分构成一个序列
+    QSqlQuery batchQuery(connection);
+    batchQuery.setForwardOnly(true);
+    batchQuery.prepare("SELECT class_name, course_id, exam_date, cnt, total, min_score, max_score, b0 FROM score_summary "
+                       "WHERE cnt > 0" + filterSql(options, "class_name = ?", "course_id", "exam_date")
+                       + " ORDER BY class_name, course_id, exam_date");
+    if (!options.className.isEmpty()) batchQuery.addBindValue(options.className);
+    if (!batchQuery.exec()) {
+        report.error = "查询成绩汇总失败：" + batchQuery.lastError().text();
+        return report;
+    }
+    EwmaStats classStream;
+    QString currentClass;
+    currentCourse = -1;
+    while (batchQuery.next()) {
+        QString className = batchQuery.value(0).toString();
+        int courseId = batchQuery.value(1).toInt();
+        if (className != currentClass || courseId != currentCourse) {
+            currentClass = className;
+            currentCourse = courseId;
+            classStream = EwmaStats();
+        }
+        report.batches++;
+
+        AnomalyFinding finding;
+        finding.className = className;
+        finding.courseId = courseId;
+        finding.examDate = DBManager::dateAt(batchQuery, 2);
+        finding.count = batchQuery.value(3).toInt();
+        finding.value = batchQuery.value(4).toDouble() / finding.count;
+        double minScore = batchQuery.value(5).toDouble();
+        double maxScore = batchQuery.value(6).toDouble();
+        double lowRatio = batchQuery.value(7).toDouble() / finding.count;
+        if (finding.count >= options.minBatch) {
+            // 整批异常只报最具体的一种
+            if (maxScore == 0) {
+                finding.kind = AnomalyFinding::BatchAllZero;
+                sink.add(finding);
+            } else if (minScore == maxScore) {
+                finding.kind = AnomalyFinding::BatchUniform;
+                sink.add(finding);
+            } else if (lowRatio >= options.lowScoreRatio) {
+                finding.kind = AnomalyFinding::BatchLowScores;
+                finding.zScore = lowRatio;
+                sink.add(finding);
+            } else if (classStream.count >= options.minHistory) {
+                double z = classStream.zScore(finding.value, options.minSd);
+                if (std::abs(z) >= options.zThreshold && std::abs(finding.value - classStream.mean) >= options.minDelta) {
+                    finding.kind = AnomalyFinding::BatchShift;
+                    finding.expected = classStream.mean;
+                    finding.zScore = z;
+                    sink.add(finding);
+                }
+            }
+        }
+        classStream.add(finding.value, options.alpha);
+    }
+    if (batchQuery.lastError().isValid()) {
+        report.error = "读取成绩汇总失败：" + batchQuery.lastError().text();
+        return report;
+    }
+
+    // 3. 只为报告中的学生/科目补齐名称
+    QSet<qint64> studentIds;
+    for (const AnomalyFinding& finding : std::as_const(report.findings)) {
+        if (!finding.isBatch()) studentIds.insert(finding.studentId);
+    }
+    QHash<qint64, QPair<QString, QString>> students;
+    if (!studentIds.isEmpty()) {
+        using Schema::Students;
+        using StudentNames = Schema::Select<Students, Students::StudentId, Students::StudentName, Students::ClassName>;
+        QSqlQuery studentQuery(connection);
+        studentQuery.setForwardOnly(true);
+        if (studentQuery.exec(StudentNames::sql())) {
+            while (studentQuery.next()) {
+                qint64 id = studentQuery.value(StudentNames::at<Students::StudentId>()).toLongLong();
+                if (!studentIds.contains(id)) continue;
+                students.insert(id, {studentQuery.value(StudentNames::at<Students::StudentName>()).toString(),
+                                     studentQuery.value(StudentNames::at<Students::ClassName>()).toString()});
+            }
+        }
+    }
+    QHash<int, QString> courses;
+    QSqlQuery courseQuery(connection);
+    if (courseQuery.exec("SELECT course_id, course_name FROM courses")) {
+        while (courseQuery.next()) courses.insert(courseQuery.value(0).toInt(), courseQuery.value(1).toString());
+    }
+    for (AnomalyFinding& finding : report.findings) {
+        finding.courseName = courses.value(finding.courseId, QString("科目%1").arg(finding.courseId));
+        if (!finding.isBatch()) {
+            QPair<QString, QString> student = students.value(finding.studentId);
+            finding.studentName = student.first;
+            finding.className = student.second;
+        }
+    }
+
+    std::stable_sort(report.findings.begin(), report.findings.end(), [](const AnomalyFinding& a, const AnomalyFinding& b) {
+        if (a.examDate != b.examDate) return a.examDate > b.examDate;
+        return a.isBatch() && !b.isBatch();
+    });
+    report.elapsedMs = timer.elapsed();
+    return report;
+}
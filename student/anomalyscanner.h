@@ -0,0 +1,72 @@
+#ifndef ANOMALYSCANNER_H
+#define ANOMALYSCANNER_H
+
+#include <QString>
+#include <QList>
+#include <QDate>
+#include <functional>
+
+// 异常检测参数
+struct AnomalyOptions {
+    QString className;            // 空为全部班级
+    QList<int> courseIds;         // 空为全部科目（录入后只检查涉及的科目）
+    QDate from;                   // 扫描的日期范围，空为不限
+    QDate to;
+    QDate reportFrom;             // 只报告该日期及以后的异常，之前的成绩只用于建立基线；空为全部报告
+
+    double alpha = 0.3;           // EWMA 平滑系数，越大越看重最近几次
+    double zThreshold = 3.0;      // 偏离基线的标准分阈值
+    double minDelta = 15;         // 同时偏离基线至少这么多分才报告（成绩很稳定时标准差很小，小幅波动也会超阈值）
+    double minSd = 5;             // 标准差下限
+    int minHistory = 3;           // 同一序列至少有几次成绩后才开始判断
+    int minBatch = 5;             // 判断批次异常的最少人数
+    double lowScoreRatio = 0.5;   // 一次考试中低于10分的比例超过该值视为可疑批次
+    int maxFindings = 10000;      // 超过后只计数不保存
+};
+
+// 一处异常：学生成绩序列（学生×科目）的突变，或一次考试（班级×科目×日期）的可疑批次
+struct AnomalyFinding {
+    enum Kind { ScoreDrop, ScoreSpike, BatchAllZero, BatchUniform, BatchLowScores, BatchShift };
+
+    Kind kind = ScoreDrop;
+    qint64 studentId = 0;         // 批次异常为 0
+    QString studentName;
+    QString className;
+    int courseId = -1;
+    QString courseName;
+    QDate examDate;
+    double value = 0;             // 成绩或批次平均分
+    double expected = 0;          // 基线（EWMA）
+    double zScore = 0;
+    int count = 1;                // 批次人数
+
+    bool isBatch() const { return kind >= BatchAllZero; }
+    QString kindText() const;
+    QString description() const;
+};
+
+struct AnomalyReport {
+    QList<AnomalyFinding> findings;   // 按考试日期倒序，同日批次异常在前
+    qint64 scannedRows = 0;
+    qint64 streams = 0;               // 学生×科目 序列数
+    qint64 batches = 0;               // 班级×科目×日期 批次数
+    qint64 truncated = 0;             // 超过 maxFindings 未保存的异常数
+    qint64 elapsedMs = 0;
+    QString error;
+
+    bool writeCsv(const QString& filePath, QString *errorMessage = nullptr) const;
+};
+
+// 成绩异常检测：按 学号→科目→日期 一次只进扫描成绩表，每个序列只保留 EWMA 均值/方差，
+// 新成绩相对基线的标准分超过阈值即报告（突降/突升）；批次异常从 score_summary 的分组计数与
+// 分布桶一次扫描得出（全部0分、全部同分、大量低于10分、班级均分相对自身历史骤变）。
+// 内存与序列数无关，耗时随成绩条数线性增长；不依赖界面，可在工作线程或命令行运行。
+class AnomalyScanner
+{
+public:
+    // progress(已扫描行数) 返回 false 时中止
+    static AnomalyReport scan(const AnomalyOptions& options,
+                              const std::function<bool(qint64)>& progress = nullptr);
+};
+
+#endif // ANOMALYSCANNER_H
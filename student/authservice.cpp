@@ -0,0 +1,122 @@
+#include "authservice.h"
+#include "dbmanager.h"
+#include "schema.h"
+#include <QFutureWatcher>
+#include <QtConcurrent>
+#include <QPasswordDigestor>
+#include <QRandomGenerator>
+
+static const char kHashScheme[] = "pbkdf2_sha256";
+static const int kSaltBytes = 16;
+static const int kKeyBytes = 32;
+
+// 工作线程的校验结果
+struct VerifyResult {
+    bool ok = false;
+    QString upgradedHash; // 非空时需要写回 users 表
+};
+
+// 定长比较，避免按字节提前返回泄露时序信息
+static bool constantTimeEquals(const QByteArray& a, const QByteArray& b)
+{
+    if (a.size() != b.size()) return false;
+    char diff = 0;
+    for (int i = 0; i < a.size(); i++) {
+        diff |= a[i] ^ b[i];
+    }
+    return diff == 0;
+}
+
+QString AuthService::hashPassword(const QString& password, int iterations)
+{
+    QByteArray salt(kSaltBytes, Qt::Uninitialized);
+    QRandomGenerator::system()->fillRange(reinterpret_cast<quint32*>(salt.data()), kSaltBytes / 4);
+    QByteArray key = QPasswordDigestor::deriveKeyPbkdf2(QCryptographicHash::Sha256, password.toUtf8(),
+                                                        salt, iterations, kKeyBytes);
+    return QString("%1$%2$%3$%4").arg(QLatin1String(kHashScheme)).arg(iterations)
+        .arg(QString::fromLatin1(salt.toBase64()), QString::fromLatin1(key.toBase64()));
+}
+
+bool AuthService::verifyPassword(const QString& password, const QString& stored,
+                                 int minIterations, bool *needsUpgrade)
+{
+    *needsUpgrade = false;
+    QStringList parts = stored.split('$');
+    if (parts.size() != 4 || parts[0] != QLatin1String(kHashScheme)) {
+        // 旧数据：明文存储，校验通过后升级为哈希
+        bool ok = constantTimeEquals(password.toUtf8(), stored.toUtf8());
+        *needsUpgrade = ok;
+        return ok;
+    }
+
+    bool ok = false;
+    int iterations = parts[1].toInt(&ok);
+    if (!ok || iterations <= 0) return false;
+    QByteArray salt = QByteArray::fromBase64(parts[2].toLatin1());
+    QByteArray expected = QByteArray::fromBase64(parts[3].toLatin1());
+    QByteArray key = QPasswordDigestor::deriveKeyPbkdf2(QCryptographicHash::Sha256, password.toUtf8(),
+                                                        salt, iterations, expected.size());
+    if (!constantTimeEquals(key, expected)) return false;
+    *needsUpgrade = iterations < minIterations;
+    return true;
+}
+
+void AuthService::authenticate(const QString& username, const QString& password)
+{
+    if (m_busy) return; // 上一次认证尚未结束
+
+    // 一次参数化查询同时取回哈希和角色（users.username 有索引）
+    using Schema::Users;
+    using Credentials = Schema::Select<Users, Users::Password, Users::UserType>;
+    QSqlQuery query(DBManager::getInstance().m_db);
+    query.prepare(Credentials::sql(Schema::columnName<Users>(Users::Username) + " = ?"));
+    query.addBindValue(username);
+    if (!query.exec()) {
+        emit authenticationFailed("查询用户失败：" + query.lastError().text());
+        return;
+    }
+    if (!query.next()) {
+        emit authenticationFailed("账号不存在！");
+        return;
+    }
+    QString stored = query.value(Credentials::at<Users::Password>()).toString();
+    QString userType = query.value(Credentials::at<Users::UserType>()).toString();
+
+    // KDF计算在线程池中进行，数据库读写仍在主线程连接上完成
+    m_busy = true;
+    int iterations = m_iterations;
+    auto *watcher = new QFutureWatcher<VerifyResult>(this);
+    connect(watcher, &QFutureWatcher<VerifyResult>::finished, this, [this, watcher, username, userType]() {
+        VerifyResult result = watcher->result();
+        watcher->deleteLater();
+        m_busy = false;
+
+        if (!result.ok) {
+            emit authenticationFailed("密码错误！");
+            return;
+        }
+        if (!result.upgradedHash.isEmpty()) {
+            QSqlQuery update(DBManager::getInstance().m_db);
+            update.prepare("UPDATE users SET password = ? WHERE username = ?");
+            update.addBindValue(result.upgradedHash);
+            update.addBindValue(username);
+            if (!update.exec()) {
+                qWarning() << "密码哈希升级失败：" << update.lastError().text();
+            }
+        }
+
+        m_session.username = username;
+        m_session.userType = userType;
+        m_session.loginTime = QDateTime::currentDateTime();
+        emit authenticated(m_session);
+    });
+    watcher->setFuture(QtConcurrent::run([password, stored, iterations]() {
+        VerifyResult result;
+        bool needsUpgrade = false;
+        result.ok = verifyPassword(password, stored, iterations, &needsUpgrade);
+        if (result.ok && needsUpgrade) {
+            result.upgradedHash = hashPassword(password, iterations);
+        }
+        return result;
+    }));
+}
@@ -0,0 +1,63 @@
+#ifndef AUTHSERVICE_H
+#define AUTHSERVICE_H
+
+#include <QObject>
+#include <QString>
+#include <QDateTime>
+
+// 登录会话缓存：登录成功后的角色判断都读这里，不再查库
+struct AuthSession {
+    QString username;
+    QString userType;   // admin/normal
+    QDateTime loginTime;
+
+    bool isValid() const { return !username.isEmpty(); }
+    bool isAdmin() const { return userType == "admin"; }
+};
+
+// 认证服务：单次参数化查询取回密码哈希与角色，
+// PBKDF2-SHA256 校验放到工作线程，避免界面卡顿
+class AuthService : public QObject
+{
+    Q_OBJECT
+
+public:
+    static AuthService& getInstance() {
+        static AuthService instance;
+        return instance;
+    }
+
+    // 异步认证，结果通过 authenticated / authenticationFailed 信号返回
+    void authenticate(const QString& username, const QString& password);
+
+    // 当前会话（未登录时 isValid() 为 false）
+    const AuthSession& currentSession() const { return m_session; }
+    void logout() { m_session = AuthSession(); }
+
+    // KDF迭代次数，可按机器性能调整；低于当前值的旧哈希会在下次登录时升级
+    int iterations() const { return m_iterations; }
+    void setIterations(int iterations) { m_iterations = qMax(1000, iterations); }
+
+    // 生成存储格式：pbkdf2_sha256$迭代次数$盐(base64)$哈希(base64)
+    static QString hashPassword(const QString& password, int iterations);
+    // 校验密码；兼容旧的明文存储，needsUpgrade 表示需要重新哈希
+    static bool verifyPassword(const QString& password, const QString& stored,
+                               int minIterations, bool *needsUpgrade);
+
+signals:
+    void authenticated(const AuthSession& session);
+    void authenticationFailed(const QString& reason);
+
+private:
+    AuthService() : m_iterations(kDefaultIterations) {}
+    AuthService(const AuthService&) = delete;
+    AuthService& operator=(const AuthService&) = delete;
+
+    static const int kDefaultIterations = 120000;
+
+    AuthSession m_session;
+    int m_iterations;
+    bool m_busy = false;
+};
+
+#endif // AUTHSERVICE_H
@@ -0,0 +1,48 @@
+#include "backgroundtask.h"
+#include <QPointer>
+#include <QProgressDialog>
+#include <QThread>
+#include <QTimer>
+
+QThread *runInBackground(QObject *context, const std::shared_ptr<TaskProgress>& progress, const BackgroundJob& job,
+                         const std::function<void(qint64)>& onProgress, const std::function<void()>& onFinished)
+{
+    // 进度通过原子变量传回界面线程，定时刷新
+    QPointer<QTimer> timer;
+    if (onProgress) {
+        timer = new QTimer(context);
+        QObject::connect(timer, &QTimer::timeout, context, [progress, onProgress]() { onProgress(progress->done.load()); });
+        timer->start(200);
+    }
+
+    QThread *thread = QThread::create([progress, job]() { job(*progress); });
+    QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    QObject::connect(thread, &QThread::finished, context, [timer, onFinished]() {
+        if (timer) timer->deleteLater();
+        if (onFinished) onFinished();
+    });
+    thread->start();
+    return thread;
+}
+
+void runWithProgress(QWidget *parent, const QString& title, const QString& label, const BackgroundJob& job,
+                     const std::function<void()>& onFinished)
+{
+    auto progress = std::make_shared<TaskProgress>();
+    QPointer<QProgressDialog> dialog = new QProgressDialog(label.arg(0), "取消", 0, 0, parent);
+    dialog->setWindowTitle(title);
+    dialog->setWindowModality(Qt::WindowModal);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    QObject::connect(dialog, &QProgressDialog::canceled, parent, [progress]() { progress->canceled = true; });
+
+    // 回调挂在 parent 上：进度框被用户关掉时任务仍会收尾并通知调用方
+    runInBackground(parent, progress, job,
+                    [dialog, label](qint64 done) {
+                        if (dialog) dialog->setLabelText(label.arg(done));
+                    },
+                    [dialog, onFinished]() {
+                        if (dialog) dialog->close();
+                        onFinished();
+                    });
+    dialog->show();
+}
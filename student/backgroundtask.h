@@ -0,0 +1,38 @@
+#ifndef BACKGROUNDTASK_H
+#define BACKGROUNDTASK_H
+
+#include <QObject>
+#include <QString>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+class QThread;
+class QWidget;
+
+// 后台任务的进度与取消标志：工作线程写，界面线程定时读
+struct TaskProgress {
+    std::atomic<qint64> done{0};
+    std::atomic<bool> canceled{false};
+
+    // 供工作线程的进度回调使用：记录进度，返回 false 表示已取消
+    bool update(qint64 value)
+    {
+        done = value;
+        return !canceled.load();
+    }
+};
+
+using BackgroundJob = std::function<void(TaskProgress& progress)>;
+
+// 在独立线程运行 job（导出/成绩单等任务自身还要向线程池提交子任务，不占用池线程），
+// 运行期间每 200 ms 在界面线程以当前进度调用 onProgress（可为空），结束后调用 onFinished。
+// context 销毁后不再回调；线程结束后自行释放，需要等待时在其结束前调用 wait()
+QThread *runInBackground(QObject *context, const std::shared_ptr<TaskProgress>& progress, const BackgroundJob& job,
+                         const std::function<void(qint64)>& onProgress, const std::function<void()>& onFinished);
+
+// 带可取消的模态进度框运行 job：label 中的 %1 替换为当前进度，结束后关闭进度框再调用 onFinished
+void runWithProgress(QWidget *parent, const QString& title, const QString& label, const BackgroundJob& job,
+                     const std::function<void()>& onFinished);
+
+#endif // BACKGROUNDTASK_H
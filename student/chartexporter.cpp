@@ -0,0 +1,247 @@
+#include "chartexporter.h"
+#include "scorechartwidget.h"
+#include "dbmanager.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFuture>
+#include <QGraphicsScene>
+#include <QGraphicsLayout>
+#include <QImage>
+#include <QPdfWriter>
+#include <QPageSize>
+#include <QPicture>
+#include <QQueue>
+#include <QRegularExpression>
+#include <QSvgGenerator>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+namespace {
+
+// 复用的图表模板：只创建一次，每张图只替换数据、标题和坐标范围
+class ChartTemplate
+{
+public:
+    explicit ChartTemplate(const QSize& size) :
+        m_size(size),
+        m_chart(new QChart()),
+        m_series(new QLineSeries()),
+        m_scatterSeries(new QScatterSeries()),
+        m_xAxis(new QDateTimeAxis()),
+        m_yAxis(new QValueAxis())
+    {
+        m_series->setName("成绩折线");
+        m_series->setPen(QPen(Qt::red, 2));
+        m_scatterSeries->setName("成绩点");
+        m_scatterSeries->setColor(Qt::blue);
+        m_scatterSeries->setMarkerSize(6);
+
+        m_chart->addSeries(m_series);
+        m_chart->addSeries(m_scatterSeries);
+        ScoreChartWidget::applyChartStyle(m_chart, m_xAxis, m_yAxis);
+        m_chart->setAnimationOptions(QChart::NoAnimation);
+        m_chart->addAxis(m_xAxis, Qt::AlignBottom);
+        m_chart->addAxis(m_yAxis, Qt::AlignLeft);
+        m_series->attachAxis(m_xAxis);
+        m_series->attachAxis(m_yAxis);
+        m_scatterSeries->attachAxis(m_xAxis);
+        m_scatterSeries->attachAxis(m_yAxis);
+
+        // 场景接管图表，图表接管序列和坐标轴
+        m_scene.addItem(m_chart);
+        m_chart->setGeometry(QRectF(QPointF(0, 0), m_size));
+    }
+
+    void setData(const QString& title, const QList<QPointF>& points)
+    {
+        m_chart->setTitle(title);
+        m_series->replace(points);
+        m_scatterSeries->replace(points);
+        m_xAxis->setRange(QDateTime::fromMSecsSinceEpoch(qint64(points.first().x())).addDays(-1),
+                          QDateTime::fromMSecsSinceEpoch(qint64(points.last().x())).addDays(1));
+        // 布局请求是延迟处理的，绘制前立即生效
+        m_chart->layout()->activate();
+        QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+    }
+
+    QImage renderImage()
+    {
+        QImage image(m_size, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::white);
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::Antialiasing);
+        m_scene.render(&painter, QRectF(QPointF(0, 0), m_size), m_chart->geometry());
+        return image;
+    }
+
+    // 录制绘图指令，供工作线程回放到 SVG/PDF
+    QPicture renderPicture()
+    {
+        QPicture picture;
+        QPainter painter(&picture);
+        painter.setRenderHint(QPainter::Antialiasing);
+        m_scene.render(&painter, QRectF(QPointF(0, 0), m_size), m_chart->geometry());
+        painter.end();
+        return picture;
+    }
+
+private:
+    QSize m_size;
+    QGraphicsScene m_scene;
+    QChart *m_chart;
+    QLineSeries *m_series;
+    QScatterSeries *m_scatterSeries;
+    QDateTimeAxis *m_xAxis;
+    QValueAxis *m_yAxis;
+};
+
+// 文件名中去掉路径非法字符
+QString safeFileName(const QString& name)
+{
+    QString result = name;
+    result.replace(QRegularExpression(R"([\\/:*?"<>|\s])"), "_");
+    return result;
+}
+
+bool writePng(const QImage& image, const QString& path)
+{
+    return image.save(path, "PNG");
+}
+
+bool writeSvg(const QPicture& picture, const QSize& size, const QString& title, const QString& path)
+{
+    QSvgGenerator generator;
+    generator.setFileName(path);
+    generator.setSize(size);
+    generator.setViewBox(QRect(QPoint(0, 0), size));
+    generator.setTitle(title);
+    QPainter painter;
+    if (!painter.begin(&generator)) return false;
+    painter.drawPicture(0, 0, picture);
+    return painter.end();
+}
+
+bool writePdf(const QPicture& picture, const QSize& size, const QString& title, const QString& path)
+{
+    QPdfWriter writer(path);
+    writer.setTitle(title);
+    writer.setResolution(72); // 1点 = 1像素，页面与图表同尺寸
+    writer.setPageSize(QPageSize(QSizeF(size), QPageSize::Point));
+    writer.setPageMargins(QMarginsF(0, 0, 0, 0));
+    QPainter painter;
+    if (!painter.begin(&writer)) return false;
+    painter.drawPicture(0, 0, picture);
+    return painter.end();
+}
+
+} // namespace
+
+bool ChartExporter::parseFormat(const QString& name, ChartExportOptions::Format *format)
+{
+    QString lower = name.trimmed().toLower();
+    if (lower == "png") *format = ChartExportOptions::Png;
+    else if (lower == "svg") *format = ChartExportOptions::Svg;
+    else if (lower == "pdf") *format = ChartExportOptions::Pdf;
+    else return false;
+    return true;
+}
+
+int ChartExporter::exportCharts(const ChartExportOptions& options, QString *errorMessage,
+                                const std::function<bool(int, int)>& progress)
+{
+    auto fail = [errorMessage](const QString& message) {
+        if (errorMessage) *errorMessage = message;
+        return -1;
+    };
+
+    if (!QDir().mkpath(options.outputDir)) {
+        return fail(QString("无法创建输出目录：%1").arg(options.outputDir));
+    }
+
+    // 一次有序扫描：按分组键（学生或科目）+ 日期排序，逐组生成图表，内存中只保留当前一组
+    bool perStudent = options.mode == ChartExportOptions::PerStudent;
+    QString sql = QString(
+                      "SELECT %1, st.student_name, c.course_name, sc.exam_date, sc.score "
+                      "FROM %2 sc "
+                      "JOIN students st ON st.student_id = sc.student_id "
+                      "JOIN courses c ON c.course_id = sc.course_id "
+                      "WHERE %3 = ? AND sc.score >= 0 AND sc.score <= 100%4%5 "
+                      "ORDER BY 1, sc.exam_date")
+                      .arg(QString(perStudent ? "sc.student_id" : "sc.course_id"),
+                           DBManager::getInstance().scoreSource(options.from, options.to),
+                           QString(perStudent ? "sc.course_id" : "sc.student_id"),
+                           QString(perStudent && !options.className.isEmpty() ? " AND st.class_name = ?" : ""),
+                           DBManager::dateRangeSql("sc.exam_date", options.from, options.to));
+
+    QSqlQuery query(DBManager::getInstance().threadConnection());
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    if (perStudent) {
+        query.addBindValue(options.courseId);
+        if (!options.className.isEmpty()) query.addBindValue(options.className);
+    } else {
+        query.addBindValue(options.studentId);
+    }
+    if (!query.exec()) {
+        return fail("查询成绩失败：" + query.lastError().text());
+    }
+
+    // 限制在途的编码任务数，防止图片堆积占用内存
+    const int maxInFlight = qMax(2, QThreadPool::globalInstance()->maxThreadCount() * 2);
+    QQueue<QFuture<bool>> inFlight;
+    int submitted = 0;
+    int written = 0;
+    bool canceled = false;
+    auto reap = [&](int keep) {
+        while (inFlight.size() > keep) {
+            if (inFlight.dequeue().result()) written++;
+        }
+    };
+
+    ChartTemplate chartTemplate(options.size);
+    auto flush = [&](const QString& key, const QString& title, const QList<QPointF>& points) {
+        if (points.isEmpty() || canceled) return;
+        chartTemplate.setData(title, points);
+        QString path = QDir(options.outputDir).filePath(
+            QString("%1_%2.%3").arg(safeFileName(key), safeFileName(title),
+                                    options.format == ChartExportOptions::Png ? "png"
+                                    : options.format == ChartExportOptions::Svg ? "svg" : "pdf"));
+        QSize size = options.size;
+        if (options.format == ChartExportOptions::Png) {
+            QImage image = chartTemplate.renderImage();
+            inFlight.enqueue(QtConcurrent::run(writePng, image, path));
+        } else {
+            QPicture picture = chartTemplate.renderPicture();
+            auto writer = options.format == ChartExportOptions::Svg ? writeSvg : writePdf;
+            inFlight.enqueue(QtConcurrent::run(writer, picture, size, title, path));
+        }
+        submitted++;
+        reap(maxInFlight);
+        if (progress && !progress(written, submitted)) canceled = true;
+    };
+
+    QString currentKey;
+    QString currentTitle;
+    QList<QPointF> points;
+    while (query.next() && !canceled) {
+        QString key = query.value(0).toString();
+        if (key != currentKey) {
+            flush(currentKey, currentTitle, points);
+            currentKey = key;
+            currentTitle = QString("%1 - %2 成绩趋势图").arg(query.value(1).toString(), query.value(2).toString());
+            points.clear();
+        }
+        qreal x = QDateTime(DBManager::dateAt(query, 3), QTime(0, 0)).toMSecsSinceEpoch();
+        points.append(QPointF(x, DBManager::scoreAt(query, 4)));
+    }
+    flush(currentKey, currentTitle, points);
+    reap(0);
+
+    if (canceled) {
+        return fail(QString("导出已取消，已完成 %1 个文件").arg(written));
+    }
+    if (written < submitted) {
+        return fail(QString("部分文件写入失败：成功 %1 / %2").arg(written).arg(submitted));
+    }
+    return written;
+}
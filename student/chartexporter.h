@@ -0,0 +1,41 @@
+#ifndef CHARTEXPORTER_H
+#define CHARTEXPORTER_H
+
+#include <QString>
+#include <QSize>
+#include <QDate>
+#include <functional>
+
+// 批量导出参数
+struct ChartExportOptions {
+    enum Mode {
+        PerStudent,   // 固定科目，每个学生一张图（可按班级限定）
+        PerCourse     // 固定学生，每个科目一张图
+    };
+    enum Format { Png, Svg, Pdf };
+
+    Mode mode = PerStudent;
+    Format format = Png;
+    int courseId = -1;        // PerStudent 使用
+    QString className;        // PerStudent 可选，空为全部班级
+    QString studentId;        // PerCourse 使用
+    QDate from;               // 日期范围，空为不限
+    QDate to;
+    QString outputDir;
+    QSize size = QSize(1000, 600);
+};
+
+// 趋势图离线批量导出：一次有序扫描取数，复用同一图表模板在主线程绘制，
+// 图片编码/SVG/PDF 写文件交给线程池并行完成。可在 offscreen 平台下无界面运行。
+class ChartExporter
+{
+public:
+    // progress(已完成, 已提交) 返回 false 时中止；返回成功导出的文件数，失败返回 -1
+    static int exportCharts(const ChartExportOptions& options, QString *errorMessage = nullptr,
+                            const std::function<bool(int, int)>& progress = nullptr);
+
+    // 解析格式名（png/svg/pdf），无法识别时返回 false
+    static bool parseFormat(const QString& name, ChartExportOptions::Format *format);
+};
+
+#endif // CHARTEXPORTER_H
@@ -0,0 +1,156 @@
+#include "collationsortproxy.h"
+
+CollationSortProxy::CollationSortProxy(QObject *parent)
+    : QSortFilterProxyModel(parent)
+    , m_collator(QLocale(QLocale::Chinese, QLocale::China))
+{
+    // 学号等数字串按数值排列
+    m_collator.setNumericMode(true);
+}
+
+void CollationSortProxy::setCollatedColumns(const QList<int>& columns)
+{
+    m_collatedColumns = QSet<int>(columns.begin(), columns.end());
+    invalidateRows();
+}
+
+void CollationSortProxy::setCollationLocale(const QLocale& locale)
+{
+    m_collator.setLocale(locale);
+    // 排序键与区域相关，全部作废
+    m_slotOf.clear();
+    m_keys.clear();
+    invalidateRows();
+    invalidate();
+}
+
+void CollationSortProxy::setSourceModel(QAbstractItemModel *model)
+{
+    if (sourceModel()) disconnect(sourceModel(), nullptr, this, nullptr);
+    invalidateRows();
+
+    // 先于基类连接：源模型变化时先更新行排序键，基类随后重排时已是新数据
+    if (model) {
+        connect(model, &QAbstractItemModel::rowsInserted, this, &CollationSortProxy::onRowsInserted);
+        connect(model, &QAbstractItemModel::rowsRemoved, this, &CollationSortProxy::onRowsRemoved);
+        connect(model, &QAbstractItemModel::dataChanged, this, &CollationSortProxy::onDataChanged);
+        connect(model, &QAbstractItemModel::modelReset, this, &CollationSortProxy::invalidateRows);
+        connect(model, &QAbstractItemModel::layoutChanged, this, &CollationSortProxy::invalidateRows);
+        connect(model, &QAbstractItemModel::rowsMoved, this, &CollationSortProxy::invalidateRows);
+    }
+    QSortFilterProxyModel::setSourceModel(model);
+}
+
+void CollationSortProxy::sort(int column, Qt::SortOrder order)
+{
+    // 排序前一次性算好整列的排序键序号，比较时只查下标
+    if (m_collatedColumns.contains(column) && m_rowColumn != column) rebuildRows(column);
+    QSortFilterProxyModel::sort(column, order);
+}
+
+qsizetype CollationSortProxy::cacheMemoryUsage() const
+{
+    // QCollatorSortKey 不公开长度，按每个字符约 4 字节的排序键估算；哈希节点按名称 + 指针开销估算
+    qsizetype bytes = qsizetype(m_rowSlots.capacity()) * qsizetype(sizeof(int));
+    bytes += qsizetype(m_keys.capacity()) * qsizetype(sizeof(QCollatorSortKey));
+    for (auto it = m_slotOf.cbegin(); it != m_slotOf.cend(); ++it) {
+        bytes += qsizetype(sizeof(QString) + sizeof(int) + 2 * sizeof(void *)) + it.key().size() * (2 + 4);
+    }
+    return bytes;
+}
+
+void CollationSortProxy::clearKeyCache()
+{
+    m_slotOf.clear();
+    m_keys.clear();
+    m_keys.shrink_to_fit();
+    invalidateRows();
+    m_rowSlots.shrink_to_fit();
+}
+
+bool CollationSortProxy::lessThan(const QModelIndex& sourceLeft, const QModelIndex& sourceRight) const
+{
+    int column = sourceLeft.column();
+    if (!m_collatedColumns.contains(column)) {
+        return QSortFilterProxyModel::lessThan(sourceLeft, sourceRight);
+    }
+    if (m_rowColumn != column) rebuildRows(column);
+
+    size_t left = size_t(sourceLeft.row());
+    size_t right = size_t(sourceRight.row());
+    if (left >= m_rowSlots.size() || right >= m_rowSlots.size()) {
+        return QSortFilterProxyModel::lessThan(sourceLeft, sourceRight);
+    }
+    int leftSlot = m_rowSlots[left];
+    int rightSlot = m_rowSlots[right];
+    if (leftSlot == rightSlot) return false;
+    // 空值排在最前（与默认比较一致）
+    if (leftSlot < 0 || rightSlot < 0) return leftSlot < 0;
+    return m_keys[leftSlot].compare(m_keys[rightSlot]) < 0;
+}
+
+// ========== 行排序键 ==========
+int CollationSortProxy::slotFor(int sourceRow) const
+{
+    QVariant value = sourceModel()->data(sourceModel()->index(sourceRow, m_rowColumn), sortRole());
+    if (value.isNull()) return -1;
+    QString text = value.toString();
+    auto found = m_slotOf.constFind(text);
+    if (found != m_slotOf.constEnd()) return found.value();
+
+    int slot = int(m_keys.size());
+    m_keys.push_back(m_collator.sortKey(text));
+    m_slotOf.insert(text, slot);
+    return slot;
+}
+
+void CollationSortProxy::rebuildRows(int column) const
+{
+    m_rowColumn = column;
+    m_rowSlots.clear();
+    if (!sourceModel()) return;
+    int rows = sourceModel()->rowCount();
+    m_rowSlots.reserve(rows);
+    for (int row = 0; row < rows; row++) m_rowSlots.push_back(slotFor(row));
+}
+
+void CollationSortProxy::invalidateRows()
+{
+    m_rowColumn = -1;
+    m_rowSlots.clear();
+}
+
+void CollationSortProxy::onRowsInserted(const QModelIndex& parent, int first, int last)
+{
+    if (parent.isValid() || m_rowColumn < 0) return;
+    if (size_t(first) > m_rowSlots.size()) {
+        invalidateRows();
+        return;
+    }
+    // 分批加载（fetchMore）时只为新增的行计算
+    std::vector<int> inserted;
+    inserted.reserve(last - first + 1);
+    for (int row = first; row <= last; row++) inserted.push_back(slotFor(row));
+    m_rowSlots.insert(m_rowSlots.begin() + first, inserted.begin(), inserted.end());
+}
+
+void CollationSortProxy::onRowsRemoved(const QModelIndex& parent, int first, int last)
+{
+    if (parent.isValid() || m_rowColumn < 0) return;
+    if (size_t(last) >= m_rowSlots.size()) {
+        invalidateRows();
+        return;
+    }
+    m_rowSlots.erase(m_rowSlots.begin() + first, m_rowSlots.begin() + last + 1);
+}
+
+void CollationSortProxy::onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight)
+{
+    if (m_rowColumn < 0 || topLeft.parent().isValid()) return;
+    if (m_rowColumn < topLeft.column() || m_rowColumn > bottomRight.column()) return;
+    if (size_t(bottomRight.row()) >= m_rowSlots.size()) {
+        invalidateRows();
+        return;
+    }
+    for (int row = topLeft.row(); row <= bottomRight.row(); row++) m_rowSlots[row] = slotFor(row);
+}
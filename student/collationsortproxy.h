@@ -0,0 +1,60 @@
+#ifndef COLLATIONSORTPROXY_H
+#define COLLATIONSORTPROXY_H
+
+#include <QSortFilterProxyModel>
+#include <QCollator>
+#include <QHash>
+#include <QSet>
+#include <vector>
+
+// 按语言排序规则（中文为拼音序）排序文本列的代理模型。
+// 每个不同的名称只计算一次 QCollatorSortKey 并缓存，每行只记录名称在缓存中的序号，
+// 排序比较时直接比较排序键，不再逐次取 QString 做区域比较。
+// 源模型增删行/修改数据时增量更新对应行，重置时整列重建。
+class CollationSortProxy : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit CollationSortProxy(QObject *parent = nullptr);
+
+    // 按排序规则比较的列（源模型列号），其它列沿用默认比较
+    void setCollatedColumns(const QList<int>& columns);
+    bool isCollatedColumn(int column) const { return m_collatedColumns.contains(column); }
+    // 排序规则的区域，缺省为中文（中国）
+    void setCollationLocale(const QLocale& locale);
+    const QCollator& collator() const { return m_collator; }
+
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    // 排序键缓存与行序号占用的内存（估算，字节），供内存记账
+    qsizetype cacheMemoryUsage() const;
+    int cachedKeyCount() const { return int(m_keys.size()); }
+    // 丢弃排序键缓存，下次排序时重建
+    void clearKeyCache();
+
+protected:
+    bool lessThan(const QModelIndex& sourceLeft, const QModelIndex& sourceRight) const override;
+
+private:
+    // 源模型一行的排序键序号（取不到数据时为 -1）
+    int slotFor(int sourceRow) const;
+    void rebuildRows(int column) const;
+    void invalidateRows();
+    void onRowsInserted(const QModelIndex& parent, int first, int last);
+    void onRowsRemoved(const QModelIndex& parent, int first, int last);
+    void onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight);
+
+    QCollator m_collator;
+    QSet<int> m_collatedColumns;
+
+    // 名称 -> 排序键（跨多次排序复用）
+    mutable QHash<QString, int> m_slotOf;
+    mutable std::vector<QCollatorSortKey> m_keys;
+    // 当前排序列每行对应的排序键序号
+    mutable std::vector<int> m_rowSlots;
+    mutable int m_rowColumn = -1;
+};
+
+#endif // COLLATIONSORTPROXY_H
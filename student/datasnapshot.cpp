@@ -0,0 +1,344 @@
+#include "datasnapshot.h"
+#include "dbmanager.h"
+#include "schema.h"
+#include "memoryaccounting.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtConcurrent>
+#include <QSet>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+// ========== 文件格式 ==========
+// [Header][班级名 StringRef[]][课程名 StringRef[]][CourseEntry[] 按ID升序][AggregateEntry[]][UTF-16 字符串池]
+// 各区按8字节对齐，映射后直接按结构体读取；字节序与结构体布局随本机，文件不跨平台共用
+static const quint32 kSnapshotMagic = 0x504E5353; // "SSNP"
+static const quint32 kSnapshotFormat = 1;
+
+struct DataSnapshot::StringRef {
+    quint32 offset; // 字符串池中的字符偏移
+    quint32 length;
+};
+
+struct DataSnapshot::Header {
+    quint32 magic;
+    quint32 format;
+    qint64 dataVersion;
+    qint64 builtAtMs;
+    quint32 classCount;
+    quint32 courseNameCount;
+    quint32 courseCount;
+    quint32 aggregateCount;
+    quint64 classOffset;
+    quint64 courseNameOffset;
+    quint64 courseOffset;
+    quint64 aggregateOffset;
+    quint64 poolOffset;
+    quint64 poolChars;
+};
+
+struct DataSnapshot::CourseEntry {
+    qint32 courseId;
+    StringRef name;
+};
+
+// 班级×科目 全日期汇总（由 score_summary 按日期合并）
+struct DataSnapshot::AggregateEntry {
+    StringRef className;
+    qint32 courseId;
+    quint32 reserved;
+    qint64 count;
+    double total;
+    double totalSq;
+    double minScore;
+    double maxScore;
+};
+
+static quint64 alignTo8(quint64 value) { return (value + 7) & ~quint64(7); }
+
+DataSnapshot::DataSnapshot()
+{
+    // 文件映射页由系统按需换入换出，计入常驻集但可随时回收
+    MemoryAccounting::getInstance().registerProbe("snapshot", "启动快照映射", this, [this]() {
+        return MemorySample{m_header ? qint64(m_header->aggregateCount) : 0, m_size};
+    });
+}
+
+DataSnapshot::~DataSnapshot()
+{
+    unmap();
+}
+
+QString DataSnapshot::filePath()
+{
+    const DatabaseConfig& config = DBManager::getInstance().config();
+    if (config.isSQLite()) {
+        return QFileInfo(config.database).absoluteFilePath() + ".snapshot";
+    }
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    QDir().mkpath(dir);
+    return dir + QString("/%1-%2-%3.snapshot").arg(config.driver, config.host, config.database).toLower();
+}
+
+// ========== 生成 ==========
+QByteArray DataSnapshot::build(QString *errorMessage)
+{
+    DBManager& manager = DBManager::getInstance();
+    QSqlDatabase db = manager.threadConnection();
+    // 版本号与数据在同一读事务中取得（WAL模式下为一致的读快照），
+    // 生成期间有写入时快照版本偏旧，下次启动会再重建，不会误用过期数据
+    bool inTransaction = db.transaction();
+    auto fail = [&](const QString& reason) {
+        if (inTransaction) db.rollback();
+        if (errorMessage) *errorMessage = reason;
+        return QByteArray();
+    };
+
+    qint64 version = manager.dataVersion();
+    if (version < 0) return fail("数据库缺少数据版本号（db_meta），无法生成启动快照");
+
+    QString pool;
+    auto store = [&pool](const QString& text) {
+        StringRef ref{quint32(pool.size()), quint32(text.size())};
+        pool += text;
+        return ref;
+    };
+
+    // 字典：口径与统计页下拉框一致（去空白、跳过空名）
+    auto readNames = [&](const QString& sql, QVector<StringRef> *refs) {
+        QSqlQuery query(db);
+        query.setForwardOnly(true);
+        if (!query.exec(sql)) return false;
+        while (query.next()) {
+            QString name = query.value(0).toString().trimmed();
+            if (!name.isEmpty()) refs->append(store(name));
+        }
+        return true;
+    };
+    QVector<StringRef> classes;
+    QVector<StringRef> courseNames;
+    if (!readNames("SELECT DISTINCT class_name FROM students WHERE class_name IS NOT NULL ORDER BY class_name", &classes)
+        || !readNames("SELECT DISTINCT course_name FROM courses WHERE course_name IS NOT NULL ORDER BY course_name", &courseNames)) {
+        return fail("读取班级/课程字典失败：" + db.lastError().text());
+    }
+
+    using Schema::Courses;
+    using CourseMap = Schema::Select<Courses, Courses::CourseId, Courses::CourseName>;
+    QVector<CourseEntry> courses;
+    QSqlQuery courseQuery(db);
+    courseQuery.setForwardOnly(true);
+    if (!courseQuery.exec(CourseMap::sql() + " ORDER BY " + Schema::columnName<Courses>(Courses::CourseId))) {
+        return fail("读取课程失败：" + courseQuery.lastError().text());
+    }
+    while (courseQuery.next()) {
+        courses.append({courseQuery.value(CourseMap::at<Courses::CourseId>()).toInt(),
+                        store(courseQuery.value(CourseMap::at<Courses::CourseName>()).toString())});
+    }
+
+    QVector<AggregateEntry> aggregates;
+    QSqlQuery aggregateQuery(db);
+    aggregateQuery.setForwardOnly(true);
+    if (!aggregateQuery.exec("SELECT class_name, course_id, SUM(cnt), SUM(total), SUM(total_sq), MIN(min_score), MAX(max_score) "
+                             "FROM score_summary GROUP BY class_name, course_id HAVING SUM(cnt) > 0")) {
+        return fail("读取成绩汇总失败：" + aggregateQuery.lastError().text());
+    }
+    while (aggregateQuery.next()) {
+        AggregateEntry entry{};
+        entry.className = store(aggregateQuery.value(0).toString());
+        entry.courseId = aggregateQuery.value(1).toInt();
+        entry.count = aggregateQuery.value(2).toLongLong();
+        entry.total = aggregateQuery.value(3).toDouble();
+        entry.totalSq = aggregateQuery.value(4).toDouble();
+        entry.minScore = aggregateQuery.value(5).toDouble();
+        entry.maxScore = aggregateQuery.value(6).toDouble();
+        aggregates.append(entry);
+    }
+    if (inTransaction) db.commit();
+
+    // 布局
+    Header header{};
+    header.magic = kSnapshotMagic;
+    header.format = kSnapshotFormat;
+    header.dataVersion = version;
+    header.builtAtMs = QDateTime::currentMSecsSinceEpoch();
+    header.classCount = quint32(classes.size());
+    header.courseNameCount = quint32(courseNames.size());
+    header.courseCount = quint32(courses.size());
+    header.aggregateCount = quint32(aggregates.size());
+    header.classOffset = alignTo8(sizeof(Header));
+    header.courseNameOffset = alignTo8(header.classOffset + classes.size() * sizeof(StringRef));
+    header.courseOffset = alignTo8(header.courseNameOffset + courseNames.size() * sizeof(StringRef));
+    header.aggregateOffset = alignTo8(header.courseOffset + courses.size() * sizeof(CourseEntry));
+    header.poolOffset = alignTo8(header.aggregateOffset + aggregates.size() * sizeof(AggregateEntry));
+    header.poolChars = quint64(pool.size());
+
+    QByteArray bytes(qsizetype(header.poolOffset + header.poolChars * sizeof(char16_t)), '\0');
+    char *out = bytes.data();
+    std::memcpy(out, &header, sizeof(Header));
+    std::memcpy(out + header.classOffset, classes.constData(), classes.size() * sizeof(StringRef));
+    std::memcpy(out + header.courseNameOffset, courseNames.constData(), courseNames.size() * sizeof(StringRef));
+    std::memcpy(out + header.courseOffset, courses.constData(), courses.size() * sizeof(CourseEntry));
+    std::memcpy(out + header.aggregateOffset, aggregates.constData(), aggregates.size() * sizeof(AggregateEntry));
+    std::memcpy(out + header.poolOffset, pool.constData(), pool.size() * sizeof(char16_t));
+    return bytes;
+}
+
+void DataSnapshot::rebuild()
+{
+    if (m_rebuilding) return;
+    m_rebuilding = true;
+
+    using BuildResult = QPair<QByteArray, QString>;
+    auto *watcher = new QFutureWatcher<BuildResult>(this);
+    connect(watcher, &QFutureWatcher<BuildResult>::finished, this, [this, watcher]() {
+        m_rebuilding = false;
+        BuildResult result = watcher->result();
+        watcher->deleteLater();
+        if (result.first.isEmpty()) {
+            qWarning() << "生成启动快照失败：" << result.second;
+            emit rebuildFailed(result.second);
+            return;
+        }
+
+        // 先解除映射再替换文件（Windows 下被映射的文件不能被覆盖）
+        unmap();
+        QSaveFile file(filePath());
+        if (!file.open(QIODevice::WriteOnly) || file.write(result.first) != result.first.size() || !file.commit()) {
+            QString reason = "写入启动快照失败：" + file.errorString();
+            qWarning() << reason;
+            map(); // 旧文件仍在
+            emit rebuildFailed(reason);
+            return;
+        }
+        map();
+        emit rebuilt();
+    });
+    watcher->setFuture(QtConcurrent::run([]() -> BuildResult {
+        QString error;
+        QByteArray bytes = build(&error);
+        return {bytes, error};
+    }));
+}
+
+// ========== 映射与读取 ==========
+void DataSnapshot::open()
+{
+    if (!map() || !isCurrent()) rebuild();
+}
+
+bool DataSnapshot::map()
+{
+    unmap();
+    m_file.setFileName(filePath());
+    if (!m_file.open(QIODevice::ReadOnly)) return false;
+    m_size = m_file.size();
+    if (m_size < qint64(sizeof(Header)) || !(m_data = m_file.map(0, m_size))) {
+        unmap();
+        return false;
+    }
+
+    // 校验各区范围，损坏或旧格式的文件视为不存在
+    const Header *header = reinterpret_cast<const Header *>(m_data);
+    const quint64 size = quint64(m_size);
+    auto fits = [size](quint64 offset, quint64 count, quint64 elementSize) {
+        return offset % 8 == 0 && offset <= size && count <= (size - offset) / elementSize;
+    };
+    if (header->magic != kSnapshotMagic || header->format != kSnapshotFormat
+        || !fits(header->classOffset, header->classCount, sizeof(StringRef))
+        || !fits(header->courseNameOffset, header->courseNameCount, sizeof(StringRef))
+        || !fits(header->courseOffset, header->courseCount, sizeof(CourseEntry))
+        || !fits(header->aggregateOffset, header->aggregateCount, sizeof(AggregateEntry))
+        || !fits(header->poolOffset, header->poolChars, sizeof(char16_t))
+        || header->poolChars > std::numeric_limits<quint32>::max()) {
+        qWarning() << "启动快照格式无效，将重新生成：" << m_file.fileName();
+        unmap();
+        return false;
+    }
+    m_header = header;
+    return true;
+}
+
+void DataSnapshot::unmap()
+{
+    if (m_data) m_file.unmap(const_cast<uchar *>(m_data));
+    m_file.close();
+    m_data = nullptr;
+    m_size = 0;
+    m_header = nullptr;
+}
+
+bool DataSnapshot::isCurrent() const
+{
+    return m_header && m_header->dataVersion == DBManager::getInstance().dataVersion();
+}
+
+// 映射区内的零拷贝视图；引用越界（文件损坏）时返回空
+QStringView DataSnapshot::view(const StringRef& ref) const
+{
+    if (quint64(ref.offset) + ref.length > m_header->poolChars) return QStringView();
+    const char16_t *pool = reinterpret_cast<const char16_t *>(m_data + m_header->poolOffset);
+    return QStringView(pool + ref.offset, qsizetype(ref.length));
+}
+
+QStringList DataSnapshot::textList(quint64 offset, quint32 count) const
+{
+    QStringList list;
+    list.reserve(count);
+    const StringRef *refs = reinterpret_cast<const StringRef *>(m_data + offset);
+    for (quint32 i = 0; i < count; i++) list << view(refs[i]).toString();
+    return list;
+}
+
+QStringList DataSnapshot::classNames() const
+{
+    return m_header ? textList(m_header->classOffset, m_header->classCount) : QStringList();
+}
+
+QStringList DataSnapshot::courseNames() const
+{
+    return m_header ? textList(m_header->courseNameOffset, m_header->courseNameCount) : QStringList();
+}
+
+QString DataSnapshot::courseName(int courseId) const
+{
+    if (!m_header) return QString();
+    const CourseEntry *begin = reinterpret_cast<const CourseEntry *>(m_data + m_header->courseOffset);
+    const CourseEntry *end = begin + m_header->courseCount;
+    const CourseEntry *found = std::lower_bound(begin, end, courseId, [](const CourseEntry& entry, int id) {
+        return entry.courseId < id;
+    });
+    return (found != end && found->courseId == courseId) ? view(found->name).toString() : QString();
+}
+
+bool DataSnapshot::summarize(const QString& classPattern, const QString& coursePattern, SnapshotStats *stats) const
+{
+    if (!isCurrent()) return false;
+
+    // 课程名匹配只算一次（与 LIKE '%x%' 口径一致，中文无大小写差异）
+    QSet<int> courseIds;
+    if (!coursePattern.isEmpty()) {
+        const CourseEntry *courses = reinterpret_cast<const CourseEntry *>(m_data + m_header->courseOffset);
+        for (quint32 i = 0; i < m_header->courseCount; i++) {
+            if (view(courses[i].name).contains(coursePattern, Qt::CaseInsensitive)) courseIds.insert(courses[i].courseId);
+        }
+    }
+
+    SnapshotStats result;
+    const AggregateEntry *entries = reinterpret_cast<const AggregateEntry *>(m_data + m_header->aggregateOffset);
+    for (quint32 i = 0; i < m_header->aggregateCount; i++) {
+        const AggregateEntry& entry = entries[i];
+        if (!coursePattern.isEmpty() && !courseIds.contains(entry.courseId)) continue;
+        if (!classPattern.isEmpty() && !view(entry.className).contains(classPattern, Qt::CaseInsensitive)) continue;
+        result.minScore = result.count == 0 ? entry.minScore : std::min(result.minScore, entry.minScore);
+        result.maxScore = result.count == 0 ? entry.maxScore : std::max(result.maxScore, entry.maxScore);
+        result.count += entry.count;
+        result.total += entry.total;
+        result.totalSq += entry.totalSq;
+    }
+    *stats = result;
+    return true;
+}
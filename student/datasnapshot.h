@@ -0,0 +1,81 @@
+#ifndef DATASNAPSHOT_H
+#define DATASNAPSHOT_H
+
+#include <QObject>
+#include <QFile>
+#include <QStringList>
+
+// 快照中的全日期范围统计（与 score_summary 汇总口径一致）
+struct SnapshotStats {
+    qint64 count = 0;
+    double total = 0;
+    double totalSq = 0;
+    double minScore = 0;
+    double maxScore = 0;
+};
+
+// 启动快照：班级/课程字典、课程ID映射、班级×科目的预聚合统计，
+// 写成定长记录 + 字符串池的二进制文件，启动时内存映射直接读取，不经过SQL。
+// 文件头记录生成时的数据版本号（DBManager::dataVersion），与库中不一致即为过期，
+// 过期时先照常使用字典，同时在后台重建，完成后发出 rebuilt。
+class DataSnapshot : public QObject
+{
+    Q_OBJECT
+
+public:
+    static DataSnapshot& getInstance() {
+        static DataSnapshot instance;
+        return instance;
+    }
+
+    // 映射快照文件；缺失、损坏或过期时在后台重建
+    void open();
+    // 在工作线程读取数据库生成新快照，完成后重新映射
+    void rebuild();
+
+    bool isLoaded() const { return m_header != nullptr; }
+    bool isRebuilding() const { return m_rebuilding; }
+    // 快照版本与数据库当前版本一致（每次调用查询一次版本号）
+    bool isCurrent() const;
+
+    QStringList classNames() const;
+    QStringList courseNames() const;
+    // 课程ID -> 名称（二分查找映射区），不存在返回空
+    QString courseName(int courseId) const;
+
+    // 班级/课程名模糊匹配（空为不限）的全日期统计；快照未加载或已过期时返回 false
+    bool summarize(const QString& classPattern, const QString& coursePattern, SnapshotStats *stats) const;
+
+    // 快照文件位置：SQLite 为数据库文件旁的 .snapshot，服务器后端放在缓存目录
+    static QString filePath();
+
+signals:
+    void rebuilt();
+    void rebuildFailed(const QString& reason);
+
+private:
+    DataSnapshot();
+    ~DataSnapshot() override;
+    DataSnapshot(const DataSnapshot&) = delete;
+    DataSnapshot& operator=(const DataSnapshot&) = delete;
+
+    struct Header;
+    struct StringRef;
+    struct CourseEntry;
+    struct AggregateEntry;
+
+    // 在工作线程生成快照文件内容，失败返回空
+    static QByteArray build(QString *errorMessage);
+    bool map();
+    void unmap();
+    QStringView view(const StringRef& ref) const;
+    QStringList textList(quint64 offset, quint32 count) const;
+
+    QFile m_file;
+    const uchar *m_data = nullptr;
+    qint64 m_size = 0;
+    const Header *m_header = nullptr;
+    bool m_rebuilding = false;
+};
+
+#endif // DATASNAPSHOT_H
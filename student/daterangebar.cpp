@@ -0,0 +1,82 @@
+#include "daterangebar.h"
+#include "dbmanager.h"
+#include <QComboBox>
+#include <QDateEdit>
+#include <QHBoxLayout>
+#include <QLabel>
+
+// 预设项顺序
+enum DatePreset {
+    PresetAll = 0,     // 全部日期
+    PresetTerm,        // 本学期
+    PresetYear,        // 近一年
+    PresetCustom       // 自定义
+};
+
+DateRangeBar::DateRangeBar(QWidget *parent) :
+    QWidget(parent),
+    m_cbPreset(new QComboBox(this)),
+    m_dateFrom(new QDateEdit(this)),
+    m_dateTo(new QDateEdit(this))
+{
+    m_cbPreset->addItems({"全部日期", "本学期", "近一年", "自定义"});
+    m_dateFrom->setCalendarPopup(true);
+    m_dateTo->setCalendarPopup(true);
+    m_dateFrom->setDisplayFormat("yyyy-MM-dd");
+    m_dateTo->setDisplayFormat("yyyy-MM-dd");
+    m_dateFrom->setDate(QDate::currentDate().addYears(-1));
+    m_dateTo->setDate(QDate::currentDate());
+    m_dateFrom->setEnabled(false);
+    m_dateTo->setEnabled(false);
+
+    QHBoxLayout *layout = new QHBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(new QLabel("考试日期：", this));
+    layout->addWidget(m_cbPreset);
+    layout->addWidget(m_dateFrom);
+    layout->addWidget(new QLabel("至", this));
+    layout->addWidget(m_dateTo);
+    layout->addStretch();
+
+    connect(m_cbPreset, &QComboBox::currentIndexChanged, this, &DateRangeBar::onPresetChanged);
+    connect(m_dateFrom, &QDateEdit::dateChanged, this, &DateRangeBar::onDateEdited);
+    connect(m_dateTo, &QDateEdit::dateChanged, this, &DateRangeBar::onDateEdited);
+}
+
+QDate DateRangeBar::dateFrom() const
+{
+    return m_cbPreset->currentIndex() == PresetAll ? QDate() : m_dateFrom->date();
+}
+
+QDate DateRangeBar::dateTo() const
+{
+    return m_cbPreset->currentIndex() == PresetAll ? QDate() : m_dateTo->date();
+}
+
+void DateRangeBar::onPresetChanged(int index)
+{
+    // 预设项改写日期框时暂停信号，最后统一发出一次
+    m_dateFrom->blockSignals(true);
+    m_dateTo->blockSignals(true);
+    if (index == PresetTerm) {
+        TermRange term = DBManager::termOf(QDate::currentDate());
+        m_dateFrom->setDate(term.first);
+        m_dateTo->setDate(term.last);
+    } else if (index == PresetYear) {
+        m_dateFrom->setDate(QDate::currentDate().addYears(-1));
+        m_dateTo->setDate(QDate::currentDate());
+    }
+    m_dateFrom->blockSignals(false);
+    m_dateTo->blockSignals(false);
+
+    m_dateFrom->setEnabled(index == PresetCustom);
+    m_dateTo->setEnabled(index == PresetCustom);
+    emit rangeChanged(dateFrom(), dateTo());
+}
+
+void DateRangeBar::onDateEdited()
+{
+    if (m_cbPreset->currentIndex() != PresetCustom) return;
+    if (m_dateFrom->date() > m_dateTo->date()) return; // 起止颠倒时等待用户改完
+    emit rangeChanged(dateFrom(), dateTo());
+}
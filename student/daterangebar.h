@@ -0,0 +1,34 @@
+#ifndef DATERANGEBAR_H
+#define DATERANGEBAR_H
+
+#include <QWidget>
+#include <QDate>
+
+class QComboBox;
+class QDateEdit;
+
+// 日期范围筛选条：统计页与图表页共用，空日期表示不限
+class DateRangeBar : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit DateRangeBar(QWidget *parent = nullptr);
+
+    QDate dateFrom() const;
+    QDate dateTo() const;
+
+signals:
+    void rangeChanged(const QDate& from, const QDate& to);
+
+private slots:
+    void onPresetChanged(int index);
+    void onDateEdited();
+
+private:
+    QComboBox *m_cbPreset;
+    QDateEdit *m_dateFrom;
+    QDateEdit *m_dateTo;
+};
+
+#endif // DATERANGEBAR_H
@@ -1,18 +1,592 @@
 #include "dbmanager.h"
+#include "schema.h"
+#include <limits>
+#include <QCoreApplication>
+#include <QThread>
+#include <QFile>
+#include <QRegularExpression>
+#include <QSettings>
+#include <QVersionNumber>
+#include <atomic>
+
+DatabaseConfig DatabaseConfig::load(const QString& iniPath)
+{
+    DatabaseConfig config;
+    if (!QFile::exists(iniPath)) return config;
+
+    QSettings settings(iniPath, QSettings::IniFormat);
+    settings.beginGroup("database");
+    config.driver = settings.value("driver", config.driver).toString().trimmed().toUpper();
+    config.database = settings.value("database", config.database).toString();
+    config.host = settings.value("host").toString();
+    config.port = settings.value("port", 0).toInt();
+    config.user = settings.value("user").toString();
+    config.password = settings.value("password").toString();
+    config.options = settings.value("options").toString();
+    config.poolSize = settings.value("pool_size", config.poolSize).toInt();
+    config.rosterPageSize = qMax(10, settings.value("page_size", config.rosterPageSize).toInt());
+    config.writerDelayMs = qMax(0, settings.value("writer_delay_ms", config.writerDelayMs).toInt());
+    config.writerBatch = qMax(0, settings.value("writer_batch", config.writerBatch).toInt());
+    settings.endGroup();
+    return config;
+}
+
 bool DBManager::initDB(const QString& dbPath)
+{
+    DatabaseConfig config;
+    config.database = dbPath;
+    return initDB(config);
+}
+
+bool DBManager::initDB(const DatabaseConfig& config)
 {
     if (m_db.isOpen()) return true; // 避免重复连接
-    // 初始化SQLite连接
-    m_db = QSqlDatabase::addDatabase("QSQLITE");
-    m_db.setDatabaseName(dbPath);
+    if (!SqlDialect::isSupportedDriver(config.driver) || !QSqlDatabase::isDriverAvailable(config.driver)) {
+        qCritical() << "不支持或未安装的数据库驱动：" << config.driver;
+        return false;
+    }
+    m_config = config;
+
+    m_db = QSqlDatabase::addDatabase(config.driver);
+    m_db.setDatabaseName(config.database);
+    if (config.isSQLite()) {
+        // 工作线程读写时短暂等待锁，而不是立即报错
+        m_db.setConnectOptions(config.options.isEmpty() ? "QSQLITE_BUSY_TIMEOUT=5000" : config.options);
+    } else {
+        m_db.setHostName(config.host);
+        if (config.port > 0) m_db.setPort(config.port);
+        m_db.setUserName(config.user);
+        m_db.setPassword(config.password);
+        m_db.setConnectOptions(config.options);
+    }
     if (!m_db.open()) {
         qCritical() << "数据库连接失败：" << m_db.lastError().text();
         return false;
     }
-    qInfo() << "数据库连接成功！";
+
+    QSqlQuery versionQuery = execQuery(config.isSQLite() ? "SELECT sqlite_version()" : "SELECT VERSION()");
+    QString versionText = versionQuery.next() ? versionQuery.value(0).toString() : QString();
+    versionQuery.finish();
+    // PostgreSQL 返回 "PostgreSQL 15.4 on ..."，取第一个版本号
+    QRegularExpressionMatch match = QRegularExpression("(\\d+(\\.\\d+)+)").match(versionText);
+    m_dialect = SqlDialect::forDriver(config.driver, QVersionNumber::fromString(match.captured(1)));
+    qInfo() << "数据库连接成功！" << m_dialect.name() << m_dialect.serverVersion().toString();
+
+    if (!config.isSQLite()) {
+        // 建表、迁移与触发器目前只有 SQLite 版本，本程序不会在服务器上建库：服务器库须由管理员按 SQLite 库的
+        // 结构预先建好（含维护汇总表与数据版本号的触发器），这里只核对表是否齐全并读入分区登记
+        const QStringList tables = m_db.tables();
+        QStringList missing;
+        for (const char *table : {"students", "courses", "scores", "users", "score_summary", "gpa_course_terms",
+                                  "grade_points", "db_meta"}) {
+            if (!tables.contains(table)) missing << table;
+        }
+        if (!missing.isEmpty()) {
+            qCritical() << "服务器数据库缺少表：" << missing.join(", ")
+                        << "（程序不会自动在服务器上建表，请按 SQLite 库的结构预先建库）";
+            return false;
+        }
+        if (tables.contains("score_partitions") && !(loadPartitions() && refreshScoresView())) return false;
+        return verifySchema();
+    }
+
+    // WAL模式：工作线程读取与主线程写入互不阻塞
+    execNonQuery("PRAGMA journal_mode = WAL");
+    return migrateSchema() && initSchema() && verifySchema();
+}
+
+// 核对实际表结构与 schema.h 中的编译期描述一致（界面按列下标常量读取）
+bool DBManager::verifySchema()
+{
+    QString error;
+    QSqlRecord scoresView = m_db.record("scores_all");
+    bool ok = Schema::verify<Schema::Students>(m_db.record(Schema::Students::name), Schema::Students::name, &error)
+              && Schema::verify<Schema::Courses>(m_db.record(Schema::Courses::name), Schema::Courses::name, &error)
+              && Schema::verify<Schema::Scores>(m_db.record(Schema::Scores::name), Schema::Scores::name, &error)
+              && (scoresView.isEmpty() || Schema::verify<Schema::Scores>(scoresView, "scores_all", &error))
+              && Schema::verify<Schema::Users>(m_db.record(Schema::Users::name), Schema::Users::name, &error)
+              && Schema::verify<Schema::GradePoints>(m_db.record(Schema::GradePoints::name), Schema::GradePoints::name, &error);
+    if (!ok) qCritical() << "数据库表结构与程序不一致：" << error;
+    return ok;
+}
+
+// scores 表结构（主表与学期分区表共用，列顺序必须一致以便 UNION ALL）
+static QString scoresTableDdl(const QString& tableName, const QString& extraConstraint)
+{
+    return QString("CREATE TABLE %1 ("
+                   "\"score_id\" integer NOT NULL, "
+                   "\"score\" REAL NOT NULL, "
+                   "\"exam_date\" INTEGER NOT NULL, "
+                   "\"student_id\" integer NOT NULL, "
+                   "\"course_id\" INTEGER, "
+                   "PRIMARY KEY (\"score_id\"), "
+                   "CONSTRAINT \"fk_scores_students_1\" FOREIGN KEY (\"student_id\") REFERENCES \"students\" (\"student_id\"), "
+                   "CONSTRAINT \"fk_scores_courses_2\" FOREIGN KEY (\"course_id\") REFERENCES \"courses\" (\"course_id\")%2)")
+        .arg(tableName, extraConstraint);
+}
+
+// ========== 存储格式迁移 ==========
+// v1：exam_date 由 "yyyy-MM-dd" 文本改为儒略日整数，score 改为 REAL，
+// 范围筛选与排序直接比较整数，读取时不再逐行解析日期字符串
+// v2：courses 增加学分 credit（缺省 1 学分），用于加权平均与 GPA
+bool DBManager::migrateSchema()
+{
+    QSqlQuery versionQuery = execQuery("PRAGMA user_version");
+    int version = versionQuery.next() ? versionQuery.value(0).toInt() : 0;
+    versionQuery.finish(); // 释放语句，否则后续 DROP TABLE 会报表被锁定
+    if (version >= kSchemaVersion) return true;
+
+    qInfo() << "迁移数据库存储格式：" << version << "->" << kSchemaVersion;
+    if (!m_db.transaction()) {
+        qCritical() << "开启事务失败：" << m_db.lastError().text();
+        return false;
+    }
+
+    // 视图引用 scores，重建表前先删除，initSchema 会重新创建
+    QStringList steps{"DROP VIEW IF EXISTS scores_all"};
+    if (version < 1) {
+        // 无法解析的日期按当天处理（与原图表读取逻辑一致）；julianday 以正午为界，+0.5 后取整即 QDate 的儒略日
+        steps << scoresTableDdl("scores_v1", QString())
+              << "INSERT INTO scores_v1 (score_id, score, exam_date, student_id, course_id) "
+                 "SELECT score_id, CAST(score AS REAL), "
+                 "CAST(IFNULL(julianday(TRIM(exam_date)), julianday('now', 'localtime')) + 0.5 AS INTEGER), "
+                 "student_id, course_id FROM scores"
+              << "DROP TABLE scores"
+              << "ALTER TABLE scores_v1 RENAME TO scores"
+              // 汇总表的 exam_date 类型随之变化，由 initSchema 重建
+              << "DROP TABLE IF EXISTS score_summary";
+    }
+    if (version < 2) {
+        steps << "ALTER TABLE courses ADD COLUMN credit REAL NOT NULL DEFAULT 1";
+    }
+    steps << QString("PRAGMA user_version = %1").arg(kSchemaVersion);
+
+    for (const QString& sql : steps) {
+        if (!execNonQuery(sql)) {
+            m_db.rollback();
+            return false;
+        }
+    }
+    return m_db.commit();
+}
+
+// ========== 成绩汇总表 ==========
+// score_summary 按 班级×科目×考试日期 预聚合：数量、总和、平方和、最值及10分一档的分布桶。
+// 统计页只需扫描分组行（O(分组数)），不再遍历 scores 原始记录。
+static const int kSummaryBuckets = 10;
+
+// 成绩所属分布桶（0-9，100分归入第9档）
+static QString bucketExpr(const QString& scoreExpr)
+{
+    return QString("MIN(CAST(%1 / 10 AS INTEGER), 9)").arg(scoreExpr);
+}
+
+// 生成按分组聚合成绩的 SELECT，列名/列顺序与 score_summary 一致；extraWhere 以 AND 开头。
+// 数据源为 scores_all（主表 + 归档分区）：调班、重算分组与全量重建都不能丢掉已归档学期的统计。
+// 触发器体在执行时才解析视图，归档后重建视图即可生效（视图由 refreshScoresView 维护）
+static QString summaryAggregateSql(const QString& extraWhere)
+{
+    QString buckets;
+    for (int i = 0; i < kSummaryBuckets; i++) {
+        buckets += QString(", SUM(%1 = %2) AS b%2").arg(bucketExpr("sc.score")).arg(i);
+    }
+    return QString(
+               "SELECT IFNULL(st.class_name, '') AS class_name, sc.course_id AS course_id, sc.exam_date AS exam_date, "
+               "COUNT(*) AS cnt, SUM(sc.score) AS total, SUM(sc.score * sc.score) AS total_sq, "
+               "MIN(sc.score) AS min_score, MAX(sc.score) AS max_score%1 "
+               "FROM scores_all sc LEFT JOIN students st ON st.student_id = sc.student_id "
+               "WHERE sc.course_id IS NOT NULL AND sc.score BETWEEN 0 AND 100 %2 "
+               "GROUP BY 1, 2, 3")
+        .arg(buckets, extraWhere);
+}
+
+// 触发器内：重算某一分组（先删后插，分组已无成绩时不会插入新行）
+static QString recomputeGroupSql(const QString& row)
+{
+    QString classExpr = QString("IFNULL((SELECT class_name FROM students WHERE student_id = %1.student_id), '')").arg(row);
+    return QString(
+               "DELETE FROM score_summary WHERE class_name = %1 AND course_id = %2.course_id AND exam_date = %2.exam_date; "
+               "INSERT INTO score_summary %3; ")
+        .arg(classExpr, row,
+             summaryAggregateSql(QString("AND IFNULL(st.class_name, '') = %1 AND sc.course_id = %2.course_id "
+                                         "AND sc.exam_date = %2.exam_date").arg(classExpr, row)));
+}
+
+bool DBManager::initSchema()
+{
+    // 登录按用户名单次查找
+    if (!execNonQuery("CREATE INDEX IF NOT EXISTS idx_users_username ON users(username)")) {
+        return false;
+    }
+
+    // 班级趋势图按 班级→学生、科目→日期 取数
+    if (!execNonQuery("CREATE INDEX IF NOT EXISTS idx_students_class ON students(class_name, student_id)")
+        || !execNonQuery("CREATE INDEX IF NOT EXISTS idx_scores_course_date ON scores(course_id, exam_date)")
+        // 个人趋势图按 学生+科目+日期窗口 取数
+        || !execNonQuery("CREATE INDEX IF NOT EXISTS idx_scores_student ON scores(student_id, course_id, exam_date)")
+        // 日期范围筛选（统计页/图表页共用的日期条件）
+        || !execNonQuery("CREATE INDEX IF NOT EXISTS idx_scores_date ON scores(exam_date)")) {
+        return false;
+    }
+
+    bool summaryExists = m_db.tables().contains("score_summary");
+
+    QString bucketCols;
+    for (int i = 0; i < kSummaryBuckets; i++) {
+        bucketCols += QString(", b%1 INTEGER NOT NULL DEFAULT 0").arg(i);
+    }
+    QString createSummary = QString(
+                                "CREATE TABLE IF NOT EXISTS score_summary ("
+                                "class_name TEXT NOT NULL, course_id INTEGER NOT NULL, exam_date INTEGER NOT NULL, "
+                                "cnt INTEGER NOT NULL DEFAULT 0, total REAL NOT NULL DEFAULT 0, total_sq REAL NOT NULL DEFAULT 0, "
+                                "min_score REAL, max_score REAL%1, "
+                                "PRIMARY KEY (class_name, course_id, exam_date)) WITHOUT ROWID")
+                                .arg(bucketCols);
+    if (!execNonQuery(createSummary)) return false;
+    if (!createSummaryTriggers()) return false;
+
+    // 学期分区登记表
+    if (!execNonQuery("CREATE TABLE IF NOT EXISTS score_partitions ("
+                      "term_key TEXT PRIMARY KEY, table_name TEXT NOT NULL, "
+                      "first_day INTEGER NOT NULL, last_day INTEGER NOT NULL, "
+                      "row_count INTEGER NOT NULL DEFAULT 0, archived_at TEXT)")) {
+        return false;
+    }
+
+    // 成绩变更日志：只追加，撤销/恢复也以新记录写入，便于按时间点回退
+    if (!execNonQuery("CREATE TABLE IF NOT EXISTS score_log ("
+                      "log_id INTEGER PRIMARY KEY AUTOINCREMENT, "
+                      "op TEXT NOT NULL, " // I 新增 / U 修改 / D 删除 / A 归档标记
+                      "logged_at TEXT NOT NULL DEFAULT (strftime('%Y-%m-%d %H:%M:%f', 'now', 'localtime')), "
+                      "score_id INTEGER, "
+                      "old_score REAL, old_exam_date INTEGER, old_student_id INTEGER, old_course_id INTEGER, "
+                      "new_score REAL, new_exam_date INTEGER, new_student_id INTEGER, new_course_id INTEGER, "
+                      "note TEXT)")
+        || !execNonQuery("CREATE INDEX IF NOT EXISTS idx_score_log_time ON score_log(logged_at)")
+        || !createAuditTriggers()) {
+        return false;
+    }
+
+    // 数据版本号：基础表任一行变更即递增，启动快照据此判断是否过期
+    if (!execNonQuery("CREATE TABLE IF NOT EXISTS db_meta (key TEXT PRIMARY KEY, value INTEGER NOT NULL)")
+        || !execNonQuery(m_dialect.insertIgnoreSql("db_meta", {"key", "value"}, "VALUES ('data_version', 0)"))) {
+        return false;
+    }
+    for (const char *table : {"students", "courses", "scores"}) {
+        for (const char *event : {"INSERT", "UPDATE", "DELETE"}) {
+            QString trigger = QString("CREATE TRIGGER IF NOT EXISTS trg_%1_version_%2 AFTER %3 ON %1 BEGIN "
+                                      "UPDATE db_meta SET value = value + 1 WHERE key = 'data_version'; END")
+                                  .arg(table, QString(event).left(3).toLower(), event);
+            if (!execNonQuery(trigger)) return false;
+        }
+    }
+
+    // 绩点对照表（不低于 min_score 取 points）与绩点聚合表
+    bool gradePointsExists = m_db.tables().contains("grade_points");
+    bool gpaTermsExists = m_db.tables().contains("gpa_course_terms");
+    if (!execNonQuery("CREATE TABLE IF NOT EXISTS grade_points ("
+                      "min_score REAL PRIMARY KEY, points REAL NOT NULL, label TEXT)")
+        || (!gradePointsExists
+            && !execNonQuery("INSERT INTO grade_points (min_score, points, label) VALUES "
+                             "(90, 4.0, 'A'), (85, 3.7, 'A-'), (82, 3.3, 'B+'), (78, 3.0, 'B'), (75, 2.7, 'B-'), "
+                             "(72, 2.3, 'C+'), (68, 2.0, 'C'), (64, 1.5, 'C-'), (60, 1.0, 'D'), (0, 0, 'F')"))
+        || !execNonQuery("CREATE TABLE IF NOT EXISTS gpa_course_terms ("
+                         "student_id INTEGER NOT NULL, course_id INTEGER NOT NULL, term_first INTEGER NOT NULL, "
+                         "cnt INTEGER NOT NULL DEFAULT 0, total REAL NOT NULL DEFAULT 0, "
+                         "PRIMARY KEY (student_id, course_id, term_first)) WITHOUT ROWID")
+        || !execNonQuery("CREATE INDEX IF NOT EXISTS idx_gpa_terms_term ON gpa_course_terms(term_first)")
+        || !createGpaTriggers()) {
+        return false;
+    }
+
+    if (!loadPartitions() || !refreshScoresView()) return false;
+    // 首次创建汇总表/绩点聚合表时用全部成绩（含归档分区）填充，需在 scores_all 视图建好之后
+    return (summaryExists || rebuildScoreSummary()) && (gpaTermsExists || rebuildGpaTerms());
+}
+
+qint64 DBManager::dataVersion()
+{
+    QSqlQuery query(threadConnection());
+    if (!query.exec("SELECT value FROM db_meta WHERE key = 'data_version'") || !query.next()) {
+        return -1;
+    }
+    return query.value(0).toLongLong();
+}
+
+bool DBManager::createSummaryTriggers()
+{
+    // 新增成绩：增量累加，避免批量录入时反复重算整组
+    QString bucketUpdates;
+    for (int i = 0; i < kSummaryBuckets; i++) {
+        bucketUpdates += QString(", b%1 = b%1 + (%2 = %1)").arg(i).arg(bucketExpr("NEW.score"));
+    }
+    QString newClass = "IFNULL((SELECT class_name FROM students WHERE student_id = NEW.student_id), '')";
+    QString insertTrigger = QString(
+                                "CREATE TRIGGER IF NOT EXISTS trg_scores_summary_ins AFTER INSERT ON scores "
+                                "WHEN NEW.course_id IS NOT NULL AND NEW.score BETWEEN 0 AND 100 BEGIN "
+                                "%3; "
+                                "UPDATE score_summary SET cnt = cnt + 1, total = total + NEW.score, "
+                                "total_sq = total_sq + NEW.score * NEW.score, "
+                                "min_score = MIN(IFNULL(min_score, NEW.score), NEW.score), "
+                                "max_score = MAX(IFNULL(max_score, NEW.score), NEW.score)%2 "
+                                "WHERE class_name = %1 AND course_id = NEW.course_id AND exam_date = NEW.exam_date; "
+                                "END")
+                                .arg(newClass, bucketUpdates,
+                                     m_dialect.insertIgnoreSql("score_summary", {"class_name", "course_id", "exam_date"},
+                                                               QString("VALUES (%1, NEW.course_id, NEW.exam_date)").arg(newClass)));
+
+    // 删除/修改成绩：最值无法增量回退，重算受影响的分组
+    QString deleteTrigger = QString(
+                                "CREATE TRIGGER IF NOT EXISTS trg_scores_summary_del AFTER DELETE ON scores "
+                                "WHEN OLD.course_id IS NOT NULL BEGIN %1END")
+                                .arg(recomputeGroupSql("OLD"));
+    QString updateTrigger = QString(
+                                "CREATE TRIGGER IF NOT EXISTS trg_scores_summary_upd "
+                                "AFTER UPDATE OF score, exam_date, student_id, course_id ON scores BEGIN %1%2END")
+                                .arg(recomputeGroupSql("OLD"), recomputeGroupSql("NEW"));
+
+    // 学生调班：重算新旧两个班级的全部分组
+    QString classTrigger = QString(
+                               "CREATE TRIGGER IF NOT EXISTS trg_students_summary_class "
+                               "AFTER UPDATE OF class_name ON students BEGIN "
+                               "DELETE FROM score_summary WHERE class_name IN (OLD.class_name, NEW.class_name); "
+                               "INSERT INTO score_summary %1; END")
+                               .arg(summaryAggregateSql("AND IFNULL(st.class_name, '') IN (OLD.class_name, NEW.class_name)"));
+
+    return execNonQuery(insertTrigger) && execNonQuery(deleteTrigger)
+           && execNonQuery(updateTrigger) && execNonQuery(classTrigger);
+}
+
+bool DBManager::createAuditTriggers()
+{
+    QString insertTrigger =
+        "CREATE TRIGGER IF NOT EXISTS trg_score_log_ins AFTER INSERT ON scores BEGIN "
+        "INSERT INTO score_log (op, score_id, new_score, new_exam_date, new_student_id, new_course_id) "
+        "VALUES ('I', NEW.score_id, NEW.score, NEW.exam_date, NEW.student_id, NEW.course_id); END";
+    QString updateTrigger =
+        "CREATE TRIGGER IF NOT EXISTS trg_score_log_upd "
+        "AFTER UPDATE OF score, exam_date, student_id, course_id ON scores BEGIN "
+        "INSERT INTO score_log (op, score_id, old_score, old_exam_date, old_student_id, old_course_id, "
+        "new_score, new_exam_date, new_student_id, new_course_id) "
+        "VALUES ('U', OLD.score_id, OLD.score, OLD.exam_date, OLD.student_id, OLD.course_id, "
+        "NEW.score, NEW.exam_date, NEW.student_id, NEW.course_id); END";
+    QString deleteTrigger =
+        "CREATE TRIGGER IF NOT EXISTS trg_score_log_del AFTER DELETE ON scores BEGIN "
+        "INSERT INTO score_log (op, score_id, old_score, old_exam_date, old_student_id, old_course_id) "
+        "VALUES ('D', OLD.score_id, OLD.score, OLD.exam_date, OLD.student_id, OLD.course_id); END";
+
+    // 日志本身禁止修改和删除
+    QString guardUpdate = "CREATE TRIGGER IF NOT EXISTS trg_score_log_no_update BEFORE UPDATE ON score_log "
+                          "BEGIN SELECT RAISE(ABORT, 'score_log is append-only'); END";
+    QString guardDelete = "CREATE TRIGGER IF NOT EXISTS trg_score_log_no_delete BEFORE DELETE ON score_log "
+                          "BEGIN SELECT RAISE(ABORT, 'score_log is append-only'); END";
+
+    return execNonQuery(insertTrigger) && execNonQuery(updateTrigger) && execNonQuery(deleteTrigger)
+           && execNonQuery(guardUpdate) && execNonQuery(guardDelete);
+}
+
+bool DBManager::rebuildScoreSummary()
+{
+    if (!m_db.transaction()) {
+        qCritical() << "开启事务失败：" << m_db.lastError().text();
+        return false;
+    }
+    if (!execNonQuery("DELETE FROM score_summary")
+        || !execNonQuery("INSERT INTO score_summary " + summaryAggregateSql(QString()))) {
+        m_db.rollback();
+        return false;
+    }
+    return m_db.commit();
+}
+
+int DBManager::checkScoreSummary(QString *errorMessage)
+{
+    // 触发器逐条累加与全量聚合的求和顺序不同，总和/平方和按精度取整后比较
+    QString columns = "class_name, course_id, exam_date, cnt, ROUND(total, 3), ROUND(total_sq, 1), min_score, max_score";
+    for (int i = 0; i < kSummaryBuckets; i++) columns += QString(", b%1").arg(i);
+    QString actual = QString("SELECT %1 FROM score_summary").arg(columns);
+    QString expected = QString("SELECT %1 FROM (%2) agg").arg(columns, summaryAggregateSql(QString()));
+    QSqlQuery query(threadConnection());
+    if (!query.exec(QString("SELECT COUNT(*) FROM (SELECT * FROM (%1 EXCEPT %2) UNION ALL SELECT * FROM (%2 EXCEPT %1))")
+                        .arg(actual, expected))
+        || !query.next()) {
+        if (errorMessage) *errorMessage = "核对成绩汇总表失败：" + query.lastError().text();
+        return -1;
+    }
+    return query.value(0).toInt();
+}
+
+bool DBManager::checkArchivedSummary(QString *report)
+{
+    auto fail = [report](const QString& message) {
+        if (report) *report = message;
+        return false;
+    };
+
+    const QList<TermRange> terms = archivableTerms();
+    if (terms.isEmpty()) return fail("没有可归档的学期（测试库的成绩应覆盖过去一年）");
+    const TermRange term = terms.first();
+    QString range = dateRangeSql("exam_date", term.first, term.last);
+    auto termTotals = [&](qint64 *groups, qint64 *rows) {
+        QSqlQuery query(m_db);
+        if (!query.exec("SELECT COUNT(*), COALESCE(SUM(cnt), 0) FROM score_summary WHERE 1 = 1" + range) || !query.next()) {
+            return false;
+        }
+        *groups = query.value(0).toLongLong();
+        *rows = query.value(1).toLongLong();
+        return true;
+    };
+
+    qint64 groupsBefore = 0;
+    qint64 rowsBefore = 0;
+    if (!termTotals(&groupsBefore, &rowsBefore)) return fail("读取汇总表失败：" + getLastError());
+    QString error;
+    if (!archiveTerm(term.key, &error)) return fail("归档失败：" + error);
+
+    // 调班：该学期有成绩的一名学生换到另一个班级，新旧两个班级的分组随之重算
+    QSqlQuery query(m_db);
+    if (!query.exec(QString("SELECT sc.student_id, st.class_name FROM scores_%1 sc "
+                            "JOIN students st ON st.student_id = sc.student_id LIMIT 1").arg(term.key))
+        || !query.next()) {
+        return fail("归档分区中没有成绩：" + query.lastError().text());
+    }
+    qint64 studentId = query.value(0).toLongLong();
+    QString oldClass = query.value(1).toString();
+    query.prepare("SELECT class_name FROM students WHERE class_name <> ? LIMIT 1");
+    query.addBindValue(oldClass);
+    if (!query.exec() || !query.next()) return fail("测试库至少需要两个班级");
+    QString newClass = query.value(0).toString();
+    query.prepare("UPDATE students SET class_name = ? WHERE student_id = ?");
+    query.addBindValue(newClass);
+    query.addBindValue(studentId);
+    if (!query.exec()) return fail("调班失败：" + query.lastError().text());
+    // 修改一条当前成绩，触发分组重算
+    if (!query.exec("UPDATE scores SET score = score WHERE score_id = (SELECT MIN(score_id) FROM scores)")) {
+        return fail("修改成绩失败：" + query.lastError().text());
+    }
+
+    qint64 groupsAfter = 0;
+    qint64 rowsAfter = 0;
+    if (!termTotals(&groupsAfter, &rowsAfter)) return fail("读取汇总表失败：" + getLastError());
+    if (rowsAfter != rowsBefore) {
+        return fail(QString("归档学期 %1 的汇总成绩数由 %2 变为 %3").arg(term.label).arg(rowsBefore).arg(rowsAfter));
+    }
+    int mismatched = checkScoreSummary(&error);
+    if (mismatched != 0) {
+        return fail(mismatched < 0 ? error : QString("score_summary 有 %1 个分组与实际成绩不一致").arg(mismatched));
+    }
+    if (report) {
+        *report = QString("归档 %1（%2 个分组、%3 条成绩）并将学生 %4 由 %5 调到 %6 后，汇总表与全部成绩一致")
+                      .arg(term.label).arg(groupsAfter).arg(rowsAfter).arg(studentId).arg(oldClass, newClass);
+    }
     return true;
 }
 
+// ========== 绩点聚合表 ==========
+// gpa_course_terms 按 学生×科目×学期 累计成绩数与总分（学期内多次考试取平均作为该科成绩），
+// 学分与绩点对照在查询时关联，修改学分/对照表不需要重建。学期以起始日的儒略日表示，可直接比较先后。
+
+// 成绩日期所属学期的起始日，与 DBManager::termOf 的划分一致（8月~次年1月、2月~7月）
+static QString termFirstSql(const QString& dayExpr)
+{
+    QString month = QString("CAST(strftime('%m', %1) AS INTEGER)").arg(dayExpr);
+    QString year = QString("CAST(strftime('%Y', %1) AS INTEGER)").arg(dayExpr);
+    return QString("CAST(julianday(CASE WHEN %1 >= 8 THEN %2 || '-08-01' WHEN %1 = 1 THEN (%2 - 1) || '-08-01' "
+                   "ELSE %2 || '-02-01' END) + 0.5 AS INTEGER)")
+        .arg(month, year);
+}
+
+// 触发器内：计入 / 扣除一条成绩（成绩数归零的行随即删除）
+static QString gpaAddSql(const SqlDialect& dialect, const QString& row)
+{
+    QString term = termFirstSql(row + ".exam_date");
+    return QString(
+               "%3; "
+               "UPDATE gpa_course_terms SET cnt = cnt + 1, total = total + %1.score "
+               "WHERE student_id = %1.student_id AND course_id = %1.course_id AND term_first = %2 "
+               "AND %1.score BETWEEN 0 AND 100; ")
+        .arg(row, term,
+             dialect.insertIgnoreSql("gpa_course_terms", {"student_id", "course_id", "term_first"},
+                                     QString("SELECT %1.student_id, %1.course_id, %2 "
+                                             "WHERE %1.course_id IS NOT NULL AND %1.score BETWEEN 0 AND 100")
+                                         .arg(row, term)));
+}
+
+static QString gpaRemoveSql(const QString& row)
+{
+    QString key = QString("student_id = %1.student_id AND course_id = %1.course_id AND term_first = %2")
+                      .arg(row, termFirstSql(row + ".exam_date"));
+    return QString(
+               "UPDATE gpa_course_terms SET cnt = cnt - 1, total = total - %1.score "
+               "WHERE %2 AND %1.score BETWEEN 0 AND 100; "
+               "DELETE FROM gpa_course_terms WHERE %2 AND cnt <= 0; ")
+        .arg(row, key);
+}
+
+bool DBManager::createGpaTriggers()
+{
+    QString insertTrigger = QString("CREATE TRIGGER IF NOT EXISTS trg_scores_gpa_ins AFTER INSERT ON scores BEGIN %1END")
+                                .arg(gpaAddSql(m_dialect, "NEW"));
+    QString deleteTrigger = QString("CREATE TRIGGER IF NOT EXISTS trg_scores_gpa_del AFTER DELETE ON scores BEGIN %1END")
+                                .arg(gpaRemoveSql("OLD"));
+    QString updateTrigger = QString("CREATE TRIGGER IF NOT EXISTS trg_scores_gpa_upd "
+                                    "AFTER UPDATE OF score, exam_date, student_id, course_id ON scores BEGIN %1%2END")
+                                .arg(gpaRemoveSql("OLD"), gpaAddSql(m_dialect, "NEW"));
+    return execNonQuery(insertTrigger) && execNonQuery(deleteTrigger) && execNonQuery(updateTrigger);
+}
+
+bool DBManager::rebuildGpaTerms()
+{
+    if (!m_db.transaction()) {
+        qCritical() << "开启事务失败：" << m_db.lastError().text();
+        return false;
+    }
+    QString aggregate = QString("INSERT INTO gpa_course_terms (student_id, course_id, term_first, cnt, total) "
+                                "SELECT student_id, course_id, %1, COUNT(*), SUM(score) FROM %2 "
+                                "WHERE course_id IS NOT NULL AND score BETWEEN 0 AND 100 GROUP BY 1, 2, 3")
+                            .arg(termFirstSql("exam_date"), scoreSource());
+    if (!execNonQuery("DELETE FROM gpa_course_terms") || !execNonQuery(aggregate)) {
+        m_db.rollback();
+        return false;
+    }
+    return m_db.commit();
+}
+
+// 工作线程连接：线程退出时关闭并移除，避免线程ID复用后拿到不属于本线程的连接
+namespace {
+struct ThreadConnectionHolder {
+    QString name;
+    ~ThreadConnectionHolder() {
+        if (name.isEmpty()) return;
+        {
+            QSqlDatabase db = QSqlDatabase::database(name, false);
+            db.close();
+        }
+        QSqlDatabase::removeDatabase(name);
+    }
+};
+}
+
+QSqlDatabase DBManager::threadConnection()
+{
+    if (QThread::currentThread() == QCoreApplication::instance()->thread()) {
+        return m_db;
+    }
+
+    thread_local ThreadConnectionHolder holder;
+    if (!holder.name.isEmpty()) {
+        return QSqlDatabase::database(holder.name);
+    }
+
+    static std::atomic<int> counter{0};
+    holder.name = QString("worker_%1").arg(++counter);
+    QSqlDatabase db = QSqlDatabase::cloneDatabase(m_db.connectionName(), holder.name);
+    if (!db.open()) {
+        qCritical() << "工作线程数据库连接失败：" << db.lastError().text();
+    }
+    return db;
+}
+
 QSqlQuery DBManager::execQuery(const QString& sql)
 {
     QSqlQuery query(m_db);
@@ -41,3 +615,314 @@ QString DBManager::encryptPassword(QString password)
 }
 
 
+
+// ========== 学期分区 ==========
+// 已结束的学期可归档到独立分区表 scores_<学期键>，主表 scores 只保留未归档学期，
+// 查询按日期范围只拼接有交集的分区，当前学期的查询不受历史数据量影响。
+// 学期划分：8月1日至次年1月31日为第一学期（键 yyyya），2月1日至7月31日为第二学期（键 yyyys）。
+TermRange DBManager::termOf(const QDate& date)
+{
+    TermRange term;
+    int year = date.year();
+    if (date.month() >= 8) {
+        term.key = QString("%1a").arg(year);
+        term.first = QDate(year, 8, 1);
+        term.last = QDate(year + 1, 1, 31);
+        term.label = QString("%1-%2学年第一学期").arg(year).arg(year + 1);
+    } else if (date.month() == 1) {
+        term.key = QString("%1a").arg(year - 1);
+        term.first = QDate(year - 1, 8, 1);
+        term.last = QDate(year, 1, 31);
+        term.label = QString("%1-%2学年第一学期").arg(year - 1).arg(year);
+    } else {
+        term.key = QString("%1s").arg(year);
+        term.first = QDate(year, 2, 1);
+        term.last = QDate(year, 7, 31);
+        term.label = QString("%1-%2学年第二学期").arg(year - 1).arg(year);
+    }
+    return term;
+}
+
+bool DBManager::loadPartitions()
+{
+    QList<ScorePartition> partitions;
+    QSqlQuery query = execQuery("SELECT term_key, table_name, first_day, last_day, row_count "
+                                "FROM score_partitions ORDER BY first_day");
+    while (query.next()) {
+        partitions.append({query.value(0).toString(), query.value(1).toString(),
+                           query.value(2).toLongLong(), query.value(3).toLongLong(),
+                           query.value(4).toLongLong()});
+    }
+    if (query.lastError().isValid()) return false;
+
+    QMutexLocker locker(&m_partitionMutex);
+    m_partitions = partitions;
+    return true;
+}
+
+QList<ScorePartition> DBManager::partitions() const
+{
+    QMutexLocker locker(&m_partitionMutex);
+    return m_partitions;
+}
+
+bool DBManager::isArchivedDate(const QDate& date) const
+{
+    qint64 day = toDayNumber(date);
+    QMutexLocker locker(&m_partitionMutex);
+    for (const ScorePartition& partition : m_partitions) {
+        if (day >= partition.firstDay && day <= partition.lastDay) return true;
+    }
+    return false;
+}
+
+QStringList DBManager::scoreTables(const QDate& from, const QDate& to) const
+{
+    // 主表始终参与（未归档学期的数据都在主表）；分区按日期范围裁剪，空日期表示不限
+    QStringList tables{"scores"};
+    qint64 fromDay = from.isValid() ? toDayNumber(from) : std::numeric_limits<qint64>::min();
+    qint64 toDay = to.isValid() ? toDayNumber(to) : std::numeric_limits<qint64>::max();
+
+    QMutexLocker locker(&m_partitionMutex);
+    for (const ScorePartition& partition : m_partitions) {
+        if (partition.lastDay >= fromDay && partition.firstDay <= toDay) {
+            tables << partition.tableName;
+        }
+    }
+    return tables;
+}
+
+QString DBManager::scoreSource(const QDate& from, const QDate& to) const
+{
+    QStringList tables = scoreTables(from, to);
+    if (tables.size() == 1) return tables.first();
+
+    QStringList selects;
+    for (const QString& table : tables) {
+        selects << QString("SELECT * FROM %1").arg(table);
+    }
+    return QString("(%1)").arg(selects.join(" UNION ALL "));
+}
+
+// 全部分区的只读视图，供 QSqlRelationalTableModel 等只能指定表名的场景使用
+bool DBManager::refreshScoresView()
+{
+    QStringList selects{"SELECT * FROM scores"};
+    for (const ScorePartition& partition : partitions()) {
+        selects << QString("SELECT * FROM %1").arg(partition.tableName);
+    }
+    return execNonQuery("DROP VIEW IF EXISTS scores_all")
+           && execNonQuery("CREATE VIEW scores_all AS " + selects.join(" UNION ALL "));
+}
+
+QList<TermRange> DBManager::archivableTerms()
+{
+    // 当前学期之前、主表中仍有数据的学期
+    QList<TermRange> terms;
+    TermRange current = termOf(QDate::currentDate());
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    query.prepare("SELECT DISTINCT exam_date FROM scores WHERE exam_date < ? ORDER BY exam_date");
+    bindDate(query, current.first);
+    if (!query.exec()) {
+        qCritical() << "查询可归档学期失败：" << query.lastError().text();
+        return terms;
+    }
+    while (query.next()) {
+        TermRange term = termOf(dateAt(query, 0));
+        if (terms.isEmpty() || terms.last().key != term.key) {
+            terms.append(term);
+        }
+    }
+    return terms;
+}
+
+bool DBManager::archiveTerm(const QString& termKey, QString *errorMessage)
+{
+    // 分区表结构与触发器调整使用 SQLite 语法，服务器后端由迁移脚本完成
+    if (!m_dialect.isSQLite()) {
+        if (errorMessage) *errorMessage = QString("%1 数据库暂不支持在客户端归档学期").arg(m_dialect.name());
+        return false;
+    }
+    TermRange term;
+    for (const TermRange& candidate : archivableTerms()) {
+        if (candidate.key == termKey) term = candidate;
+    }
+    if (term.key.isEmpty()) {
+        if (errorMessage) *errorMessage = QString("学期【%1】未结束或没有可归档的数据").arg(termKey);
+        return false;
+    }
+    for (const ScorePartition& partition : partitions()) {
+        if (partition.termKey == termKey) {
+            if (errorMessage) *errorMessage = QString("学期【%1】已归档").arg(term.label);
+            return false;
+        }
+    }
+
+    QString tableName = "scores_" + term.key;
+    qint64 firstDay = toDayNumber(term.first);
+    qint64 lastDay = toDayNumber(term.last);
+    QString range = QString("exam_date BETWEEN %1 AND %2").arg(firstDay).arg(lastDay);
+
+    if (!m_db.transaction()) {
+        if (errorMessage) *errorMessage = m_db.lastError().text();
+        return false;
+    }
+
+    // 归档是搬移而非删除：暂时去掉删除触发器，保留汇总表与绩点聚合表中该学期的统计
+    QStringList steps;
+    steps << scoresTableDdl(tableName, QString(", CHECK (%1)").arg(range))
+          << QString("INSERT INTO %1 SELECT * FROM scores WHERE %2").arg(tableName, range)
+          << QString("CREATE INDEX idx_%1_student ON %1(student_id, course_id, exam_date)").arg(tableName)
+          << QString("CREATE INDEX idx_%1_course_date ON %1(course_id, exam_date)").arg(tableName)
+          << QString("CREATE INDEX idx_%1_date ON %1(exam_date)").arg(tableName)
+          << "DROP TRIGGER IF EXISTS trg_scores_summary_del"
+          << "DROP TRIGGER IF EXISTS trg_score_log_del"
+          << "DROP TRIGGER IF EXISTS trg_scores_gpa_del"
+          << QString("DELETE FROM scores WHERE %1").arg(range)
+          // 日志中记一条归档标记：时间点恢复不能越过归档
+          << QString("INSERT INTO score_log (op, note) VALUES ('A', '%1')").arg(tableName)
+          << QString("INSERT INTO score_partitions (term_key, table_name, first_day, last_day, row_count, archived_at) "
+                     "SELECT '%1', '%2', %3, %4, COUNT(*), datetime('now', 'localtime') FROM %2")
+                 .arg(term.key, tableName).arg(firstDay).arg(lastDay);
+
+    for (const QString& sql : steps) {
+        if (!execNonQuery(sql)) {
+            if (errorMessage) *errorMessage = m_db.lastError().text();
+            m_db.rollback();
+            return false;
+        }
+    }
+    // scores_all 在同一事务内切换到含新分区的定义：汇总触发器经由该视图聚合，
+    // 提交后任何连接上的调班/重算都能看到已归档的成绩
+    if (!createSummaryTriggers() || !createAuditTriggers() || !createGpaTriggers()
+        || !loadPartitions() || !refreshScoresView() || !m_db.commit()) {
+        if (errorMessage) *errorMessage = m_db.lastError().text();
+        m_db.rollback();
+        loadPartitions();
+        return false;
+    }
+    qInfo() << "学期已归档：" << term.label << "->" << tableName;
+    return true;
+}
+
+
+
+// ========== 在线备份与时间点恢复 ==========
+// 备份用 VACUUM INTO 生成一致的快照文件；恢复不替换数据库文件，
+// 而是在线按 score_log 逆序撤销目标时间之后的变更（撤销本身也会记入日志，可再次回退）。
+static const char *kLogTimeFormat = "yyyy-MM-dd HH:mm:ss.zzz";
+
+bool DBManager::backupTo(const QString& filePath, QString *errorMessage)
+{
+    if (!m_dialect.isSQLite()) {
+        if (errorMessage) *errorMessage = QString("%1 数据库请使用服务器自带的备份工具").arg(m_dialect.name());
+        return false;
+    }
+    // VACUUM INTO 要求目标文件不存在
+    if (QFile::exists(filePath) && !QFile::remove(filePath)) {
+        if (errorMessage) *errorMessage = QString("无法覆盖文件：%1").arg(filePath);
+        return false;
+    }
+
+    QSqlQuery query(threadConnection());
+    query.prepare("VACUUM INTO ?");
+    query.addBindValue(filePath);
+    if (!query.exec()) {
+        if (errorMessage) *errorMessage = query.lastError().text();
+        qCritical() << "备份失败：" << query.lastError().text();
+        return false;
+    }
+    qInfo() << "数据库已备份到" << filePath;
+    return true;
+}
+
+QDateTime DBManager::earliestRestorePoint()
+{
+    QSqlQuery query = execQuery("SELECT MAX(logged_at) FROM score_log WHERE op = 'A'");
+    if (query.next() && !query.value(0).isNull()) {
+        return QDateTime::fromString(query.value(0).toString(), kLogTimeFormat);
+    }
+    query = execQuery("SELECT MIN(logged_at) FROM score_log");
+    if (query.next() && !query.value(0).isNull()) {
+        return QDateTime::fromString(query.value(0).toString(), kLogTimeFormat);
+    }
+    return QDateTime();
+}
+
+int DBManager::restoreToPointInTime(const QDateTime& target, QString *errorMessage)
+{
+    QString targetText = target.toString(kLogTimeFormat);
+
+    QSqlQuery archived(m_db);
+    archived.prepare("SELECT COUNT(*) FROM score_log WHERE op = 'A' AND logged_at > ?");
+    archived.addBindValue(targetText);
+    if (!archived.exec() || !archived.next()) {
+        if (errorMessage) *errorMessage = archived.lastError().text();
+        return -1;
+    }
+    if (archived.value(0).toInt() > 0) {
+        if (errorMessage) *errorMessage = "目标时间之后有学期归档，不能恢复到归档之前";
+        return -1;
+    }
+
+    // 先把待撤销的记录读入内存：撤销过程中触发器会继续向日志追加
+    struct LogEntry {
+        QString op;
+        QVariant scoreId;
+        QVariantList oldValues; // score, exam_date, student_id, course_id
+    };
+    QList<LogEntry> entries;
+    QSqlQuery logQuery(m_db);
+    logQuery.setForwardOnly(true);
+    logQuery.prepare("SELECT op, score_id, old_score, old_exam_date, old_student_id, old_course_id "
+                     "FROM score_log WHERE logged_at > ? ORDER BY log_id DESC");
+    logQuery.addBindValue(targetText);
+    if (!logQuery.exec()) {
+        if (errorMessage) *errorMessage = logQuery.lastError().text();
+        return -1;
+    }
+    while (logQuery.next()) {
+        entries.append({logQuery.value(0).toString(), logQuery.value(1),
+                        {logQuery.value(2), logQuery.value(3), logQuery.value(4), logQuery.value(5)}});
+    }
+    logQuery.finish();
+    if (entries.isEmpty()) return 0;
+
+    if (!m_db.transaction()) {
+        if (errorMessage) *errorMessage = m_db.lastError().text();
+        return -1;
+    }
+    QSqlQuery undoInsert(m_db), undoUpdate(m_db), undoDelete(m_db);
+    undoInsert.prepare("DELETE FROM scores WHERE score_id = ?");
+    undoUpdate.prepare("UPDATE scores SET score = ?, exam_date = ?, student_id = ?, course_id = ? WHERE score_id = ?");
+    undoDelete.prepare("INSERT INTO scores (score, exam_date, student_id, course_id, score_id) VALUES (?, ?, ?, ?, ?)");
+
+    for (const LogEntry& entry : entries) {
+        QSqlQuery *undo = nullptr;
+        if (entry.op == "I") {
+            undo = &undoInsert;
+        } else if (entry.op == "U") {
+            undo = &undoUpdate;
+            for (const QVariant& value : entry.oldValues) undo->addBindValue(value);
+        } else if (entry.op == "D") {
+            undo = &undoDelete;
+            for (const QVariant& value : entry.oldValues) undo->addBindValue(value);
+        } else {
+            continue;
+        }
+        undo->addBindValue(entry.scoreId);
+        if (!undo->exec()) {
+            if (errorMessage) *errorMessage = undo->lastError().text();
+            m_db.rollback();
+            return -1;
+        }
+    }
+    if (!m_db.commit()) {
+        if (errorMessage) *errorMessage = m_db.lastError().text();
+        m_db.rollback();
+        return -1;
+    }
+    qInfo() << "已恢复到" << targetText << "，撤销" << entries.size() << "条变更";
+    return entries.size();
+}
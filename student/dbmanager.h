@@ -6,6 +6,51 @@
 #include <QSqlError>
 #include <QDebug>
 #include <QCryptographicHash>
+#include <QDate>
+#include <QVariant>
+#include <QMutex>
+#include <QStringList>
+#include <QDateTime>
+#include "sqldialect.h"
+
+// 学期（归档与分区的单位）
+struct TermRange {
+    QString key;    // 如 2025a（第一学期）、2026s（第二学期）
+    QString label;  // 显示名称
+    QDate first;
+    QDate last;
+};
+
+// 已归档的学期分区表
+struct ScorePartition {
+    QString termKey;
+    QString tableName;
+    qint64 firstDay;
+    qint64 lastDay;
+    qint64 rowCount;
+};
+
+// 数据库连接配置（studentdb.ini 的 [database] 节），缺省为当前目录下的 SQLite 文件。
+// 限制：建表、存储格式迁移与汇总/审计/绩点触发器只有 SQLite 版本。使用 PostgreSQL/MySQL 时程序只连接、核对表结构，
+// 不会建库；服务器库须预先建好与 SQLite 库相同的表（students/courses/scores/users/score_summary/gpa_course_terms/
+// grade_points/db_meta）及维护 score_summary、gpa_course_terms、db_meta.data_version 的触发器，缺表时启动失败
+struct DatabaseConfig {
+    QString driver = "QSQLITE";     // QSQLITE / QPSQL / QMYSQL
+    QString database = "studentdb.db"; // SQLite 为文件路径，服务器为库名
+    QString host;
+    int port = 0;
+    QString user;
+    QString password;
+    QString options;                // 额外的连接选项（setConnectOptions）
+    int poolSize = 8;               // 服务器后端的并行读连接上限
+    int rosterPageSize = 200;       // 学生名单分页大小
+    int writerDelayMs = 20;         // 成绩写线程分组提交的最长等待（毫秒）
+    int writerBatch = 0;            // 成绩写线程每次提交的最大条数，0 为按后端取 SqlDialect::batchSize()
+
+    bool isSQLite() const { return driver == "QSQLITE"; }
+    // 读取配置文件；文件不存在时返回缺省配置
+    static DatabaseConfig load(const QString& iniPath);
+};
 
 class DBManager
 {
@@ -20,6 +65,16 @@ public:
 
     // 初始化数据库连接
     bool initDB(const QString& dbPath);
+    bool initDB(const DatabaseConfig& config);
+
+    // 当前后端的方言与连接配置
+    const SqlDialect& dialect() const { return m_dialect; }
+    const DatabaseConfig& config() const { return m_config; }
+    // 并行读取的连接数（SQLite按核数，服务器按连接池大小）
+    int readerConnections() const { return m_dialect.readerConnections(m_config.poolSize); }
+
+    // 当前线程可用的连接：主线程返回 m_db，工作线程按线程克隆独立连接（线程退出时自动移除）
+    QSqlDatabase threadConnection();
 
     // 执行查询语句（返回结果）
     QSqlQuery execQuery(const QString& sql);
@@ -36,6 +91,61 @@ public:
     // 新增：获取最后一次数据库错误信息（解决未定义报错）
     QString getLastError() const { return m_db.lastError().text(); }
 
+    // 全量重建成绩汇总表 score_summary（班级×科目×考试日期，含归档分区）
+    bool rebuildScoreSummary();
+    // 核对 score_summary 与全部成绩的实时聚合，返回不一致的分组行数，失败返回 -1
+    int checkScoreSummary(QString *errorMessage = nullptr);
+    // 归档后汇总一致性检查（会修改数据，只用于测试库或副本）：归档最早的可归档学期，把该学期有成绩的一名学生
+    // 调班并修改一条当前成绩，核对归档学期的汇总行仍在、score_summary 与实时聚合一致；report 为结论或失败原因
+    bool checkArchivedSummary(QString *report);
+    // 全量重建绩点聚合表 gpa_course_terms（学生×科目×学期，含归档分区）
+    bool rebuildGpaTerms();
+    // 数据版本号（db_meta.data_version，students/courses/scores 变更时由触发器递增），不可用时返回 -1
+    qint64 dataVersion();
+
+    // ========== 类型化绑定/读取 ==========
+    // exam_date 以儒略日整数存储（与 QDate::toJulianDay 一致），score 为 REAL
+    static qint64 toDayNumber(const QDate& date) { return date.toJulianDay(); }
+    static QDate fromDayNumber(const QVariant& value) {
+        return value.isNull() ? QDate() : QDate::fromJulianDay(value.toLongLong());
+    }
+    static void bindDate(QSqlQuery& query, const QDate& date) { query.addBindValue(toDayNumber(date)); }
+    static void bindScore(QSqlQuery& query, double score) { query.addBindValue(score); }
+    static QDate dateAt(const QSqlQuery& query, int column) { return fromDayNumber(query.value(column)); }
+    static double scoreAt(const QSqlQuery& query, int column) { return query.value(column).toDouble(); }
+
+    // 日期范围条件（以 " AND " 开头，空日期表示该端不限），值为整数可直接拼入SQL
+    static QString dateRangeSql(const QString& column, const QDate& from, const QDate& to) {
+        QString sql;
+        if (from.isValid()) sql += QString(" AND %1 >= %2").arg(column).arg(toDayNumber(from));
+        if (to.isValid()) sql += QString(" AND %1 <= %2").arg(column).arg(toDayNumber(to));
+        return sql;
+    }
+
+    // ========== 学期分区路由 ==========
+    // 日期所属学期
+    static TermRange termOf(const QDate& date);
+    // 与日期范围有交集的成绩表（主表 + 归档分区），空日期表示不限
+    QStringList scoreTables(const QDate& from = QDate(), const QDate& to = QDate()) const;
+    // 可直接放在 FROM 后的成绩数据源（单表或 UNION ALL 子查询）
+    QString scoreSource(const QDate& from = QDate(), const QDate& to = QDate()) const;
+    // 日期是否落在已归档学期（归档学期不再接受写入）
+    bool isArchivedDate(const QDate& date) const;
+    QList<ScorePartition> partitions() const;
+    // 已结束且主表仍有数据的学期
+    QList<TermRange> archivableTerms();
+    // 归档学期：搬移到分区表 scores_<学期键>
+    bool archiveTerm(const QString& termKey, QString *errorMessage = nullptr);
+
+    // ========== 变更日志与备份 ==========
+    // 在线备份到文件（VACUUM INTO）。在工作线程调用时使用该线程的独立连接，
+    // WAL模式下只占用读事务，不阻塞界面读写
+    bool backupTo(const QString& filePath, QString *errorMessage = nullptr);
+    // 可恢复的最早时间点：最近一次归档之后（归档搬移的数据不在日志中）
+    QDateTime earliestRestorePoint();
+    // 按 score_log 逆序撤销目标时间之后的成绩变更，返回撤销条数，失败返回 -1
+    int restoreToPointInTime(const QDateTime& target, QString *errorMessage = nullptr);
+
 
     QSqlDatabase m_db;
 private:
@@ -47,6 +157,30 @@ private:
     DBManager(const DBManager&) = delete;
     DBManager& operator=(const DBManager&) = delete;
 
+    // 存储格式版本（PRAGMA user_version），用于启动时迁移
+    static const int kSchemaVersion = 2;
+    bool migrateSchema();
+
+    // 建表/建触发器（汇总表等派生结构）
+    bool initSchema();
+    // 汇总表维护触发器：scores 增删改、students 班级变更
+    bool createSummaryTriggers();
+    // 变更日志触发器：scores 增删改追加到 score_log
+    bool createAuditTriggers();
+    // 绩点聚合表维护触发器：scores 增删改
+    bool createGpaTriggers();
+    // 分区登记读入内存 / 重建全分区视图 scores_all
+    bool loadPartitions();
+    bool refreshScoresView();
+    // 核对表结构与编译期描述（schema.h）
+    bool verifySchema();
+
+    // 分区列表可能被工作线程读取，读写都加锁
+    DatabaseConfig m_config;
+    SqlDialect m_dialect;
+
+    mutable QMutex m_partitionMutex;
+    QList<ScorePartition> m_partitions;
 
 };
 
@@ -0,0 +1,145 @@
+#include "gpadialog.h"
+#include "gpasettingsdialog.h"
+#include "authservice.h"
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QLabel>
+#include <QComboBox>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QMessageBox>
+#include <cmath>
+
+namespace {
+
+// 数值单元格：按数值排序，显示保留 precision 位小数
+QTableWidgetItem *numberItem(double value, int precision)
+{
+    QTableWidgetItem *item = new QTableWidgetItem();
+    double scale = std::pow(10.0, precision);
+    item->setData(Qt::DisplayRole, std::round(value * scale) / scale);
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+
+} // namespace
+
+GpaDialog::GpaDialog(const QString& className, QWidget *parent)
+    : QDialog(parent)
+    , m_className(className)
+    , m_cbxTerm(new QComboBox(this))
+    , m_table(new QTableWidget(this))
+    , m_labStatus(new QLabel(this))
+{
+    setWindowTitle(QString("GPA与学期排名（%1）").arg(className.isEmpty() ? QString("全校") : className));
+    resize(960, 620);
+
+    m_table->setColumnCount(11);
+    m_table->setHorizontalHeaderLabels({"班级排名", "全校排名", "学号", "姓名", "班级", "学期GPA", "加权平均分",
+                                        "学期学分", "科目数", "累计GPA", "累计学分"});
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_table->verticalHeader()->setVisible(false);
+    // 默认保持 班级→班级排名 的顺序，点击表头再排序
+    m_table->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+
+    QPushButton *btnSettings = new QPushButton("学分与绩点设置...", this);
+    connect(btnSettings, &QPushButton::clicked, this, &GpaDialog::editSettings);
+
+    QHBoxLayout *top = new QHBoxLayout();
+    top->addWidget(new QLabel("学期：", this));
+    top->addWidget(m_cbxTerm);
+    top->addWidget(m_labStatus, 1);
+    top->addWidget(btnSettings);
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(top);
+    layout->addWidget(m_table);
+
+    QString error;
+    m_terms = GpaEngine::terms(&error);
+    if (!error.isEmpty()) {
+        m_labStatus->setText(error);
+        return;
+    }
+    if (m_terms.isEmpty()) {
+        m_labStatus->setText("暂无成绩");
+        return;
+    }
+    for (const TermRange& term : std::as_const(m_terms)) {
+        m_cbxTerm->addItem(term.label, term.key);
+    }
+    m_cbxTerm->setCurrentIndex(m_terms.size() - 1); // 默认最近一个学期
+
+    connect(&m_watcher, &QFutureWatcher<GpaResult>::finished, this, &GpaDialog::onFinished);
+    connect(m_cbxTerm, &QComboBox::currentIndexChanged, this, &GpaDialog::compute);
+    compute();
+}
+
+GpaDialog::~GpaDialog()
+{
+    // 单条查询无法中途取消，等待其结束后再释放
+    m_watcher.waitForFinished();
+}
+
+void GpaDialog::compute()
+{
+    int index = m_cbxTerm->currentIndex();
+    if (index < 0 || index >= m_terms.size()) return;
+    if (m_watcher.isRunning()) {
+        m_pending = true;
+        return;
+    }
+    m_pending = false;
+    m_labStatus->setText(QString("正在计算 %1 ...").arg(m_terms.at(index).label));
+    m_watcher.setFuture(GpaEngine::start(m_terms.at(index), m_className));
+}
+
+void GpaDialog::onFinished()
+{
+    if (m_pending) {
+        compute();
+        return;
+    }
+    GpaResult result = m_watcher.result();
+    if (!result.error.isEmpty()) {
+        m_labStatus->setText(result.error);
+        return;
+    }
+
+    m_table->setSortingEnabled(false);
+    m_table->setUpdatesEnabled(false);
+    m_table->setRowCount(result.rows.size());
+    for (int row = 0; row < result.rows.size(); row++) {
+        const GpaRow& gpa = result.rows.at(row);
+        m_table->setItem(row, 0, numberItem(gpa.classRank, 0));
+        m_table->setItem(row, 1, numberItem(gpa.schoolRank, 0));
+        m_table->setItem(row, 2, new QTableWidgetItem(QString::number(gpa.studentId)));
+        m_table->setItem(row, 3, new QTableWidgetItem(gpa.studentName));
+        m_table->setItem(row, 4, new QTableWidgetItem(gpa.className));
+        m_table->setItem(row, 5, numberItem(gpa.termGpa, 2));
+        m_table->setItem(row, 6, numberItem(gpa.termAverage, 1));
+        m_table->setItem(row, 7, numberItem(gpa.termCredits, 1));
+        m_table->setItem(row, 8, numberItem(gpa.termCourses, 0));
+        m_table->setItem(row, 9, numberItem(gpa.cumulativeGpa, 2));
+        m_table->setItem(row, 10, numberItem(gpa.cumulativeCredits, 1));
+    }
+    m_table->setUpdatesEnabled(true);
+    m_table->setSortingEnabled(true);
+    m_table->resizeColumnsToContents();
+
+    m_labStatus->setText(QString("%1：%2 名学生，计算耗时 %3 ms")
+                             .arg(result.term.label).arg(result.rows.size()).arg(result.elapsedMs));
+}
+
+void GpaDialog::editSettings()
+{
+    if (!AuthService::getInstance().currentSession().isAdmin()) {
+        QMessageBox::warning(this, "提示", "仅管理员可以修改学分与绩点对照！");
+        return;
+    }
+    GpaSettingsDialog dialog(this);
+    if (dialog.exec() == QDialog::Accepted) {
+        compute();
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef GPADIALOG_H
+#define GPADIALOG_H
+
+#include <QDialog>
+#include <QFutureWatcher>
+#include "gpaengine.h"
+
+class QTableWidget;
+class QLabel;
+class QComboBox;
+
+// GPA 与学期排名：按学期列出学期 GPA、加权平均分、累计 GPA 及班级/全校名次（后台计算）
+class GpaDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    // className 为空时显示全校
+    explicit GpaDialog(const QString& className, QWidget *parent = nullptr);
+    ~GpaDialog() override;
+
+private slots:
+    void compute();
+    void onFinished();
+    void editSettings();
+
+private:
+    QString m_className;
+    QComboBox *m_cbxTerm;
+    QTableWidget *m_table;
+    QLabel *m_labStatus;
+    QList<TermRange> m_terms;
+    QFutureWatcher<GpaResult> m_watcher;
+    bool m_pending = false;     // 计算期间又切换了学期，完成后重算
+};
+
+#endif // GPADIALOG_H
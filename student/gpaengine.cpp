@@ -0,0 +1,251 @@
+#include "gpaengine.h"
+#include "schema.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSet>
+#include <QtConcurrent>
+#include <algorithm>
+
+namespace {
+
+// 排名键：学期 GPA，其次加权平均分（均保留4位小数比较，避免浮点误差拆开并列）
+bool rankedBefore(const GpaRow& a, const GpaRow& b)
+{
+    qint64 gpaA = qRound64(a.termGpa * 10000), gpaB = qRound64(b.termGpa * 10000);
+    if (gpaA != gpaB) return gpaA > gpaB;
+    return qRound64(a.termAverage * 10000) > qRound64(b.termAverage * 10000);
+}
+
+// 不支持窗口函数的后端：在内存中按全校、班级分别排名（并列同名次，后续名次跳过）
+void assignRanks(QVector<GpaRow>& rows)
+{
+    std::sort(rows.begin(), rows.end(), rankedBefore);
+    for (int i = 0; i < rows.size(); i++) {
+        rows[i].schoolRank = (i > 0 && !rankedBefore(rows[i - 1], rows[i])) ? rows[i - 1].schoolRank : i + 1;
+    }
+    QHash<QString, QPair<int, const GpaRow *>> classState; // 班级 -> 已排人数、上一名
+    for (GpaRow& row : rows) {
+        QPair<int, const GpaRow *>& state = classState[row.className];
+        state.first++;
+        row.classRank = (state.second && !rankedBefore(*state.second, row)) ? state.second->classRank : state.first;
+        state.second = &row;
+    }
+}
+
+// GPA 查询的结果列（compute 的 SELECT 按此顺序输出，排名两列只在支持窗口函数时存在）
+struct GpaColumns {
+    enum Column { StudentId, StudentName, ClassName, TermGpa, TermAverage, TermCredits, TermCourses,
+                  CumulativeGpa, CumulativeCredits, ClassRank, SchoolRank };
+
+    static GpaRow read(const QSqlQuery& query, bool withRanks)
+    {
+        GpaRow row;
+        row.studentId = query.value(StudentId).toLongLong();
+        row.studentName = query.value(StudentName).toString();
+        row.className = query.value(ClassName).toString();
+        row.termGpa = query.value(TermGpa).toDouble();
+        row.termAverage = query.value(TermAverage).toDouble();
+        row.termCredits = query.value(TermCredits).toDouble();
+        row.termCourses = query.value(TermCourses).toInt();
+        row.cumulativeGpa = query.value(CumulativeGpa).toDouble();
+        row.cumulativeCredits = query.value(CumulativeCredits).toDouble();
+        if (withRanks) {
+            row.classRank = query.value(ClassRank).toInt();
+            row.schoolRank = query.value(SchoolRank).toInt();
+        }
+        return row;
+    }
+};
+
+} // namespace
+
+QList<TermRange> GpaEngine::terms(QString *errorMessage)
+{
+    QList<TermRange> terms;
+    QSqlQuery query(DBManager::getInstance().threadConnection());
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT DISTINCT term_first FROM gpa_course_terms ORDER BY term_first")) {
+        if (errorMessage) *errorMessage = "查询学期失败：" + query.lastError().text();
+        return terms;
+    }
+    while (query.next()) {
+        terms.append(DBManager::termOf(DBManager::dateAt(query, 0)));
+    }
+    return terms;
+}
+
+QFuture<GpaResult> GpaEngine::start(const TermRange& term, const QString& className)
+{
+    return QtConcurrent::run(&GpaEngine::compute, term, className);
+}
+
+GpaResult GpaEngine::compute(const TermRange& term, const QString& className)
+{
+    QElapsedTimer timer;
+    timer.start();
+    GpaResult result;
+    result.term = term;
+
+    DBManager& db = DBManager::getInstance();
+    bool windowRanks = db.dialect().supportsWindowFunctions();
+    qint64 termDay = DBManager::toDayNumber(term.first);
+
+    // 科目成绩 -> 绩点：对照表只有十来档，展开为 CASE 表达式，比逐行关联子查询快一倍以上
+    QString error;
+    const QList<GradePoint> scale = gradeScale(&error);
+    if (!error.isEmpty()) {
+        result.error = error;
+        return result;
+    }
+    QString pointsExpr;
+    for (const GradePoint& grade : scale) {
+        pointsExpr += QString(" WHEN g.total / g.cnt >= %1 THEN %2").arg(grade.minScore).arg(grade.points);
+    }
+    pointsExpr = pointsExpr.isEmpty() ? QString("0") : QString("CASE%1 ELSE 0 END").arg(pointsExpr);
+
+    // 学分为0的科目不计入；输出列序与 GpaColumns 一致
+    QString inTerm = QString("term_first = %1").arg(termDay);
+    QString sql = QString(
+                      "WITH course_grades AS ("
+                      "SELECT g.student_id, g.term_first, c.credit, g.total / g.cnt AS grade, %3 AS points "
+                      "FROM gpa_course_terms g JOIN courses c ON c.course_id = g.course_id "
+                      "WHERE g.term_first <= %1 AND c.credit > 0), "
+                      "student_gpa AS ("
+                      "SELECT student_id, "
+                      "SUM(CASE WHEN %2 THEN credit * points END) / SUM(CASE WHEN %2 THEN credit END) AS term_gpa, "
+                      "SUM(CASE WHEN %2 THEN credit * grade END) / SUM(CASE WHEN %2 THEN credit END) AS term_avg, "
+                      "SUM(CASE WHEN %2 THEN credit END) AS term_credits, "
+                      "SUM(CASE WHEN %2 THEN 1 ELSE 0 END) AS term_courses, "
+                      "SUM(credit * points) / SUM(credit) AS cum_gpa, SUM(credit) AS cum_credits "
+                      "FROM course_grades GROUP BY student_id "
+                      "HAVING SUM(CASE WHEN %2 THEN 1 ELSE 0 END) > 0) "
+                      "SELECT s.student_id, st.student_name, COALESCE(st.class_name, '') AS class_name, "
+                      "s.term_gpa, s.term_avg, s.term_credits, s.term_courses, s.cum_gpa, s.cum_credits")
+                      .arg(termDay).arg(inTerm, pointsExpr);
+    if (windowRanks) {
+        // 与 rankedBefore 相同的排名键；排名按全校数据计算后再按班级筛选
+        QString rankOrder = "ORDER BY ROUND(s.term_gpa * 10000) DESC, ROUND(s.term_avg * 10000) DESC";
+        sql += QString(", RANK() OVER (PARTITION BY COALESCE(st.class_name, '') %1) AS class_rank, "
+                       "RANK() OVER (%1) AS school_rank").arg(rankOrder);
+    }
+    sql += " FROM student_gpa s JOIN students st ON st.student_id = s.student_id";
+    if (windowRanks) {
+        sql = QString("SELECT * FROM (%1) ranked%2 ORDER BY class_name, class_rank, student_id")
+                  .arg(sql, className.isEmpty() ? QString() : QString(" WHERE class_name = ?"));
+    }
+
+    QSqlQuery query(db.threadConnection());
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    if (windowRanks && !className.isEmpty()) query.addBindValue(className);
+    if (!query.exec()) {
+        result.error = "计算GPA失败：" + query.lastError().text();
+        return result;
+    }
+    while (query.next()) {
+        result.rows.append(GpaColumns::read(query, windowRanks));
+    }
+    if (query.lastError().isValid()) {
+        result.error = "读取GPA失败：" + query.lastError().text();
+        return result;
+    }
+
+    if (!windowRanks) {
+        assignRanks(result.rows);
+        if (!className.isEmpty()) {
+            result.rows.erase(std::remove_if(result.rows.begin(), result.rows.end(),
+                                             [&](const GpaRow& row) { return row.className != className; }),
+                              result.rows.end());
+        }
+        std::stable_sort(result.rows.begin(), result.rows.end(), [](const GpaRow& a, const GpaRow& b) {
+            return a.className != b.className ? a.className < b.className : a.classRank < b.classRank;
+        });
+    }
+    result.elapsedMs = timer.elapsed();
+    return result;
+}
+
+// ========== 学分与绩点对照 ==========
+QList<GradePoint> GpaEngine::gradeScale(QString *errorMessage)
+{
+    using Schema::GradePoints;
+
+    QList<GradePoint> scale;
+    QSqlQuery query(DBManager::getInstance().threadConnection());
+    if (!query.exec(Schema::SelectAll<GradePoints>::sql() + " ORDER BY "
+                    + Schema::columnName<GradePoints>(GradePoints::MinScore) + " DESC")) {
+        if (errorMessage) *errorMessage = "读取绩点对照失败：" + query.lastError().text();
+        return scale;
+    }
+    while (query.next()) {
+        GradePoints::Row grade = GradePoints::read(query);
+        scale.append({grade.minScore, grade.points, grade.label});
+    }
+    return scale;
+}
+
+QList<CourseCredit> GpaEngine::courseCredits(QString *errorMessage)
+{
+    using Schema::Courses;
+    using CreditColumns = Schema::Select<Courses, Courses::CourseId, Courses::CourseName, Courses::Credit>;
+
+    QList<CourseCredit> credits;
+    QSqlQuery query(DBManager::getInstance().threadConnection());
+    if (!query.exec(CreditColumns::sql() + " ORDER BY " + Schema::columnName<Courses>(Courses::CourseId))) {
+        if (errorMessage) *errorMessage = "读取科目学分失败：" + query.lastError().text();
+        return credits;
+    }
+    while (query.next()) {
+        credits.append({query.value(CreditColumns::at<Courses::CourseId>()).toInt(),
+                        query.value(CreditColumns::at<Courses::CourseName>()).toString(),
+                        query.value(CreditColumns::at<Courses::Credit>()).toDouble()});
+    }
+    return credits;
+}
+
+bool GpaEngine::saveSettings(const QList<CourseCredit>& credits, const QList<GradePoint>& scale,
+                             QString *errorMessage)
+{
+    auto fail = [errorMessage](const QString& message) {
+        if (errorMessage) *errorMessage = message;
+        return false;
+    };
+
+    // 先校验两张表，全部通过后再在同一事务里写入
+    for (const CourseCredit& course : credits) {
+        if (course.credit < 0) return fail(QString("科目【%1】的学分不能为负").arg(course.courseName));
+    }
+    if (scale.isEmpty()) return fail("绩点对照至少需要一档");
+    QSet<qint64> lines;
+    for (const GradePoint& grade : scale) {
+        if (grade.minScore < 0 || grade.minScore > 100) return fail(QString("分数线 %1 超出 0~100").arg(grade.minScore));
+        if (grade.points < 0) return fail(QString("分数线 %1 的绩点不能为负").arg(grade.minScore));
+        qint64 line = qRound64(grade.minScore * 100);
+        if (lines.contains(line)) return fail(QString("分数线 %1 重复").arg(grade.minScore));
+        lines.insert(line);
+    }
+
+    QSqlDatabase connection = DBManager::getInstance().threadConnection();
+    if (!connection.transaction()) return fail("开启事务失败：" + connection.lastError().text());
+    QSqlQuery query(connection);
+    bool ok = query.prepare("UPDATE courses SET credit = ? WHERE course_id = ?");
+    for (int i = 0; ok && i < credits.size(); i++) {
+        query.addBindValue(credits.at(i).credit);
+        query.addBindValue(credits.at(i).courseId);
+        ok = query.exec();
+    }
+    ok = ok && query.exec("DELETE FROM " + Schema::tableName<Schema::GradePoints>());
+    ok = ok && query.prepare(Schema::SelectAll<Schema::GradePoints>::insertSql());
+    for (int i = 0; ok && i < scale.size(); i++) {
+        query.addBindValue(scale.at(i).minScore);
+        query.addBindValue(scale.at(i).points);
+        query.addBindValue(scale.at(i).label);
+        ok = query.exec();
+    }
+    if (!ok) {
+        QString error = query.lastError().text();
+        connection.rollback();
+        return fail("保存学分与绩点对照失败：" + error);
+    }
+    return connection.commit() || fail("提交失败：" + connection.lastError().text());
+}
@@ -0,0 +1,67 @@
+#ifndef GPAENGINE_H
+#define GPAENGINE_H
+
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QFuture>
+#include "dbmanager.h"
+
+// 绩点对照：科目成绩不低于 minScore 时取 points
+struct GradePoint {
+    double minScore = 0;
+    double points = 0;
+    QString label;
+};
+
+// 科目学分
+struct CourseCredit {
+    int courseId = -1;
+    QString courseName;
+    double credit = 1;
+};
+
+// 一名学生在某学期的 GPA 与排名（科目成绩为该学期内各次考试的平均分）
+struct GpaRow {
+    qint64 studentId = 0;
+    QString studentName;
+    QString className;
+    double termGpa = 0;            // 学期 GPA（学分加权）
+    double termAverage = 0;        // 学期加权平均分
+    double termCredits = 0;        // 学期修读学分
+    int termCourses = 0;
+    double cumulativeGpa = 0;      // 截至该学期（含）的累计 GPA
+    double cumulativeCredits = 0;
+    int classRank = 0;             // 按 学期GPA、加权平均分 排名，并列同名次
+    int schoolRank = 0;
+};
+
+struct GpaResult {
+    TermRange term;
+    QVector<GpaRow> rows;          // 按 班级、班级排名 排列
+    qint64 elapsedMs = 0;
+    QString error;
+};
+
+// GPA 与学期排名：成绩写入时由触发器增量维护 gpa_course_terms（学生×科目×学期 的成绩数与总分），
+// 查询时一条集合语句关联学分（courses.credit）与绩点对照（grade_points）算出学期/累计 GPA，
+// 排名用窗口函数（后端不支持时在内存中排序）。修改学分或对照表后下次查询即生效。
+class GpaEngine
+{
+public:
+    // 有成绩的学期，按时间先后
+    static QList<TermRange> terms(QString *errorMessage = nullptr);
+    // 应在工作线程调用；className 为空时返回全校（排名始终按全校数据计算）
+    static GpaResult compute(const TermRange& term, const QString& className);
+    static QFuture<GpaResult> start(const TermRange& term, const QString& className);
+
+    // ========== 学分与绩点对照 ==========
+    static QList<GradePoint> gradeScale(QString *errorMessage = nullptr);
+    static QList<CourseCredit> courseCredits(QString *errorMessage = nullptr);
+    // 在同一事务中保存学分并整体替换对照表；学分不能为负，对照表至少一档、分数线在 0~100 之间且不重复，
+    // 任一项不合法时什么都不写
+    static bool saveSettings(const QList<CourseCredit>& credits, const QList<GradePoint>& scale,
+                             QString *errorMessage = nullptr);
+};
+
+#endif // GPAENGINE_H
@@ -0,0 +1,137 @@
+#include "gpasettingsdialog.h"
+#include "gpaengine.h"
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QDialogButtonBox>
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QMessageBox>
+
+GpaSettingsDialog::GpaSettingsDialog(QWidget *parent)
+    : QDialog(parent)
+    , m_credits(new QTableWidget(this))
+    , m_scale(new QTableWidget(this))
+{
+    setWindowTitle("学分与绩点设置");
+    resize(720, 480);
+
+    m_credits->setColumnCount(2);
+    m_credits->setHorizontalHeaderLabels({"科目", "学分"});
+    m_credits->verticalHeader()->setVisible(false);
+    m_credits->horizontalHeader()->setStretchLastSection(true);
+    m_scale->setColumnCount(3);
+    m_scale->setHorizontalHeaderLabels({"分数线（不低于）", "绩点", "等级"});
+    m_scale->verticalHeader()->setVisible(false);
+    m_scale->horizontalHeader()->setStretchLastSection(true);
+
+    QPushButton *btnAdd = new QPushButton("添加一档", this);
+    QPushButton *btnRemove = new QPushButton("删除所选", this);
+    connect(btnAdd, &QPushButton::clicked, this, [this]() {
+        int row = m_scale->rowCount();
+        m_scale->insertRow(row);
+        m_scale->setItem(row, 0, new QTableWidgetItem("0"));
+        m_scale->setItem(row, 1, new QTableWidgetItem("0"));
+        m_scale->setItem(row, 2, new QTableWidgetItem());
+        m_scale->editItem(m_scale->item(row, 0));
+    });
+    connect(btnRemove, &QPushButton::clicked, this, [this]() {
+        if (m_scale->currentRow() >= 0) m_scale->removeRow(m_scale->currentRow());
+    });
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Save | QDialogButtonBox::Cancel, this);
+    connect(buttons, &QDialogButtonBox::accepted, this, &GpaSettingsDialog::save);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+    QHBoxLayout *scaleButtons = new QHBoxLayout();
+    scaleButtons->addStretch();
+    scaleButtons->addWidget(btnAdd);
+    scaleButtons->addWidget(btnRemove);
+    QGridLayout *layout = new QGridLayout(this);
+    layout->addWidget(new QLabel("科目学分（0 学分不计入 GPA）", this), 0, 0);
+    layout->addWidget(new QLabel("绩点对照（科目成绩取学期内各次考试平均分）", this), 0, 1);
+    layout->addWidget(m_credits, 1, 0);
+    layout->addWidget(m_scale, 1, 1);
+    layout->addLayout(scaleButtons, 2, 1);
+    layout->addWidget(buttons, 3, 0, 1, 2);
+
+    load();
+}
+
+void GpaSettingsDialog::load()
+{
+    QString error;
+    const QList<CourseCredit> credits = GpaEngine::courseCredits(&error);
+    const QList<GradePoint> scale = GpaEngine::gradeScale(&error);
+    if (!error.isEmpty()) {
+        QMessageBox::critical(this, "错误", error);
+        return;
+    }
+
+    m_credits->setRowCount(credits.size());
+    for (int row = 0; row < credits.size(); row++) {
+        QTableWidgetItem *name = new QTableWidgetItem(credits.at(row).courseName);
+        name->setFlags(name->flags() & ~Qt::ItemIsEditable);
+        name->setData(Qt::UserRole, credits.at(row).courseId);
+        m_credits->setItem(row, 0, name);
+        m_credits->setItem(row, 1, new QTableWidgetItem(QString::number(credits.at(row).credit)));
+    }
+    m_scale->setRowCount(scale.size());
+    for (int row = 0; row < scale.size(); row++) {
+        m_scale->setItem(row, 0, new QTableWidgetItem(QString::number(scale.at(row).minScore)));
+        m_scale->setItem(row, 1, new QTableWidgetItem(QString::number(scale.at(row).points)));
+        m_scale->setItem(row, 2, new QTableWidgetItem(scale.at(row).label));
+    }
+    m_credits->resizeColumnsToContents();
+    m_scale->resizeColumnsToContents();
+}
+
+void GpaSettingsDialog::save()
+{
+    auto number = [](QTableWidget *table, int row, int column, bool *ok) {
+        QTableWidgetItem *item = table->item(row, column);
+        if (!item) {
+            *ok = false;
+            return 0.0;
+        }
+        return item->text().trimmed().toDouble(ok);
+    };
+
+    QList<CourseCredit> credits;
+    for (int row = 0; row < m_credits->rowCount(); row++) {
+        CourseCredit course;
+        course.courseId = m_credits->item(row, 0)->data(Qt::UserRole).toInt();
+        course.courseName = m_credits->item(row, 0)->text();
+        bool ok = false;
+        course.credit = number(m_credits, row, 1, &ok);
+        if (!ok) {
+            QMessageBox::warning(this, "提示", QString("科目【%1】的学分不是有效数字！").arg(course.courseName));
+            return;
+        }
+        credits.append(course);
+    }
+
+    QList<GradePoint> scale;
+    for (int row = 0; row < m_scale->rowCount(); row++) {
+        GradePoint grade;
+        bool minOk = false;
+        bool pointsOk = false;
+        grade.minScore = number(m_scale, row, 0, &minOk);
+        grade.points = number(m_scale, row, 1, &pointsOk);
+        if (!minOk || !pointsOk) {
+            QMessageBox::warning(this, "提示", QString("绩点对照第 %1 行不是有效数字！").arg(row + 1));
+            return;
+        }
+        QTableWidgetItem *label = m_scale->item(row, 2);
+        grade.label = label ? label->text().trimmed() : QString();
+        scale.append(grade);
+    }
+
+    QString error;
+    if (!GpaEngine::saveSettings(credits, scale, &error)) {
+        QMessageBox::critical(this, "错误", error);
+        return;
+    }
+    accept();
+}
@@ -0,0 +1,26 @@
+#ifndef GPASETTINGSDIALOG_H
+#define GPASETTINGSDIALOG_H
+
+#include <QDialog>
+
+class QTableWidget;
+
+// 学分与绩点对照设置（管理员）：左侧各科目学分，右侧 分数线→绩点 对照表
+class GpaSettingsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit GpaSettingsDialog(QWidget *parent = nullptr);
+
+private slots:
+    void save();
+
+private:
+    void load();
+
+    QTableWidget *m_credits;
+    QTableWidget *m_scale;
+};
+
+#endif // GPASETTINGSDIALOG_H
@@ -0,0 +1,523 @@
+#include "loadtest.h"
+#include "dbmanager.h"
+#include "schema.h"
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QJsonArray>
+#include <QHash>
+#include <QVector>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+
+namespace {
+
+enum class OpStatus { Ok, Busy, Error };
+
+// SQLITE_BUSY(5) / SQLITE_LOCKED(6)，扩展错误码取低8位
+bool isBusy(const QSqlError& error)
+{
+    int code = error.nativeErrorCode().toInt() & 0xff;
+    return code == 5 || code == 6;
+}
+
+OpStatus failWith(const QSqlError& error, QString *errorMessage)
+{
+    if (isBusy(error)) return OpStatus::Busy;
+    if (errorMessage) *errorMessage = error.text();
+    return OpStatus::Error;
+}
+
+// 各客户端共用的只读数据：学生/班级/科目（随机挑选操作参数）
+struct Dictionary {
+    QVector<qint64> studentIds;
+    QStringList classNames;
+    QVector<int> courseIds;
+    QStringList courseNames;
+};
+
+struct ClientContext {
+    const LoadTestOptions *options;
+    const Dictionary *dictionary;
+    QRandomGenerator rng;
+};
+
+QString pickOp(const QMap<QString, int>& mix, QRandomGenerator& rng)
+{
+    int total = 0;
+    for (int weight : mix) total += weight;
+    int roll = int(rng.bounded(quint32(qMax(1, total))));
+    for (auto it = mix.cbegin(); it != mix.cend(); ++it) {
+        if (roll < it.value()) return it.key();
+        roll -= it.value();
+    }
+    return mix.firstKey();
+}
+
+// 录入日期：最近30天内（未归档学期）
+QDate recentExamDate(QRandomGenerator& rng)
+{
+    QDate date = QDate::currentDate().addDays(-int(rng.bounded(30u)));
+    return DBManager::getInstance().isArchivedDate(date) ? QDate::currentDate() : date;
+}
+
+double randomScore(QRandomGenerator& rng)
+{
+    // 两个均匀分布相加，集中在 70 分附近
+    return std::round(40 + rng.bounded(31.0) + rng.bounded(30.0));
+}
+
+// ========== 读操作 ==========
+// 统计页：按 班级/科目 模糊筛选汇总 score_summary（与 ScoreStatWidget::statScores 同一语句）
+OpStatus runStats(QSqlDatabase db, ClientContext& ctx, QString *errorMessage)
+{
+    const Dictionary& dict = *ctx.dictionary;
+    QString sql = "SELECT SUM(cnt), SUM(total), SUM(total_sq), MIN(min_score), MAX(max_score) "
+                  "FROM score_summary WHERE 1 = 1";
+    QVariantList binds;
+    int filter = int(ctx.rng.bounded(3u)); // 0 只按班级，1 只按科目，2 两者
+    if (filter != 1 && !dict.classNames.isEmpty()) {
+        sql += " AND class_name LIKE ?";
+        binds << QString("%%1%").arg(dict.classNames.at(int(ctx.rng.bounded(quint32(dict.classNames.size())))));
+    }
+    if (filter != 0 && !dict.courseNames.isEmpty()) {
+        sql += " AND course_id IN (SELECT course_id FROM courses WHERE course_name LIKE ?)";
+        binds << QString("%%1%").arg(dict.courseNames.at(int(ctx.rng.bounded(quint32(dict.courseNames.size())))));
+    }
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    for (const QVariant& value : binds) query.addBindValue(value);
+    if (!query.exec()) return failWith(query.lastError(), errorMessage);
+    while (query.next()) {}
+    return OpStatus::Ok;
+}
+
+// 图表页：个人某科目趋势（与 ScoreChartWidget 个人趋势同一语句，不限日期）
+OpStatus runChart(QSqlDatabase db, ClientContext& ctx, QString *errorMessage)
+{
+    const Dictionary& dict = *ctx.dictionary;
+    if (dict.studentIds.isEmpty() || dict.courseIds.isEmpty()) return OpStatus::Ok;
+    QString sql = QString(R"(
+        WITH src AS (
+            SELECT sc.exam_date AS d, sc.score AS s
+            FROM %1 sc
+            WHERE sc.student_id = ? AND sc.course_id = ?
+            AND sc.score >= 0 AND sc.score <= 100
+        ),
+        ext AS (SELECT MIN(d) AS lo, MAX(d) AS hi FROM src)
+        SELECT MIN(src.d), AVG(src.s)
+        FROM src, ext
+        GROUP BY (src.d - ext.lo) * ? / (ext.hi - ext.lo + 1)
+        ORDER BY 1 ASC
+    )").arg(DBManager::getInstance().scoreSource());
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    query.addBindValue(dict.studentIds.at(int(ctx.rng.bounded(quint32(dict.studentIds.size())))));
+    query.addBindValue(dict.courseIds.at(int(ctx.rng.bounded(quint32(dict.courseIds.size())))));
+    query.addBindValue(400); // 绘图区可容纳的点数量级
+    if (!query.exec()) return failWith(query.lastError(), errorMessage);
+    while (query.next()) {}
+    return OpStatus::Ok;
+}
+
+// ========== 写操作 ==========
+// 单条录入：事务内查重 + 插入（与 ScoreWriter 单条请求一致）；批量录入：一个事务插入一批（不查重）
+OpStatus runInsert(QSqlDatabase db, ClientContext& ctx, int count, bool rejectDuplicate,
+                   qint64 *rowsWritten, QString *errorMessage)
+{
+    using Schema::Scores;
+    const Dictionary& dict = *ctx.dictionary;
+    if (dict.studentIds.isEmpty() || dict.courseIds.isEmpty()) return OpStatus::Ok;
+
+    if (!db.transaction()) return failWith(db.lastError(), errorMessage);
+    auto abort = [&](const QSqlError& error) {
+        db.rollback();
+        return failWith(error, errorMessage);
+    };
+
+    QSqlQuery checkQuery(db);
+    checkQuery.prepare(QString("SELECT 1 FROM %1 WHERE %2 = ? AND %3 = ? AND %4 = ?")
+                           .arg(Schema::tableName<Scores>(), Schema::columnName<Scores>(Scores::StudentId),
+                                Schema::columnName<Scores>(Scores::CourseId), Schema::columnName<Scores>(Scores::ExamDate)));
+    QSqlQuery insertQuery(db);
+    insertQuery.prepare(Schema::Select<Scores, Scores::StudentId, Scores::CourseId, Scores::Score, Scores::ExamDate>::insertSql());
+
+    qint64 written = 0;
+    // 批量录入为同一班级、同一科目、同一考试日期的一批学生
+    int courseId = dict.courseIds.at(int(ctx.rng.bounded(quint32(dict.courseIds.size()))));
+    QDate examDate = recentExamDate(ctx.rng);
+    for (int i = 0; i < count; i++) {
+        qint64 studentId = dict.studentIds.at(int(ctx.rng.bounded(quint32(dict.studentIds.size()))));
+        if (rejectDuplicate) {
+            checkQuery.addBindValue(studentId);
+            checkQuery.addBindValue(courseId);
+            DBManager::bindDate(checkQuery, examDate);
+            if (!checkQuery.exec()) return abort(checkQuery.lastError());
+            bool duplicate = checkQuery.next();
+            checkQuery.finish();
+            if (duplicate) continue; // 界面会提示成绩已存在，同样算一次完成的操作
+        }
+        insertQuery.addBindValue(studentId);
+        insertQuery.addBindValue(courseId);
+        DBManager::bindScore(insertQuery, randomScore(ctx.rng));
+        DBManager::bindDate(insertQuery, examDate);
+        if (!insertQuery.exec()) return abort(insertQuery.lastError());
+        written++;
+    }
+    if (!db.commit()) return abort(db.lastError());
+    *rowsWritten = written;
+    return OpStatus::Ok;
+}
+
+// ========== 客户端线程 ==========
+struct ClientResult {
+    QHash<QString, LoadTestOpStats> ops;
+    QString firstError;
+};
+
+void runClient(ClientContext ctx, bool writer, const std::atomic<bool>& stop, ClientResult *result)
+{
+    const LoadTestOptions& options = *ctx.options;
+    QSqlDatabase db = DBManager::getInstance().threadConnection();
+    if (!db.isOpen()) {
+        result->firstError = "连接失败：" + db.lastError().text();
+        return;
+    }
+
+    while (!stop.load(std::memory_order_relaxed)) {
+        QString op = pickOp(writer ? options.writeMix : options.readMix, ctx.rng);
+        LoadTestOpStats& stats = result->ops[op];
+        stats.name = op;
+
+        QElapsedTimer timer;
+        timer.start();
+        OpStatus status = OpStatus::Error;
+        QString error;
+        qint64 rows = 0;
+        int retries = 0;
+        forever {
+            if (op == "stats") {
+                status = runStats(db, ctx, &error);
+            } else if (op == "chart") {
+                status = runChart(db, ctx, &error);
+            } else if (op == "single") {
+                status = runInsert(db, ctx, 1, true, &rows, &error);
+            } else {
+                status = runInsert(db, ctx, options.batchSize, false, &rows, &error);
+            }
+            if (status != OpStatus::Busy || retries >= options.maxRetries) break;
+            // 指数退避（1ms 起，最长 64ms）加随机抖动，避免各客户端同时重试
+            retries++;
+            QThread::usleep((1000u << qMin(retries - 1, 6)) + ctx.rng.bounded(1000u));
+        }
+
+        stats.busyRetries += retries;
+        if (status == OpStatus::Ok) {
+            stats.ok++;
+            stats.rows += rows;
+            stats.latenciesUs.push_back(timer.nsecsElapsed() / 1000);
+        } else {
+            stats.failed++;
+            if (result->firstError.isEmpty()) {
+                result->firstError = status == OpStatus::Busy ? QString("%1：重试 %2 次后仍被锁定").arg(op).arg(retries)
+                                                              : QString("%1：%2").arg(op, error);
+            }
+        }
+        if (options.thinkMs > 0) {
+            QThread::msleep(options.thinkMs / 2 + ctx.rng.bounded(quint32(options.thinkMs)));
+        }
+    }
+}
+
+qint64 walSize(const QString& databasePath)
+{
+    QFileInfo wal(databasePath + "-wal");
+    return wal.exists() ? wal.size() : 0;
+}
+
+qint64 scoreCount()
+{
+    QSqlQuery query = DBManager::getInstance().execQuery("SELECT COUNT(*) FROM scores");
+    return query.next() ? query.value(0).toLongLong() : -1;
+}
+
+// ========== 生成测试库 ==========
+bool generateDatabase(const LoadTestOptions& options, QString *errorMessage)
+{
+    const QString connectionName = "loadtest_setup";
+    bool ok = false;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        db.setDatabaseName(options.databasePath);
+        if (!db.open()) {
+            if (errorMessage) *errorMessage = "创建测试库失败：" + db.lastError().text();
+        } else {
+            QSqlQuery query(db);
+            auto exec = [&](const QString& sql) {
+                if (query.exec(sql)) return true;
+                if (errorMessage) *errorMessage = QString("%1：%2").arg(sql, query.lastError().text());
+                return false;
+            };
+            // 表结构与 studentdb.db 一致，成绩表已是 v1 存储格式（儒略日 + REAL）
+            ok = exec("CREATE TABLE \"students\" (\"student_id\" integer NOT NULL, \"student_name\" text NOT NULL, "
+                      "\"class_name\" text NOT NULL, \"gender\" text, PRIMARY KEY (\"student_id\"))")
+                 && exec("CREATE TABLE \"courses\" (\"course_id\" integer NOT NULL, \"course_name\" text(50) NOT NULL, "
+                         "\"course_type\" text(20), PRIMARY KEY (\"course_id\"))")
+                 && exec("CREATE TABLE \"scores\" (\"score_id\" integer NOT NULL, \"score\" REAL NOT NULL, "
+                         "\"exam_date\" INTEGER NOT NULL, \"student_id\" integer NOT NULL, \"course_id\" INTEGER, "
+                         "PRIMARY KEY (\"score_id\"), "
+                         "CONSTRAINT \"fk_scores_students_1\" FOREIGN KEY (\"student_id\") REFERENCES \"students\" (\"student_id\"), "
+                         "CONSTRAINT \"fk_scores_courses_2\" FOREIGN KEY (\"course_id\") REFERENCES \"courses\" (\"course_id\"))")
+                 && exec("CREATE TABLE \"users\" (\"user_id\" INTEGER NOT NULL, \"password\" text, \"username\" text, "
+                         "\"user_type\" text, PRIMARY KEY (\"user_id\"))")
+                 && exec("PRAGMA user_version = 1")
+                 && db.transaction();
+
+            QRandomGenerator rng(options.seed);
+            static const QStringList kSurnames{"王", "李", "张", "刘", "陈", "杨", "黄", "赵", "吴", "周", "徐", "孙", "马", "朱", "胡", "郭"};
+            static const QStringList kGivenNames{"伟", "芳", "娜", "敏", "静", "磊", "洋", "勇", "艳", "杰", "娟", "涛", "明", "超", "霞", "平"};
+            static const QStringList kCourses{"语文", "数学", "英语", "物理", "化学", "生物", "历史", "地理", "政治", "音乐", "美术", "体育"};
+
+            if (ok) {
+                query.prepare("INSERT INTO students (student_id, student_name, class_name, gender) VALUES (?, ?, ?, ?)");
+                for (int i = 1; ok && i <= options.students; i++) {
+                    query.addBindValue(i);
+                    query.addBindValue(kSurnames.at(int(rng.bounded(quint32(kSurnames.size()))))
+                                       + kGivenNames.at(int(rng.bounded(quint32(kGivenNames.size()))))
+                                       + (rng.bounded(2u) ? kGivenNames.at(int(rng.bounded(quint32(kGivenNames.size())))) : QString()));
+                    query.addBindValue(QString("测试%1班").arg((i - 1) % qMax(1, options.classes) + 1, 2, 10, QChar('0')));
+                    query.addBindValue(rng.bounded(2u) ? "男" : "女");
+                    ok = query.exec();
+                }
+            }
+            if (ok) {
+                query.prepare("INSERT INTO courses (course_id, course_name, course_type) VALUES (?, ?, ?)");
+                for (int i = 1; ok && i <= options.courses; i++) {
+                    query.addBindValue(i);
+                    query.addBindValue(i <= kCourses.size() ? kCourses.at(i - 1) : QString("科目%1").arg(i));
+                    query.addBindValue(i <= 3 ? "主科" : "副科");
+                    ok = query.exec();
+                }
+            }
+            if (ok) {
+                // 考试日均匀分布在过去一年内
+                const qint64 today = DBManager::toDayNumber(QDate::currentDate());
+                const int examDays = qMax(1, options.examDays);
+                query.prepare("INSERT INTO scores (score, exam_date, student_id, course_id) VALUES (?, ?, ?, ?)");
+                for (int i = 0; ok && i < options.seedScores; i++) {
+                    query.addBindValue(randomScore(rng));
+                    query.addBindValue(today - 365 + qint64(rng.bounded(quint32(examDays))) * 365 / examDays);
+                    query.addBindValue(qint64(rng.bounded(quint32(qMax(1, options.students)))) + 1);
+                    query.addBindValue(int(rng.bounded(quint32(qMax(1, options.courses)))) + 1);
+                    ok = query.exec();
+                }
+            }
+            if (ok) {
+                ok = db.commit();
+            } else {
+                if (errorMessage && errorMessage->isEmpty()) *errorMessage = "生成测试数据失败：" + query.lastError().text();
+                db.rollback();
+            }
+            db.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+    if (!ok) QFile::remove(options.databasePath);
+    return ok;
+}
+
+} // namespace
+
+bool LoadTestOptions::parseMix(const QString& text, const QStringList& allowed, QMap<QString, int> *mix,
+                               QString *errorMessage)
+{
+    QMap<QString, int> parsed;
+    for (const QString& part : text.split(',', Qt::SkipEmptyParts)) {
+        QStringList pair = part.split(':');
+        bool ok = pair.size() == 2;
+        int weight = ok ? pair.at(1).trimmed().toInt(&ok) : 0;
+        QString name = pair.value(0).trimmed();
+        if (!ok || weight < 0 || !allowed.contains(name)) {
+            if (errorMessage) *errorMessage = QString("无法识别的配比：%1（可用：%2）").arg(part, allowed.join('/'));
+            return false;
+        }
+        parsed.insert(name, weight);
+    }
+    int total = 0;
+    for (int weight : parsed) total += weight;
+    if (total <= 0) {
+        if (errorMessage) *errorMessage = "配比权重之和必须大于0：" + text;
+        return false;
+    }
+    *mix = parsed;
+    return true;
+}
+
+qint64 LoadTestOpStats::percentileUs(double q) const
+{
+    if (latenciesUs.empty()) return 0;
+    // 调用前已排序（run 合并时排序）
+    size_t index = size_t(std::ceil(q * double(latenciesUs.size()))) - (q > 0 ? 1 : 0);
+    return latenciesUs[qMin(index, latenciesUs.size() - 1)];
+}
+
+// ========== 准备与运行 ==========
+bool LoadTest::prepareDatabase(const LoadTestOptions& options, QString *errorMessage)
+{
+    if (!QFileInfo::exists(options.databasePath)) {
+        qInfo() << "生成测试库：" << options.databasePath << "学生" << options.students
+                << "科目" << options.courses << "成绩" << options.seedScores;
+        if (!generateDatabase(options, errorMessage)) return false;
+    }
+
+    // 较短的忙等待：锁冲突以重试次数的形式暴露出来，而不是全部隐藏在等待时间里
+    DatabaseConfig config;
+    config.database = options.databasePath;
+    config.options = QString("QSQLITE_BUSY_TIMEOUT=%1").arg(qMax(0, options.busyTimeoutMs));
+    if (!DBManager::getInstance().initDB(config)) {
+        if (errorMessage) *errorMessage = "初始化测试库失败：" + DBManager::getInstance().getLastError();
+        return false;
+    }
+    return true;
+}
+
+LoadTestReport LoadTest::run(const LoadTestOptions& options)
+{
+    LoadTestReport report;
+    DBManager& manager = DBManager::getInstance();
+
+    Dictionary dictionary;
+    QSqlQuery query = manager.execQuery("SELECT student_id FROM students");
+    while (query.next()) dictionary.studentIds.append(query.value(0).toLongLong());
+    query = manager.execQuery("SELECT DISTINCT class_name FROM students ORDER BY class_name");
+    while (query.next()) dictionary.classNames.append(query.value(0).toString());
+    query = manager.execQuery("SELECT course_id, course_name FROM courses ORDER BY course_id");
+    while (query.next()) {
+        dictionary.courseIds.append(query.value(0).toInt());
+        dictionary.courseNames.append(query.value(1).toString());
+    }
+    query.finish();
+    if (dictionary.studentIds.isEmpty() || dictionary.courseIds.isEmpty()) {
+        report.error = "测试库中没有学生或科目";
+        return report;
+    }
+
+    report.scoresBefore = scoreCount();
+    report.walStart = walSize(options.databasePath);
+    report.walPeak = report.walStart;
+
+    // 每个客户端一个线程、一个独立连接
+    std::atomic<bool> stop{false};
+    const int clients = qMax(0, options.readers) + qMax(0, options.writers);
+    std::vector<std::unique_ptr<ClientResult>> results;
+    QList<QThread *> threads;
+    for (int i = 0; i < clients; i++) {
+        results.push_back(std::make_unique<ClientResult>());
+        bool writer = i >= options.readers;
+        ClientContext ctx{&options, &dictionary, QRandomGenerator(options.seed + quint32(i) + 1)};
+        ClientResult *result = results.back().get();
+        threads.append(QThread::create([ctx, writer, &stop, result]() { runClient(ctx, writer, stop, result); }));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for (QThread *thread : threads) thread->start();
+    // 主线程定时采样 WAL 大小
+    while (timer.elapsed() < qint64(options.durationSec) * 1000) {
+        QThread::msleep(50);
+        report.walPeak = qMax(report.walPeak, walSize(options.databasePath));
+    }
+    stop = true;
+    for (QThread *thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+    report.elapsedSec = timer.elapsed() / 1000.0;
+    report.walEnd = walSize(options.databasePath);
+    report.walPeak = qMax(report.walPeak, report.walEnd);
+    report.dbSizeEnd = QFileInfo(options.databasePath).size();
+    report.scoresAfter = scoreCount();
+
+    // 合并各客户端结果，按操作名排序输出
+    QMap<QString, LoadTestOpStats> merged;
+    for (const auto& result : results) {
+        if (report.error.isEmpty()) report.error = result->firstError;
+        for (auto it = result->ops.cbegin(); it != result->ops.cend(); ++it) {
+            LoadTestOpStats& target = merged[it.key()];
+            target.name = it.key();
+            target.ok += it->ok;
+            target.failed += it->failed;
+            target.busyRetries += it->busyRetries;
+            target.rows += it->rows;
+            target.latenciesUs.insert(target.latenciesUs.end(), it->latenciesUs.begin(), it->latenciesUs.end());
+        }
+    }
+    for (LoadTestOpStats& stats : merged) {
+        std::sort(stats.latenciesUs.begin(), stats.latenciesUs.end());
+        report.ops.append(stats);
+    }
+    return report;
+}
+
+// ========== 报告 ==========
+QString LoadTestReport::toText() const
+{
+    auto ms = [](qint64 us) { return QString::number(us / 1000.0, 'f', 2); };
+    auto mb = [](qint64 bytes) { return QString::number(bytes / 1048576.0, 'f', 2) + " MB"; };
+    QStringList lines;
+    lines << QString("运行 %1 秒").arg(elapsedSec, 0, 'f', 1);
+    lines << QString("%1 %2 %3 %4 %5 %6 %7 %8 %9")
+                 .arg("操作", -8).arg("成功", 9).arg("失败", 7).arg("忙重试", 8).arg("次/秒", 9)
+                 .arg("p50(ms)", 9).arg("p95(ms)", 9).arg("p99(ms)", 9).arg("max(ms)", 9);
+    for (const LoadTestOpStats& op : ops) {
+        lines << QString("%1 %2 %3 %4 %5 %6 %7 %8 %9")
+                     .arg(op.name, -8).arg(op.ok, 9).arg(op.failed, 7).arg(op.busyRetries, 8)
+                     .arg(elapsedSec > 0 ? op.ok / elapsedSec : 0.0, 9, 'f', 1)
+                     .arg(ms(op.percentileUs(0.50)), 9).arg(ms(op.percentileUs(0.95)), 9)
+                     .arg(ms(op.percentileUs(0.99)), 9).arg(ms(op.percentileUs(1.0)), 9);
+    }
+    lines << QString("成绩行数：%1 -> %2").arg(scoresBefore).arg(scoresAfter);
+    lines << QString("WAL：开始 %1，峰值 %2，结束 %3；数据库文件 %4")
+                 .arg(mb(walStart), mb(walPeak), mb(walEnd), mb(dbSizeEnd));
+    if (!error.isEmpty()) lines << "首个错误：" + error;
+    return lines.join('\n');
+}
+
+QJsonObject LoadTestReport::toJson() const
+{
+    QJsonArray opArray;
+    for (const LoadTestOpStats& op : ops) {
+        opArray.append(QJsonObject{
+            {"name", op.name},
+            {"ok", op.ok},
+            {"failed", op.failed},
+            {"busy_retries", op.busyRetries},
+            {"rows", op.rows},
+            {"throughput", elapsedSec > 0 ? op.ok / elapsedSec : 0.0},
+            {"p50_us", op.percentileUs(0.50)},
+            {"p95_us", op.percentileUs(0.95)},
+            {"p99_us", op.percentileUs(0.99)},
+            {"max_us", op.percentileUs(1.0)},
+        });
+    }
+    return QJsonObject{
+        {"elapsed_sec", elapsedSec},
+        {"ops", opArray},
+        {"scores_before", scoresBefore},
+        {"scores_after", scoresAfter},
+        {"wal_start", walStart},
+        {"wal_peak", walPeak},
+        {"wal_end", walEnd},
+        {"db_size_end", dbSizeEnd},
+        {"error", error},
+    };
+}
@@ -0,0 +1,78 @@
+#ifndef LOADTEST_H
+#define LOADTEST_H
+
+#include <QString>
+#include <QList>
+#include <QMap>
+#include <QJsonObject>
+#include <vector>
+
+// 负载测试参数：N 个读客户端（统计/图表取数）与 M 个写客户端（单条/批量录入）并发访问同一数据库
+struct LoadTestOptions {
+    QString databasePath;         // 不存在时按下列规模生成测试库；已存在则直接使用（如生产库的副本）
+    int readers = 4;
+    int writers = 2;
+    int durationSec = 30;
+    int thinkMs = 0;              // 每个客户端两次操作之间的间隔（模拟人工操作节奏），0 为满负荷
+    int busyTimeoutMs = 50;       // 连接的 SQLite 忙等待时间，超时后由客户端退避重试并计数
+    int maxRetries = 20;          // 单次操作的最大重试次数，超过记为失败
+    int batchSize = 50;           // 批量录入每批条数
+    quint32 seed = 1;
+
+    // 生成测试库的规模
+    int students = 2000;
+    int classes = 40;
+    int courses = 12;
+    int seedScores = 200000;
+    int examDays = 60;            // 成绩分布在过去一年内的若干考试日
+
+    // 操作配比（权重）：读客户端 stats/chart，写客户端 single/batch
+    QMap<QString, int> readMix{{"stats", 3}, {"chart", 7}};
+    QMap<QString, int> writeMix{{"single", 9}, {"batch", 1}};
+
+    // 解析 "名称:权重,名称:权重"，名称必须是 allowed 之一
+    static bool parseMix(const QString& text, const QStringList& allowed, QMap<QString, int> *mix,
+                         QString *errorMessage = nullptr);
+};
+
+// 一类操作的结果
+struct LoadTestOpStats {
+    QString name;
+    qint64 ok = 0;
+    qint64 failed = 0;
+    qint64 busyRetries = 0;      // SQLITE_BUSY/LOCKED 后的重试次数
+    qint64 rows = 0;             // 写入行数（批量录入一次多行）
+    std::vector<qint64> latenciesUs; // 成功操作的耗时（含重试），微秒
+
+    // 耗时分位数（微秒），q 取 0~1
+    qint64 percentileUs(double q) const;
+};
+
+struct LoadTestReport {
+    QList<LoadTestOpStats> ops;
+    double elapsedSec = 0;
+    qint64 scoresBefore = 0;
+    qint64 scoresAfter = 0;
+    // WAL 文件大小（字节）：开始、运行中最大、结束
+    qint64 walStart = 0;
+    qint64 walPeak = 0;
+    qint64 walEnd = 0;
+    qint64 dbSizeEnd = 0;
+    QString error;
+
+    QString toText() const;
+    QJsonObject toJson() const;
+};
+
+// 多客户端并发负载与锁竞争测试：每个客户端一个线程、一个独立连接（与多台终端各自连接数据库相同），
+// 读写语句与界面实际使用的语句一致，汇报吞吐、耗时分位数、忙等重试与 WAL 增长。
+class LoadTest
+{
+public:
+    // 生成测试库（表结构与 studentdb.db 一致）并初始化连接；失败返回 false
+    static bool prepareDatabase(const LoadTestOptions& options, QString *errorMessage = nullptr);
+    // 运行负载测试（需先 prepareDatabase），阻塞到 durationSec 结束
+    static LoadTestReport run(const LoadTestOptions& options);
+};
+
+#endif // LOADTEST_H
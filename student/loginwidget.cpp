@@ -9,6 +9,13 @@ LoginWidget::LoginWidget(QWidget *parent) :
     ui->setupUi(this);
     this->setWindowTitle("学生成绩系统 - 登录");
     ui->labError->setVisible(false); // 隐藏错误提示
+
+    // 认证结果（异步返回）
+    connect(&AuthService::getInstance(), &AuthService::authenticated, this, [this](const AuthSession& session) {
+        emit loginSuccess(session.userType, session.username); // 发送登录成功信号
+        this->close();
+    });
+    connect(&AuthService::getInstance(), &AuthService::authenticationFailed, this, &LoginWidget::showError);
 }
 
 LoginWidget::~LoginWidget()
@@ -16,32 +23,12 @@ LoginWidget::~LoginWidget()
     delete ui;
 }
 
-// 验证账号密码逻辑（纯明文对比）
-bool LoginWidget::verifyUser(QString username, QString password)
+// 显示错误提示并恢复登录按钮
+void LoginWidget::showError(const QString& message)
 {
-    if (username.isEmpty() || password.isEmpty()) {
-        ui->labError->setText("账号/密码不能为空！");
-        ui->labError->setVisible(true);
-        return false;
-    }
-
-    // 查询用户信息（明文密码对比）
-    QString sql = QString("SELECT password, user_type FROM users WHERE username = '%1'").arg(username);
-    QSqlQuery query = DBManager::getInstance().execQuery(sql);
-
-    if (!query.next()) { // 账号不存在
-        ui->labError->setText("账号不存在！");
-        ui->labError->setVisible(true);
-        return false;
-    }
-
-    // 直接对比明文密码（无加密）
-    if (query.value(0).toString() != password) { // 密码错误
-        ui->labError->setText("密码错误！");
-        ui->labError->setVisible(true);
-        return false;
-    }
-    return true;
+    ui->labError->setText(message);
+    ui->labError->setVisible(true);
+    ui->btnLogin->setEnabled(true);
 }
 
 // 取消按钮点击
@@ -51,20 +38,18 @@ void LoginWidget::on_btnCancel_clicked()
     qApp->exit(); // 退出程序
 }
 
-// 登录按钮点击
+// 登录按钮点击：单次查询取回哈希与角色，密码校验在后台线程完成
 void LoginWidget::on_btnLogin_clicked()
 {
     QString username = ui->leUsername->text().trimmed();
     QString password = ui->lePassword->text().trimmed();
 
-    if (verifyUser(username, password)) {
-        // 获取用户类型
-        QString sql = QString("SELECT user_type FROM users WHERE username = '%1'").arg(username);
-        QSqlQuery query = DBManager::getInstance().execQuery(sql);
-        query.next();
-        QString userType = query.value(0).toString();
-
-        emit loginSuccess(userType, username); // 发送登录成功信号
-        this->close();
+    if (username.isEmpty() || password.isEmpty()) {
+        showError("账号/密码不能为空！");
+        return;
     }
+
+    ui->labError->setVisible(false);
+    ui->btnLogin->setEnabled(false); // 验证期间禁止重复提交
+    AuthService::getInstance().authenticate(username, password);
 }
@@ -3,6 +3,7 @@
 
 #include <QWidget>
 #include "dbmanager.h"
+#include "authservice.h"
 
 namespace Ui {
 class LoginWidget;
@@ -26,8 +27,8 @@ private slots:
 
 private:
     Ui::LoginWidget *ui;
-    // 验证账号密码
-    bool verifyUser(QString username, QString password);
+    // 显示错误提示并恢复登录按钮
+    void showError(const QString& message);
 };
 
 #endif // LOGINWIDGET_H
@@ -5,29 +5,297 @@
 #include "mainwindow.h"
 #include "loginwidget.h"
 #include "dbmanager.h"
+#include "anomalyscanner.h"
+#include "chartexporter.h"
+#include "datasnapshot.h"
+#include "loadtest.h"
+#include "memoryaccounting.h"
+#include "scorewriter.h"
+#include "selftest.h"
+#include "transcriptgenerator.h"
+#include <QCommandLineParser>
+#include <QSqlQuery>
+#include <QDebug>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <cstring>
+
+// 命令行批量导出趋势图（无需登录界面）：
+//   student --export-charts <目录> --course <科目> [--class <班级>] [--format png|svg|pdf]
+//   student --export-charts <目录> --student <学号> [--format ...]   每个科目一张
+static int runChartExport(const QCommandLineParser& parser)
+{
+    ChartExportOptions options;
+    options.outputDir = parser.value("export-charts");
+    if (parser.isSet("format") && !ChartExporter::parseFormat(parser.value("format"), &options.format)) {
+        qCritical() << "不支持的格式：" << parser.value("format");
+        return -1;
+    }
+    options.from = QDate::fromString(parser.value("from"), "yyyy-MM-dd");
+    options.to = QDate::fromString(parser.value("to"), "yyyy-MM-dd");
+
+    if (parser.isSet("student")) {
+        options.mode = ChartExportOptions::PerCourse;
+        options.studentId = parser.value("student");
+    } else if (parser.isSet("course")) {
+        QSqlQuery query;
+        query.prepare("SELECT course_id FROM courses WHERE course_name = ?");
+        query.addBindValue(parser.value("course"));
+        if (!query.exec() || !query.next()) {
+            qCritical() << "科目不存在：" << parser.value("course");
+            return -1;
+        }
+        options.mode = ChartExportOptions::PerStudent;
+        options.courseId = query.value(0).toInt();
+        options.className = parser.value("class");
+    } else {
+        qCritical() << "需要指定 --course 或 --student";
+        return -1;
+    }
+
+    QString error;
+    int count = ChartExporter::exportCharts(options, &error);
+    if (count < 0) {
+        qCritical() << "批量导出失败：" << error;
+        return -1;
+    }
+    qInfo() << "已导出" << count << "张趋势图到" << options.outputDir;
+    return 0;
+}
+
+// 命令行批量生成成绩单（无需登录界面）：
+//   student --export-transcripts <目录> [--class <班级>] [--from yyyy-MM-dd] [--to yyyy-MM-dd] [--title <标题>]
+static int runTranscriptExport(const QCommandLineParser& parser)
+{
+    TranscriptOptions options;
+    options.outputDir = parser.value("export-transcripts");
+    options.className = parser.value("class");
+    options.from = QDate::fromString(parser.value("from"), "yyyy-MM-dd");
+    options.to = QDate::fromString(parser.value("to"), "yyyy-MM-dd");
+    options.title = parser.value("title");
+
+    QString error;
+    int count = TranscriptGenerator::generate(options, &error);
+    if (count < 0) {
+        qCritical() << "成绩单生成失败：" << error;
+        return -1;
+    }
+    qInfo() << "已生成" << count << "份成绩单到" << options.outputDir;
+    return 0;
+}
+
+// 命令行成绩异常检测（无需登录界面）：
+//   student --scan-anomalies <结果.csv> [--class <班级>] [--from yyyy-MM-dd] [--to yyyy-MM-dd]
+static int runAnomalyScan(const QCommandLineParser& parser)
+{
+    AnomalyOptions options;
+    options.className = parser.value("class");
+    options.from = QDate::fromString(parser.value("from"), "yyyy-MM-dd");
+    options.to = QDate::fromString(parser.value("to"), "yyyy-MM-dd");
+
+    AnomalyReport report = AnomalyScanner::scan(options);
+    if (!report.error.isEmpty()) {
+        qCritical() << "异常检测失败：" << report.error;
+        return -1;
+    }
+    QString error;
+    if (!report.writeCsv(parser.value("scan-anomalies"), &error)) {
+        qCritical() << "写入结果失败：" << error;
+        return -1;
+    }
+    qInfo() << "扫描" << report.scannedRows << "条成绩，发现" << report.findings.size() + report.truncated
+            << "处异常，耗时" << report.elapsedMs << "ms，结果已写入" << parser.value("scan-anomalies");
+    return 0;
+}
+
+// 命令行并发负载测试（无需登录界面）：
+//   student --load-test <测试库> [--readers N] [--writers M] [--duration 秒] [--report 结果.json]
+// 测试库不存在时按 --students/--seed-scores 等规模生成；已存在时直接使用（例如生产库的副本）
+static int runLoadTest(const QCommandLineParser& parser)
+{
+    LoadTestOptions options;
+    options.databasePath = parser.value("load-test");
+    auto intOption = [&](const QString& name, int *value, int minimum) {
+        if (!parser.isSet(name)) return true;
+        bool ok = false;
+        int parsed = parser.value(name).toInt(&ok);
+        if (!ok || parsed < minimum) {
+            qCritical() << "参数无效：" << name << parser.value(name);
+            return false;
+        }
+        *value = parsed;
+        return true;
+    };
+    if (!intOption("readers", &options.readers, 0) || !intOption("writers", &options.writers, 0)
+        || !intOption("duration", &options.durationSec, 1) || !intOption("think-ms", &options.thinkMs, 0)
+        || !intOption("busy-timeout", &options.busyTimeoutMs, 0) || !intOption("batch-size", &options.batchSize, 1)
+        || !intOption("students", &options.students, 1) || !intOption("seed-scores", &options.seedScores, 0)) {
+        return -1;
+    }
+    if (options.readers + options.writers == 0) {
+        qCritical() << "至少需要一个读或写客户端";
+        return -1;
+    }
+    QString error;
+    if ((parser.isSet("read-mix") && !LoadTestOptions::parseMix(parser.value("read-mix"), {"stats", "chart"}, &options.readMix, &error))
+        || (parser.isSet("write-mix") && !LoadTestOptions::parseMix(parser.value("write-mix"), {"single", "batch"}, &options.writeMix, &error))) {
+        qCritical() << error;
+        return -1;
+    }
+
+    if (!LoadTest::prepareDatabase(options, &error)) {
+        qCritical() << "负载测试准备失败：" << error;
+        return -1;
+    }
+    qInfo() << "负载测试：读客户端" << options.readers << "写客户端" << options.writers << "时长" << options.durationSec << "秒";
+    LoadTestReport report = LoadTest::run(options);
+    qInfo().noquote() << report.toText();
+
+    if (parser.isSet("report")) {
+        QSaveFile file(parser.value("report"));
+        if (!file.open(QIODevice::WriteOnly)
+            || file.write(QJsonDocument(report.toJson()).toJson(QJsonDocument::Indented)) < 0 || !file.commit()) {
+            qCritical() << "写入报告失败：" << file.errorString();
+            return -1;
+        }
+    }
+    // 有失败的操作时返回非零，便于脚本发现竞争回退
+    for (const LoadTestOpStats& op : report.ops) {
+        if (op.failed > 0) return 1;
+    }
+    return report.ops.isEmpty() ? 1 : 0;
+}
+
+// 归档后成绩汇总一致性检查（无需登录界面，会修改数据，只对测试库或副本运行）：
+//   student --check-archive <库文件副本>
+static int runArchiveCheck(const QCommandLineParser& parser)
+{
+    QString path = parser.value("check-archive");
+    if (!QFileInfo::exists(path)) {
+        qCritical() << "数据库文件不存在：" << path;
+        return -1;
+    }
+    if (!DBManager::getInstance().initDB(path)) {
+        qCritical() << "数据库连接失败：" << DBManager::getInstance().getLastError();
+        return -1;
+    }
+    QString report;
+    if (!DBManager::getInstance().checkArchivedSummary(&report)) {
+        qCritical().noquote() << "归档一致性检查失败：" << report;
+        return 1;
+    }
+    qInfo().noquote() << report;
+    return 0;
+}
+
+// 数据库方言自检（无界面，使用临时 SQLite 库，不读取 studentdb.ini）：
+//   student --self-test
+static int runSelfTest()
+{
+    QString report;
+    bool ok = SelfTest::run(&report);
+    if (ok) {
+        qInfo().noquote() << report;
+        return 0;
+    }
+    qCritical().noquote() << report;
+    return 1;
+}
 
 int main(int argc, char *argv[])
 {
+    // 批量导出/负载测试不需要显示器：未指定平台时使用 offscreen
+    for (int i = 1; i < argc; i++) {
+        if ((std::strcmp(argv[i], "--export-charts") == 0 || std::strcmp(argv[i], "--export-transcripts") == 0
+             || std::strcmp(argv[i], "--scan-anomalies") == 0 || std::strcmp(argv[i], "--load-test") == 0
+             || std::strcmp(argv[i], "--check-archive") == 0 || std::strcmp(argv[i], "--self-test") == 0)
+            && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+    }
+
     QApplication a(argc, argv);
 
-    // 检查数据库文件是否存在
-    QString dbPath = "studentdb.db";
-    QFileInfo dbFile(dbPath);
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOptions({
+        {"export-charts", "批量导出趋势图到目录（无界面）", "dir"},
+        {"export-transcripts", "批量生成每个学生的 PDF 成绩单到目录（无界面）", "dir"},
+        {"title", "成绩单标题（默认：学生成绩单）", "text"},
+        {"scan-anomalies", "成绩异常检测，结果写入 CSV 文件（无界面）", "file"},
+        {"course", "导出该科目下每个学生的趋势图", "name"},
+        {"class", "只导出该班级的学生", "name"},
+        {"student", "导出该学生每个科目的趋势图", "id"},
+        {"format", "导出格式：png/svg/pdf（默认png）", "format"},
+        {"from", "起始日期 yyyy-MM-dd", "date"},
+        {"to", "截止日期 yyyy-MM-dd", "date"},
+        {"config", "数据库配置文件（默认 studentdb.ini）", "file"},
+        {"load-test", "并发负载测试（无界面），库文件不存在时生成测试库", "db"},
+        {"readers", "负载测试：读客户端数（默认4）", "n"},
+        {"writers", "负载测试：写客户端数（默认2）", "n"},
+        {"duration", "负载测试：运行秒数（默认30）", "sec"},
+        {"think-ms", "负载测试：客户端操作间隔毫秒（默认0，满负荷）", "ms"},
+        {"busy-timeout", "负载测试：SQLite 忙等待毫秒（默认50），超时后重试并计数", "ms"},
+        {"batch-size", "负载测试：批量录入每批条数（默认50）", "n"},
+        {"read-mix", "负载测试：读操作配比，如 stats:3,chart:7", "mix"},
+        {"write-mix", "负载测试：写操作配比，如 single:9,batch:1", "mix"},
+        {"students", "负载测试：生成的学生数（默认2000）", "n"},
+        {"seed-scores", "负载测试：生成的成绩条数（默认200000）", "n"},
+        {"report", "负载测试：结果写入 JSON 文件", "file"},
+        {"check-archive", "归档最早的学期并调班后核对成绩汇总表（无界面，会修改数据，只用于库文件副本）", "db"},
+        {"self-test", "数据库方言自检：各后端的分页、窗口函数、批量与连接策略，并在临时 SQLite 库上执行（无界面）"},
+    });
+    parser.process(a);
+
+    // 负载测试、归档检查使用命令行指定的库文件，自检使用临时库，均不读取 studentdb.ini
+    if (parser.isSet("self-test")) {
+        return runSelfTest();
+    }
+    if (parser.isSet("load-test")) {
+        return runLoadTest(parser);
+    }
+    if (parser.isSet("check-archive")) {
+        return runArchiveCheck(parser);
+    }
+
+    // 数据库配置：studentdb.ini（程序目录优先，其次当前目录）；没有配置文件时使用当前目录下的 SQLite 文件
+    QString configPath = QDir(QCoreApplication::applicationDirPath()).filePath("studentdb.ini");
+    if (!QFileInfo::exists(configPath)) configPath = "studentdb.ini";
+    if (parser.isSet("config")) configPath = parser.value("config");
+    DatabaseConfig dbConfig = DatabaseConfig::load(configPath);
 
-    if (!dbFile.exists()) {
+    // 检查数据库文件是否存在（仅 SQLite；服务器后端由连接结果判断）
+    if (dbConfig.isSQLite() && !QFileInfo::exists(dbConfig.database)) {
         QMessageBox::critical(nullptr, "错误",
                               QString("数据库文件不存在！\n路径：%1\n当前目录：%2")
-                                  .arg(dbPath)
+                                  .arg(dbConfig.database)
                                   .arg(QDir::currentPath()));
         return -1;
     }
 
     // 1. 初始化数据库
-    if (!DBManager::getInstance().initDB(dbPath)) {
-        QMessageBox::critical(nullptr, "错误", "数据库连接失败！");
+    if (!DBManager::getInstance().initDB(dbConfig)) {
+        QMessageBox::critical(nullptr, "错误", QString("数据库连接失败！\n驱动：%1\n%2")
+                                                   .arg(dbConfig.driver, DBManager::getInstance().getLastError()));
         return -1;
     }
 
+    if (parser.isSet("export-charts")) {
+        return runChartExport(parser);
+    }
+    if (parser.isSet("export-transcripts")) {
+        return runTranscriptExport(parser);
+    }
+    if (parser.isSet("scan-anomalies")) {
+        return runAnomalyScan(parser);
+    }
+
+    // 内存预算：同一配置文件的 [memory] 段（如 stat_mb=512、process_mb=2048）
+    MemoryAccounting::getInstance().loadBudgets(configPath);
+
+    // 映射启动快照（班级/课程字典与预聚合统计），过期时后台重建
+    DataSnapshot::getInstance().open();
+
     // 2. 显示登录窗口
     LoginWidget loginWidget;
     MainWindow mainWindow;
@@ -40,5 +308,8 @@ int main(int argc, char *argv[])
     });
 
     loginWidget.show();
-    return a.exec();
+    int ret = a.exec();
+    // 退出前写完成绩写线程中尚未提交的请求
+    ScoreWriter::getInstance().shutdown();
+    return ret;
 }
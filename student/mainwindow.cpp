@@ -1,5 +1,11 @@
 #include "mainwindow.h"
 #include "ui_MainWindow.h"
+#include "memoryaccounting.h"
+#include "memorydiagnosticsdialog.h"
+#include <QInputDialog>
+#include <QFileDialog>
+#include <QFutureWatcher>
+#include <QtConcurrent>
 
 // 构造函数：初始化UI + 加载子模块 + 权限控制
 MainWindow::MainWindow(QWidget *parent)
@@ -10,6 +16,8 @@ MainWindow::MainWindow(QWidget *parent)
     , m_inputWidget(nullptr)
     , m_statWidget(nullptr)
     , m_chartWidget(nullptr)
+    , m_pivotWidget(nullptr)
+    , m_dateRangeBar(nullptr)
 {
     ui->setupUi(this);
     this->setWindowTitle("学生成绩管理系统 v1.0"); // 设置窗口标题
@@ -19,11 +27,28 @@ MainWindow::MainWindow(QWidget *parent)
     m_inputWidget = new ScoreInputWidget();   // 成绩录入模块
     m_statWidget = new ScoreStatWidget();     // 成绩统计模块
     m_chartWidget = new ScoreChartWidget();   // 成绩图表模块
+    m_pivotWidget = new ScorePivotWidget();   // 学生×科目 成绩矩阵
 
     // ========== 2. 将子模块添加到TabWidget ==========
     ui->tabWidget->addTab(m_inputWidget, "成绩录入");   // 第一个Tab
     ui->tabWidget->addTab(m_statWidget, "成绩统计");     // 第二个Tab
     ui->tabWidget->addTab(m_chartWidget, "成绩图表");     // 第三个Tab
+    ui->tabWidget->addTab(m_pivotWidget, "成绩矩阵");     // 第四个Tab
+
+    // ========== 日期范围筛选：放在Tab上方，统计与图表共用 ==========
+    m_dateRangeBar = new DateRangeBar(this);
+    ui->verticalLayout->insertWidget(0, m_dateRangeBar);
+    connect(m_dateRangeBar, &DateRangeBar::rangeChanged, m_statWidget, &ScoreStatWidget::setDateRange);
+    connect(m_dateRangeBar, &DateRangeBar::rangeChanged, m_chartWidget, &ScoreChartWidget::setDateRange);
+    connect(m_dateRangeBar, &DateRangeBar::rangeChanged, m_pivotWidget, &ScorePivotWidget::setDateRange);
+
+    // 内存超出预算时在状态栏提示（回收由各模块登记的回收函数完成）
+    connect(&MemoryAccounting::getInstance(), &MemoryAccounting::budgetExceeded, this,
+            [this](const QString& subsystem, qint64 bytes, qint64 budget) {
+                ui->statusBar->showMessage(QString("内存超出预算：%1 占用 %2，预算 %3")
+                                               .arg(subsystem, MemoryAccounting::formatBytes(bytes),
+                                                    MemoryAccounting::formatBytes(budget)));
+            });
 
     // ========== 3. 初始化状态栏 ==========
     ui->statusBar->showMessage(QString("系统就绪 - 当前时间：%1").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss")));
@@ -36,6 +61,7 @@ MainWindow::~MainWindow()
     delete m_inputWidget;
     delete m_statWidget;
     delete m_chartWidget;
+    delete m_pivotWidget;
     // 释放UI
     delete ui;
 }
@@ -43,16 +69,21 @@ MainWindow::~MainWindow()
 // 核心：设置用户类型，控制模块权限
 void MainWindow::setUserType(const QString& userType)
 {
-    m_userType = userType;
+    // 角色信息来自登录会话缓存，无需再次查询 users 表
+    const AuthSession& session = AuthService::getInstance().currentSession();
+    m_currentUser = session.username;
+    m_userType = session.isValid() ? session.userType : userType;
     // ========== 权限控制规则 ==========
     // - admin（管理员）：可访问所有模块（录入+统计+图表）
     // - normal（普通用户）：仅可访问统计+图表，隐藏录入模块
-    if (userType == "normal") {
+    if (m_userType == "normal") {
         // 移除成绩录入Tab（索引0）
         ui->tabWidget->removeTab(0);
+        // 数据维护菜单仅管理员可用
+        ui->menuData->menuAction()->setVisible(false);
         // 更新状态栏：提示普通用户权限
         ui->statusBar->showMessage(QString("当前登录：普通用户 - 权限限制：不可录入成绩"));
-    } else if (userType == "admin") {
+    } else if (m_userType == "admin") {
         // 更新状态栏：提示管理员权限
         ui->statusBar->showMessage(QString("当前登录：管理员 - 权限：可访问所有模块"));
     }
@@ -77,3 +108,126 @@ void MainWindow::on_actionAbout_triggered()
                        "基于Qt 6.5.3开发\n"
                        "功能：成绩录入、统计、图表展示");
 }
+
+// ========== 菜单栏槽函数：归档已结束学期 ==========
+void MainWindow::on_actionArchiveTerm_triggered()
+{
+    if (!AuthService::getInstance().currentSession().isAdmin()) {
+        QMessageBox::warning(this, "提示", "仅管理员可以归档学期！");
+        return;
+    }
+
+    QList<TermRange> terms = DBManager::getInstance().archivableTerms();
+    if (terms.isEmpty()) {
+        QMessageBox::information(this, "提示", "没有可归档的学期（只能归档已结束的学期）。");
+        return;
+    }
+
+    QStringList labels;
+    for (const TermRange& term : terms) {
+        labels << QString("%1（%2 ~ %3）").arg(term.label,
+                                              term.first.toString("yyyy-MM-dd"),
+                                              term.last.toString("yyyy-MM-dd"));
+    }
+    bool ok = false;
+    QString choice = QInputDialog::getItem(this, "归档学期", "选择要归档的学期：", labels, 0, false, &ok);
+    if (!ok) return;
+    const TermRange& term = terms.at(labels.indexOf(choice));
+
+    int ret = QMessageBox::question(this, "归档学期",
+                                    QString("归档后【%1】的成绩将移入历史分区，不能再录入或修改。是否继续？").arg(term.label),
+                                    QMessageBox::Yes | QMessageBox::No, QMessageBox::No);
+    if (ret != QMessageBox::Yes) return;
+
+    QString error;
+    if (DBManager::getInstance().archiveTerm(term.key, &error)) {
+        ui->statusBar->showMessage(QString("已归档：%1").arg(term.label));
+    } else {
+        QMessageBox::critical(this, "错误", "归档失败：" + error);
+    }
+}
+
+// ========== 菜单栏槽函数：在线备份 ==========
+void MainWindow::on_actionBackup_triggered()
+{
+    if (!AuthService::getInstance().currentSession().isAdmin()) {
+        QMessageBox::warning(this, "提示", "仅管理员可以备份数据库！");
+        return;
+    }
+
+    QString defaultName = QString("studentdb_%1.db").arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+    QString filePath = QFileDialog::getSaveFileName(this, "备份数据库", defaultName, "SQLite数据库 (*.db)");
+    if (filePath.isEmpty()) return;
+
+    // 在工作线程生成快照，备份期间界面照常读写
+    ui->actionBackup->setEnabled(false);
+    ui->statusBar->showMessage("正在备份数据库...");
+    auto *watcher = new QFutureWatcher<QString>(this);
+    connect(watcher, &QFutureWatcher<QString>::finished, this, [this, watcher, filePath]() {
+        QString error = watcher->result();
+        watcher->deleteLater();
+        ui->actionBackup->setEnabled(true);
+        if (error.isEmpty()) {
+            ui->statusBar->showMessage(QString("已备份到：%1").arg(filePath));
+        } else {
+            ui->statusBar->showMessage("备份失败");
+            QMessageBox::critical(this, "错误", "备份失败：" + error);
+        }
+    });
+    watcher->setFuture(QtConcurrent::run([filePath]() {
+        QString error;
+        DBManager::getInstance().backupTo(filePath, &error);
+        return error;
+    }));
+}
+
+// ========== 菜单栏槽函数：恢复到时间点 ==========
+void MainWindow::on_actionRestorePoint_triggered()
+{
+    if (!AuthService::getInstance().currentSession().isAdmin()) {
+        QMessageBox::warning(this, "提示", "仅管理员可以恢复数据！");
+        return;
+    }
+
+    QDateTime earliest = DBManager::getInstance().earliestRestorePoint();
+    if (!earliest.isValid()) {
+        QMessageBox::information(this, "提示", "还没有成绩变更记录。");
+        return;
+    }
+
+    bool ok = false;
+    QString text = QInputDialog::getText(this, "恢复到时间点",
+                                         QString("将成绩恢复到以下时间（最早可恢复到 %1）：")
+                                             .arg(earliest.toString("yyyy-MM-dd HH:mm:ss")),
+                                         QLineEdit::Normal,
+                                         QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss"), &ok);
+    if (!ok) return;
+    QDateTime target = QDateTime::fromString(text.trimmed(), "yyyy-MM-dd HH:mm:ss");
+    if (!target.isValid()) {
+        QMessageBox::warning(this, "提示", "时间格式错误，应为 yyyy-MM-dd HH:mm:ss");
+        return;
+    }
+
+    int ret = QMessageBox::question(this, "恢复到时间点",
+                                    QString("将撤销 %1 之后的全部成绩录入、修改和删除。是否继续？")
+                                        .arg(target.toString("yyyy-MM-dd HH:mm:ss")),
+                                    QMessageBox::Yes | QMessageBox::No, QMessageBox::No);
+    if (ret != QMessageBox::Yes) return;
+
+    QString error;
+    int undone = DBManager::getInstance().restoreToPointInTime(target, &error);
+    if (undone < 0) {
+        QMessageBox::critical(this, "错误", "恢复失败：" + error);
+        return;
+    }
+    m_statWidget->reload();
+    ui->statusBar->showMessage(QString("已恢复到 %1，撤销 %2 条变更").arg(target.toString("yyyy-MM-dd HH:mm:ss")).arg(undone));
+}
+
+// ========== 菜单栏槽函数：内存诊断 ==========
+void MainWindow::on_actionMemoryDiagnostics_triggered()
+{
+    MemoryDiagnosticsDialog *dialog = new MemoryDiagnosticsDialog(this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->show();
+}
@@ -9,6 +9,8 @@
 #include "scoreinputwidget.h"
 #include "scorestatwidget.h"
 #include "scorechartwidget.h"
+#include "scorepivotwidget.h"
+#include "daterangebar.h"
 
 // 前置声明UI类
 namespace Ui {
@@ -31,6 +33,10 @@ private slots:
     // 菜单栏动作槽函数
     void on_actionQuit_triggered();       // 退出程序
     void on_actionAbout_triggered();      // 关于信息
+    void on_actionArchiveTerm_triggered(); // 归档已结束学期（管理员）
+    void on_actionBackup_triggered();      // 在线备份数据库（管理员）
+    void on_actionRestorePoint_triggered(); // 成绩恢复到指定时间点（管理员）
+    void on_actionMemoryDiagnostics_triggered(); // 各模块内存占用与预算
 
 private:
     // 成员变量
@@ -41,6 +47,8 @@ private:
     ScoreInputWidget *m_inputWidget;
     ScoreStatWidget *m_statWidget;
     ScoreChartWidget *m_chartWidget;
+    ScorePivotWidget *m_pivotWidget;
+    DateRangeBar *m_dateRangeBar;         // 统计/图表共用的日期范围
 };
 
 #endif // MAINWINDOW_H
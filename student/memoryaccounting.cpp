@@ -0,0 +1,258 @@
+#include "memoryaccounting.h"
+#include <QSettings>
+#include <QFile>
+#include <QSaveFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QLocale>
+#include <QDebug>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+MemoryAccounting::MemoryAccounting()
+{
+    connect(&m_checkTimer, &QTimer::timeout, this, &MemoryAccounting::check);
+}
+
+// ========== 登记 ==========
+void MemoryAccounting::registerProbe(const QString& subsystem, const QString& name, QObject *owner,
+                                     std::function<MemorySample()> probe)
+{
+    m_probes.append({subsystem, name, owner, std::move(probe)});
+}
+
+void MemoryAccounting::registerTrimHandler(const QString& subsystem, QObject *owner, std::function<void()> handler)
+{
+    m_trimHandlers.append({subsystem, owner, std::move(handler)});
+}
+
+void MemoryAccounting::charge(const QString& subsystem, const QString& name, qint64 deltaBytes, qint64 deltaItems)
+{
+    QMutexLocker locker(&m_chargeMutex);
+    MemoryCounter& counter = m_charges[key(subsystem, name)];
+    if (counter.subsystem.isEmpty()) {
+        counter.subsystem = subsystem;
+        counter.name = name;
+        counter.transient = true;
+    }
+    counter.bytes += deltaBytes;
+    counter.items += deltaItems;
+    // 临时缓冲可能在两次采样之间出现又释放，峰值在记账时记录
+    counter.peakBytes = qMax(counter.peakBytes, counter.bytes);
+}
+
+// ========== 预算 ==========
+void MemoryAccounting::setBudget(const QString& subsystem, qint64 bytes)
+{
+    if (bytes > 0) {
+        m_budgets.insert(subsystem, bytes);
+    } else {
+        m_budgets.remove(subsystem);
+        m_overBudget.remove(subsystem);
+    }
+}
+
+qint64 MemoryAccounting::budget(const QString& subsystem) const
+{
+    return m_budgets.value(subsystem, 0);
+}
+
+void MemoryAccounting::loadBudgets(const QString& iniPath)
+{
+    int intervalMs = 5000;
+    if (QFile::exists(iniPath)) {
+        QSettings settings(iniPath, QSettings::IniFormat);
+        settings.beginGroup("memory");
+        for (const QString& name : settings.childKeys()) {
+            if (name.endsWith("_mb")) {
+                setBudget(name.chopped(3), settings.value(name).toLongLong() * 1024 * 1024);
+            }
+        }
+        intervalMs = settings.value("check_interval_ms", intervalMs).toInt();
+        settings.endGroup();
+    }
+    // 没有预算时也定时采样，诊断窗口的峰值才能覆盖未打开窗口期间
+    if (intervalMs > 0) m_checkTimer.start(qMax(500, intervalMs));
+}
+
+// ========== 采样 ==========
+QList<MemoryCounter> MemoryAccounting::sample()
+{
+    QList<MemoryCounter> counters;
+    for (int i = m_probes.size() - 1; i >= 0; i--) {
+        if (!m_probes[i].owner) m_probes.removeAt(i); // 所属对象已销毁
+    }
+    for (const Probe& probe : m_probes) {
+        MemorySample value = probe.probe();
+        MemoryCounter counter;
+        counter.subsystem = probe.subsystem;
+        counter.name = probe.name;
+        counter.items = value.items;
+        counter.bytes = value.bytes;
+        qint64& peak = m_peaks[key(probe.subsystem, probe.name)];
+        peak = qMax(peak, value.bytes);
+        counter.peakBytes = peak;
+        counters.append(counter);
+    }
+
+    QMutexLocker locker(&m_chargeMutex);
+    for (const MemoryCounter& counter : std::as_const(m_charges)) {
+        counters.append(counter);
+    }
+    return counters;
+}
+
+ProcessMemory MemoryAccounting::processMemory()
+{
+    ProcessMemory memory;
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        memory.rss = qint64(counters.WorkingSetSize);
+        memory.peakRss = qint64(counters.PeakWorkingSetSize);
+    }
+#elif defined(Q_OS_LINUX)
+    // VmRSS / VmHWM 单位为 kB
+    QFile status("/proc/self/status");
+    if (status.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        const QList<QByteArray> lines = status.readAll().split('\n');
+        for (const QByteArray& line : lines) {
+            if (line.startsWith("VmRSS:")) {
+                memory.rss = line.mid(6).trimmed().split(' ').value(0).toLongLong() * 1024;
+            } else if (line.startsWith("VmHWM:")) {
+                memory.peakRss = line.mid(6).trimmed().split(' ').value(0).toLongLong() * 1024;
+            }
+        }
+    }
+#elif defined(Q_OS_UNIX)
+    // 其它 Unix 只有峰值：macOS 的 ru_maxrss 为字节，其余为 kB
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(Q_OS_DARWIN)
+        memory.peakRss = qint64(usage.ru_maxrss);
+#else
+        memory.peakRss = qint64(usage.ru_maxrss) * 1024;
+#endif
+    }
+#endif
+    return memory;
+}
+
+QString MemoryAccounting::formatBytes(qint64 bytes)
+{
+    if (bytes < 0) return QString("--");
+    return QLocale::system().formattedDataSize(bytes, 1, QLocale::DataSizeTraditionalFormat);
+}
+
+// ========== 预算检查 ==========
+void MemoryAccounting::check()
+{
+    const QList<MemoryCounter> counters = sample();
+    QHash<QString, qint64> totals;
+    for (const MemoryCounter& counter : counters) {
+        totals[counter.subsystem] += counter.bytes;
+    }
+    ProcessMemory process = processMemory();
+    if (process.rss >= 0) totals.insert("process", process.rss);
+
+    for (auto it = m_budgets.cbegin(); it != m_budgets.cend(); ++it) {
+        const QString& subsystem = it.key();
+        qint64 used = totals.value(subsystem, 0);
+        if (used <= it.value()) {
+            m_overBudget.remove(subsystem);
+            continue;
+        }
+        if (m_overBudget.contains(subsystem)) continue; // 持续超出只报告一次
+        m_overBudget.insert(subsystem);
+        qWarning() << "内存超出预算：" << subsystem << used << ">" << it.value();
+        emit budgetExceeded(subsystem, used, it.value());
+
+        // 进程预算超出时所有子系统都回收
+        for (int i = m_trimHandlers.size() - 1; i >= 0; i--) {
+            if (!m_trimHandlers[i].owner) {
+                m_trimHandlers.removeAt(i);
+            } else if (subsystem == "process" || m_trimHandlers[i].subsystem == subsystem) {
+                m_trimHandlers[i].handler();
+            }
+        }
+    }
+}
+
+// ========== JSON 导出 ==========
+QJsonObject MemoryAccounting::toJson()
+{
+    QJsonArray counters;
+    QHash<QString, qint64> totals;
+    for (const MemoryCounter& counter : sample()) {
+        totals[counter.subsystem] += counter.bytes;
+        counters.append(QJsonObject{
+            {"subsystem", counter.subsystem},
+            {"name", counter.name},
+            {"items", counter.items},
+            {"bytes", counter.bytes},
+            {"peak_bytes", counter.peakBytes},
+            {"transient", counter.transient},
+        });
+    }
+
+    QJsonObject subsystems;
+    for (auto it = totals.cbegin(); it != totals.cend(); ++it) {
+        QJsonObject entry{{"bytes", it.value()}};
+        if (qint64 limit = budget(it.key())) entry.insert("budget", limit);
+        subsystems.insert(it.key(), entry);
+    }
+
+    ProcessMemory process = processMemory();
+    QJsonObject processJson{{"rss", process.rss}, {"peak_rss", process.peakRss}};
+    if (qint64 limit = budget("process")) processJson.insert("budget", limit);
+
+    return QJsonObject{
+        {"time", QDateTime::currentDateTime().toString(Qt::ISODate)},
+        {"process", processJson},
+        {"subsystems", subsystems},
+        {"counters", counters},
+    };
+}
+
+bool MemoryAccounting::writeJson(const QString& filePath, QString *errorMessage)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(toJson()).toJson(QJsonDocument::Indented));
+    if (!file.commit()) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+// ========== 临时缓冲记账 ==========
+MemoryCharge::MemoryCharge(const QString& subsystem, const QString& name, qint64 bytes, qint64 items)
+    : m_subsystem(subsystem)
+    , m_name(name)
+{
+    update(bytes, items);
+}
+
+MemoryCharge::~MemoryCharge()
+{
+    update(0, 0);
+}
+
+void MemoryCharge::update(qint64 bytes, qint64 items)
+{
+    if (bytes == m_bytes && items == m_items) return;
+    MemoryAccounting::getInstance().charge(m_subsystem, m_name, bytes - m_bytes, items - m_items);
+    m_bytes = bytes;
+    m_items = items;
+}
@@ -0,0 +1,128 @@
+#ifndef MEMORYACCOUNTING_H
+#define MEMORYACCOUNTING_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QPointer>
+#include <QJsonObject>
+#include <QTimer>
+#include <functional>
+
+// 一次采样：条目数（行/单元格/点）与估算字节数
+struct MemorySample {
+    qint64 items = 0;
+    qint64 bytes = 0;
+};
+
+// 诊断表中的一行（某子系统下的一个计数项）
+struct MemoryCounter {
+    QString subsystem;   // 子系统标识（与预算配置键一致）：stat / input / chart / pivot / index / snapshot / writer / export
+    QString name;        // 计数项名称
+    qint64 items = 0;
+    qint64 bytes = 0;
+    qint64 peakBytes = 0; // 本次运行中观察到的最大值
+    bool transient = false; // 临时缓冲（导出结果集等），结束后归零
+};
+
+// 进程内存：当前常驻集与峰值常驻集（字节），平台不支持时为 -1
+struct ProcessMemory {
+    qint64 rss = -1;
+    qint64 peakRss = -1;
+};
+
+// 内存记账：各模块登记探针（在界面线程按需采样自身缓存），
+// 工作线程中的临时缓冲用 MemoryCharge 记账；按子系统汇总、记录峰值，
+// 超出预算时发出 budgetExceeded 并调用该子系统登记的回收函数
+class MemoryAccounting : public QObject
+{
+    Q_OBJECT
+
+public:
+    static MemoryAccounting& getInstance() {
+        static MemoryAccounting instance;
+        return instance;
+    }
+
+    // 登记探针：owner 销毁时自动注销；探针只在界面线程调用
+    void registerProbe(const QString& subsystem, const QString& name, QObject *owner,
+                       std::function<MemorySample()> probe);
+    // 子系统超出预算时的回收函数（如丢弃不可见页面的缓存），owner 销毁时自动注销
+    void registerTrimHandler(const QString& subsystem, QObject *owner, std::function<void()> handler);
+
+    // 临时缓冲记账（线程安全，按增量累加），一般通过 MemoryCharge 使用
+    void charge(const QString& subsystem, const QString& name, qint64 deltaBytes, qint64 deltaItems);
+
+    // 预算（字节，<=0 表示不限）；"process" 为进程常驻集预算
+    void setBudget(const QString& subsystem, qint64 bytes);
+    qint64 budget(const QString& subsystem) const;
+    // 从 ini 的 [memory] 段读取预算（<子系统>_mb）与检查间隔（check_interval_ms），启动定时检查
+    void loadBudgets(const QString& iniPath);
+
+    // 采样全部探针并合并临时缓冲（界面线程调用）
+    QList<MemoryCounter> sample();
+    static ProcessMemory processMemory();
+    static QString formatBytes(qint64 bytes);
+
+    // 采样结果、进程内存与预算的 JSON 快照
+    QJsonObject toJson();
+    bool writeJson(const QString& filePath, QString *errorMessage = nullptr);
+
+public slots:
+    // 采样并检查预算；超出时发出信号并回收
+    void check();
+
+signals:
+    void budgetExceeded(const QString& subsystem, qint64 bytes, qint64 budget);
+
+private:
+    MemoryAccounting();
+    MemoryAccounting(const MemoryAccounting&) = delete;
+    MemoryAccounting& operator=(const MemoryAccounting&) = delete;
+
+    struct Probe {
+        QString subsystem;
+        QString name;
+        QPointer<QObject> owner;
+        std::function<MemorySample()> probe;
+    };
+    struct TrimHandler {
+        QString subsystem;
+        QPointer<QObject> owner;
+        std::function<void()> handler;
+    };
+    static QString key(const QString& subsystem, const QString& name) { return subsystem + '/' + name; }
+
+    QList<Probe> m_probes;
+    QList<TrimHandler> m_trimHandlers;
+    QHash<QString, qint64> m_peaks;       // 计数项 -> 峰值字节（界面线程）
+    QHash<QString, qint64> m_budgets;
+    QSet<QString> m_overBudget;           // 已报告超出的子系统，回落后才再次报告
+
+    mutable QMutex m_chargeMutex;         // 保护临时缓冲计数（工作线程写）
+    QHash<QString, MemoryCounter> m_charges;
+    QTimer m_checkTimer;
+};
+
+// 临时缓冲记账（RAII）：构造时计入，update 调整，析构时扣除
+class MemoryCharge
+{
+public:
+    MemoryCharge(const QString& subsystem, const QString& name, qint64 bytes = 0, qint64 items = 0);
+    ~MemoryCharge();
+    void update(qint64 bytes, qint64 items);
+
+private:
+    MemoryCharge(const MemoryCharge&) = delete;
+    MemoryCharge& operator=(const MemoryCharge&) = delete;
+
+    QString m_subsystem;
+    QString m_name;
+    qint64 m_bytes = 0;
+    qint64 m_items = 0;
+};
+
+#endif // MEMORYACCOUNTING_H
@@ -0,0 +1,121 @@
+#include "memorydiagnosticsdialog.h"
+#include "memoryaccounting.h"
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QDateTime>
+#include <QMap>
+
+MemoryDiagnosticsDialog::MemoryDiagnosticsDialog(QWidget *parent)
+    : QDialog(parent)
+    , m_table(new QTableWidget(this))
+    , m_labProcess(new QLabel(this))
+{
+    setWindowTitle("内存诊断");
+    resize(760, 480);
+
+    m_table->setColumnCount(6);
+    m_table->setHorizontalHeaderLabels({"子系统", "计数项", "条目数", "估算内存", "峰值", "预算"});
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->horizontalHeader()->setStretchLastSection(true);
+
+    QPushButton *btnRefresh = new QPushButton("刷新", this);
+    QPushButton *btnCheck = new QPushButton("检查预算并回收", this);
+    QPushButton *btnExport = new QPushButton("导出 JSON...", this);
+    connect(btnRefresh, &QPushButton::clicked, this, &MemoryDiagnosticsDialog::refresh);
+    connect(btnCheck, &QPushButton::clicked, this, [this]() {
+        MemoryAccounting::getInstance().check();
+        refresh();
+    });
+    connect(btnExport, &QPushButton::clicked, this, &MemoryDiagnosticsDialog::exportJson);
+
+    QHBoxLayout *buttons = new QHBoxLayout();
+    buttons->addWidget(m_labProcess, 1);
+    buttons->addWidget(btnRefresh);
+    buttons->addWidget(btnCheck);
+    buttons->addWidget(btnExport);
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(buttons);
+    layout->addWidget(m_table);
+
+    // 打开期间每秒刷新，便于观察切换页面/导出时的变化
+    connect(&m_refreshTimer, &QTimer::timeout, this, &MemoryDiagnosticsDialog::refresh);
+    m_refreshTimer.start(1000);
+    refresh();
+}
+
+void MemoryDiagnosticsDialog::refresh()
+{
+    MemoryAccounting& accounting = MemoryAccounting::getInstance();
+    const QList<MemoryCounter> counters = accounting.sample();
+
+    // 按子系统分组，每组先列合计行（带预算），再列各计数项
+    QMap<QString, QList<MemoryCounter>> groups;
+    for (const MemoryCounter& counter : counters) groups[counter.subsystem].append(counter);
+    int rows = 0;
+    for (const QList<MemoryCounter>& group : std::as_const(groups)) rows += group.size() + 1;
+
+    m_table->setRowCount(rows);
+    int row = 0;
+    qint64 accounted = 0;
+    auto setRow = [this](int row, const QStringList& texts, bool bold, bool over) {
+        for (int col = 0; col < texts.size(); col++) {
+            QTableWidgetItem *item = new QTableWidgetItem(texts.at(col));
+            if (col >= 2) item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            if (bold) {
+                QFont font = item->font();
+                font.setBold(true);
+                item->setFont(font);
+            }
+            if (over) item->setForeground(Qt::red);
+            m_table->setItem(row, col, item);
+        }
+    };
+    for (auto it = groups.cbegin(); it != groups.cend(); ++it) {
+        qint64 total = 0;
+        qint64 items = 0;
+        for (const MemoryCounter& counter : it.value()) {
+            total += counter.bytes;
+            items += counter.items;
+        }
+        accounted += total;
+        qint64 budget = accounting.budget(it.key());
+        setRow(row++, {it.key(), "合计", QString::number(items), MemoryAccounting::formatBytes(total), QString(),
+                       budget > 0 ? MemoryAccounting::formatBytes(budget) : QString("不限")},
+               true, budget > 0 && total > budget);
+        for (const MemoryCounter& counter : it.value()) {
+            setRow(row++, {QString(), counter.transient ? counter.name + "（临时）" : counter.name,
+                           QString::number(counter.items), MemoryAccounting::formatBytes(counter.bytes),
+                           MemoryAccounting::formatBytes(counter.peakBytes), QString()},
+                   false, false);
+        }
+    }
+    m_table->resizeColumnsToContents();
+
+    ProcessMemory process = MemoryAccounting::processMemory();
+    qint64 processBudget = accounting.budget("process");
+    m_labProcess->setText(QString("进程常驻内存 %1（峰值 %2，预算 %3）；已记账 %4")
+                              .arg(MemoryAccounting::formatBytes(process.rss),
+                                   MemoryAccounting::formatBytes(process.peakRss),
+                                   processBudget > 0 ? MemoryAccounting::formatBytes(processBudget) : QString("不限"),
+                                   MemoryAccounting::formatBytes(accounted)));
+}
+
+void MemoryDiagnosticsDialog::exportJson()
+{
+    QString defaultName = QString("memory_%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+    QString filePath = QFileDialog::getSaveFileName(this, "导出内存诊断", defaultName, "JSON 文件 (*.json)");
+    if (filePath.isEmpty()) return;
+
+    QString error;
+    if (!MemoryAccounting::getInstance().writeJson(filePath, &error)) {
+        QMessageBox::critical(this, "错误", "导出失败：" + error);
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef MEMORYDIAGNOSTICSDIALOG_H
+#define MEMORYDIAGNOSTICSDIALOG_H
+
+#include <QDialog>
+#include <QTimer>
+
+class QTableWidget;
+class QLabel;
+
+// 内存诊断：按子系统列出各计数项的条目数、估算内存、峰值与预算，显示进程常驻集，可导出 JSON
+class MemoryDiagnosticsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit MemoryDiagnosticsDialog(QWidget *parent = nullptr);
+
+private slots:
+    void refresh();
+    void exportJson();
+
+private:
+    QTableWidget *m_table;
+    QLabel *m_labProcess;
+    QTimer m_refreshTimer;
+};
+
+#endif // MEMORYDIAGNOSTICSDIALOG_H
@@ -0,0 +1,151 @@
+#include "resultset.h"
+#include <QCollator>
+#include <QHash>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+// ========== 字符串竞技场 ==========
+QStringView StringArena::store(QStringView text)
+{
+    qsizetype length = text.size();
+    if (length == 0) return QStringView();
+
+    // 当前块放不下时新开一块；超长字符串单独一块
+    if (m_blocks.empty() || m_used + length > m_blockSizes.back()) {
+        qsizetype size = qMax(m_blockChars, length);
+        m_blocks.emplace_back(new char16_t[size]);
+        m_blockSizes.push_back(size);
+        m_used = 0;
+    }
+    char16_t *target = m_blocks.back().get() + m_used;
+    std::memcpy(target, text.utf16(), length * sizeof(char16_t));
+    m_used += length;
+    return QStringView(target, length);
+}
+
+void StringArena::clear()
+{
+    m_blocks.clear();
+    m_blockSizes.clear();
+    m_used = 0;
+}
+
+qsizetype StringArena::allocatedBytes() const
+{
+    qsizetype total = 0;
+    for (qsizetype size : m_blockSizes) total += size * qsizetype(sizeof(char16_t));
+    return total;
+}
+
+// ========== 结果集 ==========
+ResultSet::ResultSet(const QList<ColumnType>& types)
+    : m_types(types)
+    , m_columns(types.size())
+{
+}
+
+ResultSet ResultSet::fromQuery(QSqlQuery& query, const QList<ColumnType>& types)
+{
+    ResultSet result(types);
+    // 前向读取时驱动不缓存已读行，结果只在结果集中保存一份
+    while (query.next()) {
+        result.appendRow(query);
+    }
+    return result;
+}
+
+void ResultSet::appendRow(const QSqlQuery& query)
+{
+    for (int column = 0; column < m_types.size(); column++) {
+        Column& target = m_columns[column];
+        QVariant value = query.value(column);
+        bool null = value.isNull();
+        target.nulls.push_back(null);
+
+        switch (m_types.at(column)) {
+        case Integer:
+        case Date:
+            target.integers.append(null ? 0 : value.toLongLong());
+            break;
+        case Real:
+            target.reals.append(null ? 0.0 : value.toDouble());
+            break;
+        case Text:
+            target.texts.append(null ? QStringView() : m_arena.store(value.toString()));
+            break;
+        }
+    }
+    m_rowCount++;
+}
+
+QDate ResultSet::date(qsizetype row, int column) const
+{
+    return isNull(row, column) ? QDate() : QDate::fromJulianDay(integer(row, column));
+}
+
+QString ResultSet::displayText(qsizetype row, int column) const
+{
+    if (isNull(row, column)) return QString();
+    switch (m_types.at(column)) {
+    case Integer:
+        return QString::number(integer(row, column));
+    case Real:
+        return QString::number(real(row, column));
+    case Date:
+        return date(row, column).toString("yyyy-MM-dd");
+    case Text:
+        return text(row, column).toString();
+    }
+    return QString();
+}
+
+std::vector<qsizetype> ResultSet::collatedOrder(int column, const QCollator& collator, Qt::SortOrder order) const
+{
+    QHash<QStringView, int> slotOf; // 文本视图指向竞技场，结果集存活期间有效
+    std::vector<QCollatorSortKey> keys;
+    std::vector<int> rowSlots(size_t(m_rowCount));
+    for (qsizetype row = 0; row < m_rowCount; row++) {
+        QStringView value = text(row, column);
+        auto it = slotOf.constFind(value);
+        if (it == slotOf.cend()) {
+            it = slotOf.insert(value, int(keys.size()));
+            keys.push_back(collator.sortKey(value.toString()));
+        }
+        rowSlots[size_t(row)] = it.value();
+    }
+
+    std::vector<qsizetype> rows(size_t(m_rowCount));
+    std::iota(rows.begin(), rows.end(), qsizetype(0));
+    std::stable_sort(rows.begin(), rows.end(), [&](qsizetype a, qsizetype b) {
+        int cmp = keys[size_t(rowSlots[size_t(a)])].compare(keys[size_t(rowSlots[size_t(b)])]);
+        return order == Qt::AscendingOrder ? cmp < 0 : cmp > 0;
+    });
+    return rows;
+}
+
+ResultSet::ColumnView<qint64> ResultSet::integerColumn(int column) const
+{
+    const QVector<qint64>& values = m_columns[column].integers;
+    return {values.constData(), values.size()};
+}
+
+ResultSet::ColumnView<double> ResultSet::realColumn(int column) const
+{
+    const QVector<double>& values = m_columns[column].reals;
+    return {values.constData(), values.size()};
+}
+
+qsizetype ResultSet::memoryUsage() const
+{
+    qsizetype total = m_arena.allocatedBytes();
+    for (const Column& column : m_columns) {
+        total += column.integers.capacity() * qsizetype(sizeof(qint64))
+                 + column.reals.capacity() * qsizetype(sizeof(double))
+                 + column.texts.capacity() * qsizetype(sizeof(QStringView))
+                 + qsizetype(column.nulls.capacity() / 8);
+    }
+    return total;
+}
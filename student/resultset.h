@@ -0,0 +1,96 @@
+#ifndef RESULTSET_H
+#define RESULTSET_H
+
+#include <QString>
+#include <QStringView>
+#include <QDate>
+#include <QVector>
+#include <QList>
+#include <memory>
+#include <vector>
+
+class QSqlQuery;
+class QCollator;
+
+// 字符串竞技场：按块顺序分配（bump），单元格只记录偏移，整块一起释放
+class StringArena
+{
+public:
+    explicit StringArena(qsizetype blockChars = 32 * 1024) : m_blockChars(blockChars) {}
+
+    // 复制进竞技场，返回的视图在竞技场存活期间有效
+    QStringView store(QStringView text);
+    void clear();
+    // 已申请的字节数（含块内未用空间）
+    qsizetype allocatedBytes() const;
+
+private:
+    qsizetype m_blockChars;
+    qsizetype m_used = 0; // 当前块已用字符数
+    std::vector<std::unique_ptr<char16_t[]>> m_blocks;
+    std::vector<qsizetype> m_blockSizes;
+};
+
+// 查询结果集：定长列（整数/实数/日期）按列连续存放，文本列存入字符串竞技场，
+// 读取返回零拷贝视图，避免每个单元格一个 QString/QVariant
+class ResultSet
+{
+public:
+    enum ColumnType { Integer, Real, Date, Text };
+
+    // 定长列的只读视图
+    template <typename T>
+    struct ColumnView {
+        const T *data = nullptr;
+        qsizetype size = 0;
+        const T *begin() const { return data; }
+        const T *end() const { return data + size; }
+        const T& operator[](qsizetype i) const { return data[i]; }
+    };
+
+    ResultSet() = default;
+    explicit ResultSet(const QList<ColumnType>& types);
+    ResultSet(ResultSet&&) = default;
+    ResultSet& operator=(ResultSet&&) = default;
+
+    // 逐行读取查询结果；列数以 types 为准，多余列忽略
+    static ResultSet fromQuery(QSqlQuery& query, const QList<ColumnType>& types);
+
+    qsizetype rowCount() const { return m_rowCount; }
+    int columnCount() const { return m_types.size(); }
+    ColumnType columnType(int column) const { return m_types.at(column); }
+
+    bool isNull(qsizetype row, int column) const { return m_columns[column].nulls[row]; }
+    qint64 integer(qsizetype row, int column) const { return m_columns[column].integers[row]; }
+    double real(qsizetype row, int column) const { return m_columns[column].reals[row]; }
+    QDate date(qsizetype row, int column) const;
+    QStringView text(qsizetype row, int column) const { return m_columns[column].texts[row]; }
+    // 任意列的显示文本（导出用），日期为 yyyy-MM-dd
+    QString displayText(qsizetype row, int column) const;
+
+    // 按文本列排序后的行号序列（稳定排序，每个不同文本只算一次排序键），用于按语言规则排列导出行
+    std::vector<qsizetype> collatedOrder(int column, const QCollator& collator, Qt::SortOrder order) const;
+
+    ColumnView<qint64> integerColumn(int column) const;
+    ColumnView<double> realColumn(int column) const;
+
+    // 结果集占用的堆内存（字节）
+    qsizetype memoryUsage() const;
+
+private:
+    struct Column {
+        QVector<qint64> integers; // Integer / Date（儒略日）
+        QVector<double> reals;    // Real
+        QVector<QStringView> texts; // Text，指向竞技场（块地址固定，结果集移动后仍有效）
+        std::vector<bool> nulls;
+    };
+
+    void appendRow(const QSqlQuery& query);
+
+    QList<ColumnType> m_types;
+    std::vector<Column> m_columns;
+    qsizetype m_rowCount = 0;
+    StringArena m_arena;
+};
+
+#endif // RESULTSET_H
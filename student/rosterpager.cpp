@@ -0,0 +1,62 @@
+#include "rosterpager.h"
+#include "dbmanager.h"
+#include "schema.h"
+#include <limits>
+
+RosterPager::RosterPager(const QString& className, int pageSize)
+    : m_className(className)
+    , m_pageSize(pageSize > 0 ? pageSize : DBManager::getInstance().config().rosterPageSize)
+    , m_lastId(std::numeric_limits<qint64>::min())
+{
+}
+
+QList<RosterRow> RosterPager::nextPage()
+{
+    QList<RosterRow> rows;
+    if (m_atEnd) return rows;
+
+    using Schema::Students;
+    using Roster = Schema::Select<Students, Students::StudentId, Students::StudentName, Students::ClassName>;
+    DBManager& db = DBManager::getInstance();
+    const QString idColumn = Schema::columnName<Students>(Students::StudentId);
+    QString where = idColumn + " > ?";
+    if (!m_className.isEmpty()) where += " AND " + Schema::columnName<Students>(Students::ClassName) + " = ?";
+    QString sql = Roster::sql(where) + " ORDER BY " + idColumn + db.dialect().limitClause(m_pageSize);
+
+    QSqlQuery query(db.threadConnection());
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    query.addBindValue(m_lastId);
+    if (!m_className.isEmpty()) query.addBindValue(m_className);
+    if (!query.exec()) {
+        m_lastError = query.lastError().text();
+        m_atEnd = true;
+        return rows;
+    }
+
+    rows.reserve(m_pageSize);
+    while (query.next()) {
+        rows.append({query.value(Roster::at<Students::StudentId>()).toLongLong(),
+                     query.value(Roster::at<Students::StudentName>()).toString(),
+                     query.value(Roster::at<Students::ClassName>()).toString()}); // NULL 班级读为空串
+    }
+    if (!rows.isEmpty()) m_lastId = rows.last().studentId;
+    m_atEnd = rows.size() < m_pageSize;
+    return rows;
+}
+
+QStringList RosterPager::classNames()
+{
+    QStringList classes;
+    QSqlQuery query(DBManager::getInstance().threadConnection());
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT DISTINCT class_name FROM students WHERE class_name IS NOT NULL ORDER BY class_name")) {
+        qCritical() << "查询班级失败：" << query.lastError().text();
+        return classes;
+    }
+    while (query.next()) {
+        QString className = query.value(0).toString().trimmed();
+        if (!className.isEmpty()) classes << className;
+    }
+    return classes;
+}
@@ -0,0 +1,38 @@
+#ifndef ROSTERPAGER_H
+#define ROSTERPAGER_H
+
+#include <QString>
+#include <QList>
+
+struct RosterRow {
+    qint64 studentId;
+    QString name;
+    QString className;
+};
+
+// 学生名单分页读取：按 student_id 键集翻页（WHERE student_id > 上一页末尾 LIMIT n），
+// 每页都是一次索引定位，不使用 OFFSET，也不保留打开的游标；可按班级筛选
+class RosterPager
+{
+public:
+    // className 为空表示全部班级；pageSize <= 0 时使用配置中的页大小
+    explicit RosterPager(const QString& className = QString(), int pageSize = 0);
+
+    // 读取下一页；已读完时返回空列表
+    QList<RosterRow> nextPage();
+    bool atEnd() const { return m_atEnd; }
+    int pageSize() const { return m_pageSize; }
+    QString lastError() const { return m_lastError; }
+
+    // 有学生的班级（走 idx_students_class 索引）
+    static QStringList classNames();
+
+private:
+    QString m_className;
+    int m_pageSize;
+    qint64 m_lastId;
+    bool m_atEnd = false;
+    QString m_lastError;
+};
+
+#endif // ROSTERPAGER_H
@@ -0,0 +1,211 @@
+#ifndef SCHEMA_H
+#define SCHEMA_H
+
+#include <QString>
+#include <QStringList>
+#include <QDate>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <array>
+#include <utility>
+
+// ========== 编译期表结构描述 ==========
+// 每张表一个描述结构：表名、列枚举（取值即物理列序）、列名数组、类型化行结构。
+// 列下标在编译期确定，热点代码不再按列名/表头文字查找；
+// 启动时 DBManager 用 verify() 核对实际表结构，列序漂移会直接报错。
+namespace Schema {
+
+template <typename Table>
+inline QString tableName() { return QString::fromLatin1(Table::name); }
+
+template <typename Table>
+inline QString columnName(typename Table::Column column) { return QString::fromLatin1(Table::columns[column]); }
+
+// 带表名/别名限定的列名，如 scores_all.score
+template <typename Table>
+inline QString qualified(const QString& alias, typename Table::Column column)
+{
+    return alias + '.' + columnName<Table>(column);
+}
+
+// ========== 投影：一次查询选取的列 ==========
+// Select<Scores, Scores::Score, Scores::ExamDate>::at<Scores::ExamDate>() == 1，
+// 取未选取的列在编译期报错
+template <typename Table, typename Table::Column... Cols>
+struct Select {
+    static constexpr int count = sizeof...(Cols);
+    static constexpr std::array<typename Table::Column, sizeof...(Cols)> columns{{Cols...}};
+
+    template <typename Table::Column C>
+    static constexpr int at()
+    {
+        constexpr int pos = position(C);
+        static_assert(pos >= 0, "列不在本次查询的投影中");
+        return pos;
+    }
+
+    static QString columnList(const QString& alias = QString())
+    {
+        QStringList names;
+        for (auto column : columns) {
+            names << (alias.isEmpty() ? columnName<Table>(column) : qualified<Table>(alias, column));
+        }
+        return names.join(", ");
+    }
+
+    // SELECT 列... FROM 表 [where]
+    static QString sql(const QString& where = QString(), const QString& from = QString())
+    {
+        QString result = QString("SELECT %1 FROM %2").arg(columnList(), from.isEmpty() ? tableName<Table>() : from);
+        if (!where.isEmpty()) result += " WHERE " + where;
+        return result;
+    }
+
+    // INSERT INTO 表 (列...) VALUES (?, ...)
+    static QString insertSql(const QString& table = QString())
+    {
+        QStringList marks;
+        for (int i = 0; i < count; i++) marks << "?";
+        return QString("INSERT INTO %1 (%2) VALUES (%3)")
+            .arg(table.isEmpty() ? tableName<Table>() : table, columnList(), marks.join(", "));
+    }
+
+private:
+    static constexpr int position(typename Table::Column column)
+    {
+        for (int i = 0; i < count; i++) {
+            if (columns[i] == column) return i;
+        }
+        return -1;
+    }
+};
+
+namespace detail {
+template <typename Table, typename Seq> struct SelectAllImpl;
+template <typename Table, std::size_t... I>
+struct SelectAllImpl<Table, std::index_sequence<I...>> {
+    using type = Select<Table, static_cast<typename Table::Column>(I)...>;
+};
+}
+
+// 按物理列序选取全部列，下标与列枚举一致，可配合 Table::read 读整行
+template <typename Table>
+using SelectAll = typename detail::SelectAllImpl<Table, std::make_index_sequence<Table::ColumnCount>>::type;
+
+// 核对实际列序与描述一致（record 取自 QSqlDatabase::record(表名)）
+template <typename Table>
+inline bool verify(const QSqlRecord& record, const QString& table, QString *errorMessage)
+{
+    for (int i = 0; i < Table::ColumnCount; i++) {
+        if (record.indexOf(Table::columns[i]) != i) {
+            if (errorMessage) {
+                *errorMessage = QString("表 %1 的列 %2 应在第 %3 列，实际为 %4")
+                                    .arg(table, QString::fromLatin1(Table::columns[i]))
+                                    .arg(i).arg(record.indexOf(Table::columns[i]));
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+// ========== students ==========
+struct Students {
+    static constexpr const char *name = "students";
+    enum Column { StudentId, StudentName, ClassName, Gender, ColumnCount };
+    static constexpr std::array<const char *, ColumnCount> columns{{"student_id", "student_name", "class_name", "gender"}};
+
+    struct Row {
+        qint64 studentId = 0;
+        QString studentName;
+        QString className;
+        QString gender;
+    };
+    // 读取 SelectAll<Students> 的当前行
+    static Row read(const QSqlQuery& query)
+    {
+        return {query.value(StudentId).toLongLong(), query.value(StudentName).toString(),
+                query.value(ClassName).toString(), query.value(Gender).toString()};
+    }
+};
+
+// ========== courses ==========
+struct Courses {
+    static constexpr const char *name = "courses";
+    enum Column { CourseId, CourseName, CourseType, Credit, ColumnCount };
+    static constexpr std::array<const char *, ColumnCount> columns{{"course_id", "course_name", "course_type", "credit"}};
+
+    struct Row {
+        int courseId = -1;
+        QString courseName;
+        QString courseType;
+        double credit = 1;  // 学分（v2 新增）
+    };
+    static Row read(const QSqlQuery& query)
+    {
+        return {query.value(CourseId).toInt(), query.value(CourseName).toString(), query.value(CourseType).toString(),
+                query.value(Credit).toDouble()};
+    }
+};
+
+// ========== scores（主表、学期分区表与 scores_all 视图列序相同） ==========
+struct Scores {
+    static constexpr const char *name = "scores";
+    enum Column { ScoreId, Score, ExamDate, StudentId, CourseId, ColumnCount };
+    static constexpr std::array<const char *, ColumnCount> columns{{"score_id", "score", "exam_date", "student_id", "course_id"}};
+
+    struct Row {
+        qint64 scoreId = -1;
+        double score = 0;
+        QDate examDate;     // 存储为儒略日整数
+        qint64 studentId = 0;
+        int courseId = -1;
+    };
+    static Row read(const QSqlQuery& query)
+    {
+        QVariant day = query.value(ExamDate);
+        return {query.value(ScoreId).toLongLong(), query.value(Score).toDouble(),
+                day.isNull() ? QDate() : QDate::fromJulianDay(day.toLongLong()),
+                query.value(StudentId).toLongLong(), query.value(CourseId).toInt()};
+    }
+};
+
+// ========== users ==========
+struct Users {
+    static constexpr const char *name = "users";
+    enum Column { UserId, Password, Username, UserType, ColumnCount };
+    static constexpr std::array<const char *, ColumnCount> columns{{"user_id", "password", "username", "user_type"}};
+
+    struct Row {
+        qint64 userId = 0;
+        QString password;   // PBKDF2 哈希（旧数据为MD5）
+        QString username;
+        QString userType;
+    };
+    static Row read(const QSqlQuery& query)
+    {
+        return {query.value(UserId).toLongLong(), query.value(Password).toString(),
+                query.value(Username).toString(), query.value(UserType).toString()};
+    }
+};
+
+// ========== grade_points（绩点对照，按最低分降序匹配） ==========
+struct GradePoints {
+    static constexpr const char *name = "grade_points";
+    enum Column { MinScore, Points, Label, ColumnCount };
+    static constexpr std::array<const char *, ColumnCount> columns{{"min_score", "points", "label"}};
+
+    struct Row {
+        double minScore = 0;
+        double points = 0;
+        QString label;
+    };
+    static Row read(const QSqlQuery& query)
+    {
+        return {query.value(MinScore).toDouble(), query.value(Points).toDouble(), query.value(Label).toString()};
+    }
+};
+
+} // namespace Schema
+
+#endif // SCHEMA_H
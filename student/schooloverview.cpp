@@ -0,0 +1,100 @@
+#include "schooloverview.h"
+#include "dbmanager.h"
+#include <QtConcurrent>
+#include <QThreadPool>
+#include <cmath>
+
+// 每个线程分到的分片数：分片多于线程，先做完的线程继续从队列取下一片，避免数据倾斜时空等
+static const int kRangesPerThread = 4;
+
+void OverviewCell::merge(const OverviewCell& other)
+{
+    count += other.count;
+    total += other.total;
+    totalSq += other.totalSq;
+    minScore = qMin(minScore, other.minScore);
+    maxScore = qMax(maxScore, other.maxScore);
+    passed += other.passed;
+}
+
+double OverviewCell::stddev() const
+{
+    if (count <= 0) return 0;
+    double mean = total / count;
+    return std::sqrt(qMax(0.0, totalSq / count - mean * mean));
+}
+
+QFuture<OverviewResult> SchoolOverview::start(const QDate& from, const QDate& to, int parallelism)
+{
+    DBManager& db = DBManager::getInstance();
+    // 并行度受后端可用读连接数限制（服务器按连接池大小）
+    if (parallelism <= 0) parallelism = db.readerConnections();
+
+    // score_id 是整数主键（rowid），按范围扫描直接走B树，分片边界只需 MIN/MAX 两次查找
+    QList<ScanRange> ranges;
+    for (const QString& table : db.scoreTables(from, to)) {
+        QSqlQuery bounds(db.m_db);
+        if (!bounds.exec(QString("SELECT MIN(score_id), MAX(score_id) FROM %1").arg(table)) || !bounds.next()
+            || bounds.value(0).isNull()) {
+            continue;
+        }
+        qint64 firstId = bounds.value(0).toLongLong();
+        qint64 lastId = bounds.value(1).toLongLong();
+        qint64 pieces = qMax<qint64>(1, qMin<qint64>(qint64(parallelism) * kRangesPerThread, lastId - firstId + 1));
+        qint64 step = (lastId - firstId + pieces) / pieces;
+        for (qint64 lo = firstId; lo <= lastId; lo += step) {
+            ranges.append({table, lo, qMin(lastId, lo + step - 1), from, to});
+        }
+    }
+
+    // 专用线程池：线程数即同时打开的读连接数
+    static QThreadPool pool;
+    pool.setMaxThreadCount(parallelism);
+    return QtConcurrent::mappedReduced<OverviewResult>(&pool, ranges, &SchoolOverview::scanRange,
+                                                       &SchoolOverview::mergeResult,
+                                                       QtConcurrent::UnorderedReduce);
+}
+
+OverviewResult SchoolOverview::scanRange(const ScanRange& range)
+{
+    OverviewResult partial;
+    partial.tasks = 1;
+
+    QSqlQuery query(DBManager::getInstance().threadConnection());
+    query.setForwardOnly(true);
+    query.prepare(QString("SELECT COALESCE(st.class_name, ''), sc.course_id, COUNT(*), SUM(sc.score), "
+                          "SUM(sc.score * sc.score), MIN(sc.score), MAX(sc.score), "
+                          "SUM(CASE WHEN sc.score >= 60 THEN 1 ELSE 0 END) "
+                          "FROM %1 sc LEFT JOIN students st ON st.student_id = sc.student_id "
+                          "WHERE sc.score_id BETWEEN ? AND ? AND sc.course_id IS NOT NULL%2 "
+                          "GROUP BY 1, 2")
+                      .arg(range.table, DBManager::dateRangeSql("sc.exam_date", range.from, range.to)));
+    query.addBindValue(range.firstId);
+    query.addBindValue(range.lastId);
+    if (!query.exec()) {
+        partial.error = query.lastError().text();
+        return partial;
+    }
+    while (query.next()) {
+        OverviewCell cell;
+        cell.count = query.value(2).toLongLong();
+        cell.total = query.value(3).toDouble();
+        cell.totalSq = query.value(4).toDouble();
+        cell.minScore = query.value(5).toDouble();
+        cell.maxScore = query.value(6).toDouble();
+        cell.passed = query.value(7).toLongLong();
+        partial.cells[{query.value(0).toString(), query.value(1).toInt()}].merge(cell);
+        partial.scannedRows += cell.count;
+    }
+    return partial;
+}
+
+void SchoolOverview::mergeResult(OverviewResult& result, const OverviewResult& partial)
+{
+    for (auto it = partial.cells.cbegin(); it != partial.cells.cend(); ++it) {
+        result.cells[it.key()].merge(it.value());
+    }
+    result.scannedRows += partial.scannedRows;
+    result.tasks += partial.tasks;
+    if (result.error.isEmpty()) result.error = partial.error;
+}
@@ -0,0 +1,58 @@
+#ifndef SCHOOLOVERVIEW_H
+#define SCHOOLOVERVIEW_H
+
+#include <QString>
+#include <QDate>
+#include <QHash>
+#include <QPair>
+#include <QFuture>
+#include <limits>
+
+// 一个 班级×科目 单元的聚合值，可与其他分片的部分结果合并
+struct OverviewCell {
+    qint64 count = 0;
+    double total = 0;
+    double totalSq = 0;
+    double minScore = std::numeric_limits<double>::max();
+    double maxScore = std::numeric_limits<double>::lowest();
+    qint64 passed = 0;   // 60分及以上
+
+    void merge(const OverviewCell& other);
+    double mean() const { return count > 0 ? total / count : 0; }
+    double stddev() const;
+    double passRate() const { return count > 0 ? double(passed) / count : 0; }
+};
+
+using OverviewKey = QPair<QString, int>; // 班级名、course_id
+
+// 部分/最终结果
+struct OverviewResult {
+    QHash<OverviewKey, OverviewCell> cells;
+    qint64 scannedRows = 0;
+    int tasks = 0;
+    QString error;
+};
+
+// 全校总览：按 score_id 键范围把各成绩表切成若干分片，线程池并行扫描，
+// 每个工作线程用自己的数据库连接（WAL下读互不阻塞），最后合并部分聚合
+class SchoolOverview
+{
+public:
+    // 在主线程规划分片后立即返回；结果通过 QFuture 取得。parallelism 为0时按后端读连接数
+    static QFuture<OverviewResult> start(const QDate& from, const QDate& to, int parallelism = 0);
+
+    // 分片：某个成绩表中 score_id ∈ [firstId, lastId]
+    struct ScanRange {
+        QString table;
+        qint64 firstId;
+        qint64 lastId;
+        QDate from;
+        QDate to;
+    };
+
+private:
+    static OverviewResult scanRange(const ScanRange& range);
+    static void mergeResult(OverviewResult& result, const OverviewResult& partial);
+};
+
+#endif // SCHOOLOVERVIEW_H
@@ -0,0 +1,84 @@
+#include "schooloverviewdialog.h"
+#include "dbmanager.h"
+#include <QTableWidget>
+#include <QLabel>
+#include <QVBoxLayout>
+#include <QMap>
+
+SchoolOverviewDialog::SchoolOverviewDialog(const QDate& from, const QDate& to, QWidget *parent)
+    : QDialog(parent)
+    , m_table(new QTableWidget(this))
+    , m_labStatus(new QLabel(this))
+{
+    QString range = (from.isValid() || to.isValid())
+                        ? QString("%1 ~ %2").arg(from.isValid() ? from.toString("yyyy-MM-dd") : "不限",
+                                                 to.isValid() ? to.toString("yyyy-MM-dd") : "不限")
+                        : QString("全部日期");
+    setWindowTitle(QString("全校总览（%1）").arg(range));
+    resize(900, 600);
+
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addWidget(m_labStatus);
+    layout->addWidget(m_table);
+
+    m_labStatus->setText(QString("正在统计（%1 个线程）...").arg(DBManager::getInstance().readerConnections()));
+    connect(&m_watcher, &QFutureWatcher<OverviewResult>::finished, this, &SchoolOverviewDialog::onFinished);
+    m_timer.start();
+    m_watcher.setFuture(SchoolOverview::start(from, to));
+}
+
+SchoolOverviewDialog::~SchoolOverviewDialog()
+{
+    // 关闭对话框时不再合并剩余分片；已开始的分片结束后自然退出
+    m_watcher.cancel();
+    m_watcher.waitForFinished();
+}
+
+void SchoolOverviewDialog::onFinished()
+{
+    if (m_watcher.isCanceled()) return;
+    OverviewResult result = m_watcher.result();
+    if (!result.error.isEmpty()) {
+        m_labStatus->setText("统计失败：" + result.error);
+        return;
+    }
+
+    // 行：班级；列：科目（按名称排序）
+    QMap<QString, int> courses; // 科目名 -> course_id
+    QSqlQuery courseQuery = DBManager::getInstance().execQuery("SELECT course_id, course_name FROM courses");
+    QHash<int, QString> courseNames;
+    while (courseQuery.next()) {
+        courseNames.insert(courseQuery.value(0).toInt(), courseQuery.value(1).toString());
+    }
+    QMap<QString, bool> classes;
+    for (auto it = result.cells.cbegin(); it != result.cells.cend(); ++it) {
+        classes.insert(it.key().first.isEmpty() ? QString("（未分班）") : it.key().first, true);
+        courses.insert(courseNames.value(it.key().second, QString("科目%1").arg(it.key().second)), it.key().second);
+    }
+
+    QStringList classList = classes.keys();
+    QStringList courseList = courses.keys();
+    m_table->setRowCount(classList.size());
+    m_table->setColumnCount(courseList.size());
+    m_table->setVerticalHeaderLabels(classList);
+    m_table->setHorizontalHeaderLabels(courseList);
+
+    for (auto it = result.cells.cbegin(); it != result.cells.cend(); ++it) {
+        const OverviewCell& cell = it.value();
+        int row = classList.indexOf(it.key().first.isEmpty() ? QString("（未分班）") : it.key().first);
+        int col = courseList.indexOf(courseNames.value(it.key().second, QString("科目%1").arg(it.key().second)));
+        QTableWidgetItem *item = new QTableWidgetItem(QString("%1（%2）").arg(cell.mean(), 0, 'f', 1).arg(cell.count));
+        item->setTextAlignment(Qt::AlignCenter);
+        item->setToolTip(QString("平均分：%1\n标准差：%2\n最高分：%3\n最低分：%4\n及格率：%5%")
+                             .arg(cell.mean(), 0, 'f', 2).arg(cell.stddev(), 0, 'f', 2)
+                             .arg(cell.maxScore).arg(cell.minScore)
+                             .arg(cell.passRate() * 100, 0, 'f', 1));
+        m_table->setItem(row, col, item);
+    }
+    m_table->resizeColumnsToContents();
+
+    m_labStatus->setText(QString("共 %1 条成绩，%2 个班级 × %3 个科目；%4 个分片并行扫描，耗时 %5 ms")
+                             .arg(result.scannedRows).arg(classList.size()).arg(courseList.size())
+                             .arg(result.tasks).arg(m_timer.elapsed()));
+}
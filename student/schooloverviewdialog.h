@@ -0,0 +1,32 @@
+#ifndef SCHOOLOVERVIEWDIALOG_H
+#define SCHOOLOVERVIEWDIALOG_H
+
+#include <QDialog>
+#include <QDate>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include "schooloverview.h"
+
+class QTableWidget;
+class QLabel;
+
+// 全校总览：班级×科目 矩阵，单元格显示 平均分（人次），悬停显示标准差/最值/及格率
+class SchoolOverviewDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    SchoolOverviewDialog(const QDate& from, const QDate& to, QWidget *parent = nullptr);
+    ~SchoolOverviewDialog() override;
+
+private slots:
+    void onFinished();
+
+private:
+    QTableWidget *m_table;
+    QLabel *m_labStatus;
+    QFutureWatcher<OverviewResult> m_watcher;
+    QElapsedTimer m_timer;
+};
+
+#endif // SCHOOLOVERVIEWDIALOG_H
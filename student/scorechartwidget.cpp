@@ -2,6 +2,16 @@
 #include "ui_scorechartwidget.h"
 #include <QDebug>
 #include <QSqlError>
+#include <QLegendMarker>
+#include <QFutureWatcher>
+#include <QPromise>
+#include <QtConcurrent>
+#include <QFileDialog>
+#include <QInputDialog>
+#include <QProgressDialog>
+#include "chartexporter.h"
+#include "memoryaccounting.h"
+#include "schema.h"
 
 ScoreChartWidget::ScoreChartWidget(QWidget *parent) :
     QWidget(parent),
@@ -9,11 +19,20 @@ ScoreChartWidget::ScoreChartWidget(QWidget *parent) :
     m_chart(new QChart()),
     m_series(new QLineSeries()),
     m_scatterSeries(new QScatterSeries()),
+    m_meanSeries(new QLineSeries()),
+    m_medianSeries(new QLineSeries()),
+    m_q1Series(new QLineSeries(this)),
+    m_q3Series(new QLineSeries(this)),
+    m_bandSeries(nullptr),
     m_chartView(nullptr),
     m_xAxis(nullptr),
-    m_yAxis(nullptr)
+    m_yAxis(nullptr),
+    m_zoomTimer(new QTimer(this)),
+    m_studentPicker(nullptr)
 {
     ui->setupUi(this);
+    // 学生下拉框改为边输边查，不再一次性加载全部学生
+    m_studentPicker = new StudentPicker(ui->cbStudent);
     this->setWindowTitle("成绩趋势图");
 
     // 序列样式配置
@@ -23,7 +42,35 @@ ScoreChartWidget::ScoreChartWidget(QWidget *parent) :
     m_scatterSeries->setColor(Qt::blue);
     m_scatterSeries->setMarkerSize(6);
 
+    // 班级趋势序列样式（四分位带的上下边界只作为数据源，不单独加入图表）
+    m_meanSeries->setName("班级均值");
+    m_meanSeries->setPen(QPen(Qt::darkBlue, 2));
+    m_medianSeries->setName("中位数");
+    m_medianSeries->setPen(QPen(Qt::darkGreen, 2, Qt::DashLine));
+    m_bandSeries = new QAreaSeries(m_q3Series, m_q1Series);
+    m_bandSeries->setName("四分位区间(Q1-Q3)");
+    m_bandSeries->setPen(Qt::NoPen);
+    m_bandSeries->setBrush(QColor(30, 144, 255, 60));
+
     initChartView();
+
+    ui->cbMode->addItem("个人趋势");
+    ui->cbMode->addItem("班级趋势");
+    setClassMode(false);
+
+    // 框选缩放：松手后稍等再取数，连续缩放只触发一次查询
+    m_zoomTimer->setSingleShot(true);
+    m_zoomTimer->setInterval(250);
+    connect(m_zoomTimer, &QTimer::timeout, this, [this]() { refreshChart(false); });
+    connect(m_xAxis, &QDateTimeAxis::rangeChanged, this, &ScoreChartWidget::onAxisRangeChanged);
+
+    // 序列点数：序列数据与图表绘制项各保存一份坐标
+    MemoryAccounting::getInstance().registerProbe("chart", "图表序列点", this, [this]() {
+        const QXYSeries *allSeries[] = {m_series, m_scatterSeries, m_meanSeries, m_medianSeries, m_q1Series, m_q3Series};
+        qint64 points = 0;
+        for (const QXYSeries *series : allSeries) points += series->count();
+        return MemorySample{points, points * qint64(sizeof(QPointF)) * 2};
+    });
 }
 
 ScoreChartWidget::~ScoreChartWidget()
@@ -39,47 +86,40 @@ ScoreChartWidget::~ScoreChartWidget()
 
 void ScoreChartWidget::initChartView()
 {
-    // 添加序列到图表
+    // 添加序列到图表（四分位带先加入，位于折线下层）
+    m_chart->addSeries(m_bandSeries);
+    m_chart->addSeries(m_meanSeries);
+    m_chart->addSeries(m_medianSeries);
     m_chart->addSeries(m_series);
     m_chart->addSeries(m_scatterSeries);
 
-    // X轴（日期轴）
+    // 坐标轴与图表样式（与离线导出共用）
     m_xAxis = new QDateTimeAxis();
-    m_xAxis->setFormat("yyyy-MM-dd");
-    m_xAxis->setTitleText("考试日期");
-    m_xAxis->setLabelsColor(Qt::black);
-    m_xAxis->setTickCount(5);
-    m_xAxis->setLabelsAngle(-45);
+    m_yAxis = new QValueAxis();
+    applyChartStyle(m_chart, m_xAxis, m_yAxis);
+    m_chart->setAnimationOptions(QChart::SeriesAnimations);
+
+    // X轴（日期轴）
     m_chart->addAxis(m_xAxis, Qt::AlignBottom);
     m_series->attachAxis(m_xAxis);
     m_scatterSeries->attachAxis(m_xAxis);
+    m_bandSeries->attachAxis(m_xAxis);
+    m_meanSeries->attachAxis(m_xAxis);
+    m_medianSeries->attachAxis(m_xAxis);
 
     // Y轴（成绩轴）
-    m_yAxis = new QValueAxis();
-    m_yAxis->setRange(0, 100);
-    m_yAxis->setTitleText("成绩");
-    m_yAxis->setTickCount(11);
-    m_yAxis->setLabelsColor(Qt::black);
-    m_yAxis->setLabelFormat("%d");
     m_chart->addAxis(m_yAxis, Qt::AlignLeft);
     m_series->attachAxis(m_yAxis);
     m_scatterSeries->attachAxis(m_yAxis);
-
-    // 图表样式
-    QFont titleFont("微软雅黑", 14, QFont::Bold);
-    m_chart->setTitleFont(titleFont);
-    QPalette chartPalette = m_chart->palette();
-    chartPalette.setColor(QPalette::WindowText, Qt::darkBlue);
-    m_chart->setPalette(chartPalette);
-    m_chart->setBackgroundBrush(Qt::white);
-    m_chart->legend()->setVisible(true);
-    m_chart->legend()->setAlignment(Qt::AlignRight | Qt::AlignTop);
-    m_chart->setAnimationOptions(QChart::SeriesAnimations);
+    m_bandSeries->attachAxis(m_yAxis);
+    m_meanSeries->attachAxis(m_yAxis);
+    m_medianSeries->attachAxis(m_yAxis);
 
     // 图表视图 + 布局
     m_chartView = new QChartView(m_chart);
     m_chartView->setRenderHint(QPainter::Antialiasing);
     m_chartView->setMinimumSize(800, 500);
+    m_chartView->setRubberBand(QChartView::HorizontalRubberBand); // 左键框选放大，右键缩小
 
     QVBoxLayout *chartLayout = new QVBoxLayout(ui->widgetChartContainer);
     chartLayout->setContentsMargins(0, 0, 0, 0);
@@ -88,36 +128,87 @@ void ScoreChartWidget::initChartView()
     ui->widgetChartContainer->setLayout(chartLayout);
 }
 
-// ========== 新增：加载学生列表到下拉框 ==========
-void ScoreChartWidget::on_btnLoadStudents_clicked()
+// ========== 趋势图统一样式（界面与离线导出共用） ==========
+void ScoreChartWidget::applyChartStyle(QChart *chart, QDateTimeAxis *xAxis, QValueAxis *yAxis)
 {
-    ui->cbStudent->clear();
+    // X轴（日期轴）
+    xAxis->setFormat("yyyy-MM-dd");
+    xAxis->setTitleText("考试日期");
+    xAxis->setLabelsColor(Qt::black);
+    xAxis->setTickCount(5);
+    xAxis->setLabelsAngle(-45);
+
+    // Y轴（成绩轴）
+    yAxis->setRange(0, 100);
+    yAxis->setTitleText("成绩");
+    yAxis->setTickCount(11);
+    yAxis->setLabelsColor(Qt::black);
+    yAxis->setLabelFormat("%d");
 
+    // 图表样式
+    QFont titleFont("微软雅黑", 14, QFont::Bold);
+    chart->setTitleFont(titleFont);
+    QPalette chartPalette = chart->palette();
+    chartPalette.setColor(QPalette::WindowText, Qt::darkBlue);
+    chart->setPalette(chartPalette);
+    chart->setBackgroundBrush(Qt::white);
+    chart->legend()->setVisible(true);
+    chart->legend()->setAlignment(Qt::AlignRight | Qt::AlignTop);
+}
+
+// ========== 刷新学生检索索引与班级列表 ==========
+void ScoreChartWidget::on_btnLoadStudents_clicked()
+{
     // 数据库连接校验
     if (!DBManager::getInstance().m_db.isOpen()) {
         QMessageBox::critical(this, "错误", "数据库未连接！");
         return;
     }
 
-    // 查询学生数据
-    QString sql = "SELECT student_id, student_name FROM students ORDER BY student_id";
-    QSqlQuery query = DBManager::getInstance().execQuery(sql);
-
-    if (query.lastError().isValid()) {
-        QMessageBox::critical(this, "错误", "查询学生失败：" + query.lastError().text());
+    // 学生在 cbStudent 中输入搜索，这里只重建索引
+    m_studentPicker->clearSelection();
+    StudentIndex::getInstance().reload();
+
+    // 班级列表（班级趋势模式使用）
+    ui->cbClass->clear();
+    ui->cbClass->addItem("请选择班级", "");
+    QSqlQuery classQuery = DBManager::getInstance().execQuery(
+        "SELECT DISTINCT class_name FROM students WHERE class_name IS NOT NULL ORDER BY class_name");
+    if (classQuery.lastError().isValid()) {
+        QMessageBox::critical(this, "错误", "查询班级失败：" + classQuery.lastError().text());
         return;
     }
-
-    // 添加默认选项
-    ui->cbStudent->addItem("请选择学生", "");
-    while (query.next()) {
-        QString itemText = QString("%1 - %2").arg(query.value(0).toString(), query.value(1).toString());
-        ui->cbStudent->addItem(itemText, query.value(0).toString());
+    while (classQuery.next()) {
+        QString className = classQuery.value(0).toString().trimmed();
+        if (!className.isEmpty()) {
+            ui->cbClass->addItem(className, className);
+        }
     }
+}
 
-    // 空数据提示
-    if (ui->cbStudent->count() == 1) {
-        QMessageBox::information(this, "提示", "数据库中暂无学生数据！");
+// ========== 切换个人趋势/班级趋势 ==========
+void ScoreChartWidget::on_cbMode_currentIndexChanged(int index)
+{
+    setClassMode(index == 1);
+}
+
+void ScoreChartWidget::setClassMode(bool classMode)
+{
+    ui->cbStudent->setVisible(!classMode);
+    ui->cbClass->setVisible(classMode);
+
+    m_series->setVisible(!classMode);
+    m_scatterSeries->setVisible(!classMode);
+    m_bandSeries->setVisible(classMode);
+    m_meanSeries->setVisible(classMode);
+    m_medianSeries->setVisible(classMode);
+
+    // 图例只保留当前模式的序列
+    const QList<QAbstractSeries*> allSeries = m_chart->series();
+    for (QAbstractSeries *series : allSeries) {
+        for (QLegendMarker *marker : m_chart->legend()->markers(series)) {
+            marker->setVisible(series->isVisible());
+        }
     }
 }
 
@@ -131,7 +222,8 @@ void ScoreChartWidget::on_btnLoadCourses_clicked()
         return;
     }
 
-    QString sql = "SELECT course_id, course_name FROM courses ORDER BY course_id";
+    using Schema::Courses;
+    QString sql = Schema::SelectAll<Courses>::sql() + " ORDER BY " + Schema::columnName<Courses>(Courses::CourseId);
     QSqlQuery query = DBManager::getInstance().execQuery(sql);
 
     if (query.lastError().isValid()) {
@@ -141,8 +233,8 @@ void ScoreChartWidget::on_btnLoadCourses_clicked()
 
     ui->cbCourse->addItem("请选择科目", "");
     while (query.next()) {
-        QString itemText = QString("%1 - %2").arg(query.value(0).toString(), query.value(1).toString());
-        ui->cbCourse->addItem(itemText, query.value(1).toString());
+        Courses::Row course = Courses::read(query);
+        ui->cbCourse->addItem(QString("%1 - %2").arg(course.courseId).arg(course.courseName), course.courseName);
     }
 
     if (ui->cbCourse->count() == 1) {
@@ -150,21 +242,25 @@ void ScoreChartWidget::on_btnLoadCourses_clicked()
     }
 }
 
-// ========== 重构：生成趋势图（支持选择学生） ==========
+// ========== 重构：生成趋势图（支持选择学生/班级） ==========
 void ScoreChartWidget::on_btnGenerateChart_clicked()
 {
-    m_series->clear();
-    m_scatterSeries->clear();
+    bool classMode = ui->cbMode->currentIndex() == 1;
 
-    // 获取选中的学生和科目
-    QString studentId = ui->cbStudent->currentData().toString();
+    // 获取选中的学生/班级和科目
+    QString studentId = m_studentPicker->currentStudentId();
+    QString className = ui->cbClass->currentData().toString();
     QString courseName = ui->cbCourse->currentData().toString();
 
     // 校验选择
-    if (studentId.isEmpty()) {
+    if (!classMode && studentId.isEmpty()) {
         QMessageBox::warning(this, "提示", "请先选择学生！");
         return;
     }
+    if (classMode && className.isEmpty()) {
+        QMessageBox::warning(this, "提示", "请先选择班级！");
+        return;
+    }
     if (courseName.isEmpty()) {
         QMessageBox::warning(this, "提示", "请先选择科目！");
         return;
@@ -176,112 +272,371 @@ void ScoreChartWidget::on_btnGenerateChart_clicked()
         return;
     }
 
-    // 查询该学生该科目的成绩数据
-    QList<QPair<QDate, qreal>> scoreData = queryScoreData(studentId, courseName);
-    if (scoreData.isEmpty()) {
-        QString studentName = getStudentNameById(studentId);
-        m_chart->setTitle(QString("%1 - %2 成绩趋势图（无数据）").arg(studentName, courseName));
-        m_xAxis->setRange(QDateTime::currentDateTime().addDays(-7), QDateTime::currentDateTime());
-        QMessageBox::warning(this, "提示", QString("【%1】的【%2】科目暂无有效成绩数据！").arg(studentName, courseName));
-        return;
-    }
-
-    // 填充数据并记录日期范围
-    QDateTime minDate, maxDate;
-    for (const auto& pair : scoreData) {
-        QDate date = pair.first;
-        qreal score = pair.second;
-
-        QDateTime dateTime = QDateTime(date.isValid() ? date : QDate::currentDate(), QTime(0,0));
-        m_series->append(dateTime.toMSecsSinceEpoch(), score);
-        m_scatterSeries->append(dateTime.toMSecsSinceEpoch(), score);
+    m_hasChart = true;
+    m_chartClassMode = classMode;
+    m_chartStudentId = studentId;
+    m_chartClass = className;
+    m_chartCourse = courseName;
+    refreshChart(true);
+}
 
-        if (minDate.isNull() || dateTime < minDate) minDate = dateTime;
-        if (maxDate.isNull() || dateTime > maxDate) maxDate = dateTime;
+// ========== 共用日期范围变化 ==========
+void ScoreChartWidget::setDateRange(const QDate& from, const QDate& to)
+{
+    m_dateFrom = from;
+    m_dateTo = to;
+    if (m_hasChart) {
+        refreshChart(true);
     }
+}
 
-    // 调整X轴范围
-    if (!minDate.isNull() && !maxDate.isNull()) {
-        minDate = minDate.addDays(-1);
-        maxDate = maxDate.addDays(1);
-        m_xAxis->setRange(minDate, maxDate);
-    } else {
-        m_xAxis->setRange(QDateTime::currentDateTime().addDays(-7), QDateTime::currentDateTime());
+// ========== 重置缩放 ==========
+void ScoreChartWidget::on_btnResetZoom_clicked()
+{
+    if (m_hasChart) {
+        refreshChart(true);
     }
+}
 
-    // 更新图表标题（显示学生姓名+科目）
-    QString studentName = getStudentNameById(studentId);
-    m_chart->setTitle(QString("%1 - %2 成绩趋势图").arg(studentName, courseName));
-    m_chartView->repaint();
+void ScoreChartWidget::onAxisRangeChanged(const QDateTime& /*min*/, const QDateTime& /*max*/)
+{
+    if (m_updatingAxis || !m_hasChart) return;
+    m_zoomTimer->start();
+}
 
-    QMessageBox::information(this, "成功", QString("已生成【%1】的【%2】科目成绩趋势图！").arg(studentName, courseName));
+void ScoreChartWidget::setAxisRange(const QDateTime& min, const QDateTime& max)
+{
+    m_updatingAxis = true;
+    m_xAxis->setRange(min, max);
+    m_updatingAxis = false;
 }
 
-// ========== 重构：按学生+科目查询成绩数据 ==========
-QList<QPair<QDate, qreal>> ScoreChartWidget::queryScoreData(const QString& studentId, const QString& courseName)
+int ScoreChartWidget::maxVisiblePoints() const
 {
-    QList<QPair<QDate, qreal>> dataList;
-
-    // 获取科目ID
-    int courseId = -1;
-    QString getCourseIdSql = "SELECT course_id FROM courses WHERE course_name = ?";
-    QSqlQuery courseQuery;
-    courseQuery.prepare(getCourseIdSql);
-    courseQuery.addBindValue(courseName);
-    if (courseQuery.exec() && courseQuery.next()) {
-        courseId = courseQuery.value(0).toInt();
-    } else {
-        QMessageBox::warning(this, "提示", QString("科目【%1】不存在！").arg(courseName));
-        return dataList;
-    }
+    // 约每4个像素一个点，更密的点在屏幕上无法分辨
+    return qMax(50, int(m_chart->plotArea().width() / 4));
+}
 
-    // 查询该学生该科目的成绩
-    QString sql = R"(
-        SELECT sc.exam_date, sc.score
-        FROM scores sc
-        WHERE sc.student_id = ? AND sc.course_id = ?
-        AND sc.score >= 0 AND sc.score <= 100
-        ORDER BY sc.exam_date ASC
-    )";
+// ========== 后台取数 ==========
+// 查询在线程池中执行（每个线程使用独立连接），结果按批次通过 QPromise 回传，
+// 界面线程收到一批就追加一批，查询期间坐标轴和视图保持可操作。
+static const int kChartBatchSize = 500;
 
-    QSqlQuery query;
+// 个人趋势：只取日期窗口内的数据；窗口内点数不超过绘图区可容纳的点数时原样返回，
+// 超过时才按 (日期-起点)*maxPoints/跨度 分桶取均值，返回的点数不超过 maxPoints
+static void fetchStudentSeries(QPromise<ChartBatch>& promise, const QString& studentId, int courseId,
+                               const QDate& from, const QDate& to, int maxPoints)
+{
+    // 数据源由 DBManager 按学期分区路由
+    QString sql = QString(R"(
+        WITH src AS (
+            SELECT sc.exam_date AS d, sc.score AS s
+            FROM %1 sc
+            WHERE sc.student_id = ? AND sc.course_id = ?
+            AND sc.score >= 0 AND sc.score <= 100 %2
+        ),
+        ext AS (SELECT COUNT(*) AS n, MIN(d) AS lo, MAX(d) AS hi FROM src)
+        SELECT src.d, src.s
+        FROM src, ext
+        WHERE ext.n <= ?
+        UNION ALL
+        SELECT MIN(src.d), AVG(src.s)
+        FROM src, ext
+        WHERE ext.n > ?
+        GROUP BY (src.d - ext.lo) * ? / (ext.hi - ext.lo + 1)
+        ORDER BY 1 ASC
+    )").arg(DBManager::getInstance().scoreSource(from, to),
+            DBManager::dateRangeSql("sc.exam_date", from, to));
+
+    QSqlQuery query(DBManager::getInstance().threadConnection());
+    query.setForwardOnly(true);
     query.prepare(sql);
     query.addBindValue(studentId);
     query.addBindValue(courseId);
+    query.addBindValue(maxPoints);
+    query.addBindValue(maxPoints);
+    query.addBindValue(maxPoints);
+    if (!query.exec()) {
+        ChartBatch failed;
+        failed.error = "查询成绩失败：" + query.lastError().text();
+        promise.addResult(failed);
+        return;
+    }
+
+    // exam_date 为儒略日整数，SQL 已按日期排序，无需再解析/排序
+    ChartBatch batch;
+    while (query.next()) {
+        qreal x = QDateTime(DBManager::dateAt(query, 0), QTime(0, 0)).toMSecsSinceEpoch();
+        batch.main.append(QPointF(x, DBManager::scoreAt(query, 1)));
+        if (batch.main.size() >= kChartBatchSize) {
+            promise.addResult(batch);
+            batch = ChartBatch();
+            if (promise.isCanceled()) return; // 已被新的选择取代
+        }
+    }
+    if (!batch.main.isEmpty()) {
+        promise.addResult(batch);
+    }
+}
+
+// 班级趋势：单次分组查询
+// 窗口函数在每个考试日期内按成绩排序编号，外层按日期分组取均值、中位数和四分位（最近秩法），
+// 整个班级只扫描一遍，不需要逐个学生查询。
+static void fetchClassTrend(QPromise<ChartBatch>& promise, const QString& className, int courseId,
+                            const QDate& from, const QDate& to)
+{
+    // 中位数/四分位依赖窗口函数（旧版 MySQL 不支持）
+    if (!DBManager::getInstance().dialect().supportsWindowFunctions()) {
+        ChartBatch failed;
+        failed.error = QString("当前数据库（%1 %2）不支持窗口函数，无法计算班级分位数")
+                           .arg(DBManager::getInstance().dialect().name(),
+                                DBManager::getInstance().dialect().serverVersion().toString());
+        promise.addResult(failed);
+        return;
+    }
+
+    QString sql = QString(R"(
+        WITH ranked AS (
+            SELECT sc.exam_date AS d, sc.score AS s,
+                   ROW_NUMBER() OVER (PARTITION BY sc.exam_date ORDER BY sc.score) AS rn,
+                   COUNT(*) OVER (PARTITION BY sc.exam_date) AS n
+            FROM %1 sc JOIN students st ON st.student_id = sc.student_id
+            WHERE st.class_name = ? AND sc.course_id = ?
+            AND sc.score >= 0 AND sc.score <= 100 %2
+        )
+        SELECT d, AVG(s),
+               AVG(CASE WHEN rn IN ((n + 1) / 2, (n + 2) / 2) THEN s END),
+               MAX(CASE WHEN rn = (n + 3) / 4 THEN s END),
+               MAX(CASE WHEN rn = (3 * n + 3) / 4 THEN s END)
+        FROM ranked
+        GROUP BY d
+        ORDER BY d ASC
+    )").arg(DBManager::getInstance().scoreSource(from, to),
+            DBManager::dateRangeSql("sc.exam_date", from, to));
+
+    QSqlQuery query(DBManager::getInstance().threadConnection());
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    query.addBindValue(className);
+    query.addBindValue(courseId);
     if (!query.exec()) {
-        QMessageBox::critical(this, "错误", "查询成绩失败：" + query.lastError().text());
-        return dataList;
+        ChartBatch failed;
+        failed.error = "查询班级成绩失败：" + query.lastError().text();
+        promise.addResult(failed);
+        return;
     }
 
-    // 解析数据
+    ChartBatch batch;
     while (query.next()) {
-        QString dateStr = query.value(0).toString().trimmed();
-        QDate examDate = QDate::fromString(dateStr, "yyyy-MM-dd");
-        if (!examDate.isValid() || dateStr.isEmpty()) {
-            examDate = QDate::currentDate();
+        qreal x = QDateTime(DBManager::dateAt(query, 0), QTime(0, 0)).toMSecsSinceEpoch();
+        batch.main.append(QPointF(x, query.value(1).toDouble()));
+        batch.median.append(QPointF(x, query.value(2).toDouble()));
+        batch.q1.append(QPointF(x, query.value(3).toDouble()));
+        batch.q3.append(QPointF(x, query.value(4).toDouble()));
+        if (batch.main.size() >= kChartBatchSize) {
+            promise.addResult(batch);
+            batch = ChartBatch();
+            if (promise.isCanceled()) return;
         }
-        qreal score = query.value(1).toDouble();
-        dataList.append({examDate, score});
     }
+    if (!batch.main.isEmpty()) {
+        promise.addResult(batch);
+    }
+}
 
-    // 按日期排序
-    std::sort(dataList.begin(), dataList.end(),
-              [](const QPair<QDate, qreal>& a, const QPair<QDate, qreal>& b) {
-                  return a.first < b.first;
-              });
+// ========== 按当前选择取数：完整范围或当前可见窗口 ==========
+void ScoreChartWidget::refreshChart(bool fitAxis)
+{
+    QDate from = m_dateFrom;
+    QDate to = m_dateTo;
+    if (!fitAxis) {
+        // 可见窗口与共用日期范围取交集
+        QDate axisFrom = m_xAxis->min().date();
+        QDate axisTo = m_xAxis->max().date();
+        from = from.isValid() ? qMax(from, axisFrom) : axisFrom;
+        to = to.isValid() ? qMin(to, axisTo) : axisTo;
+    }
 
-    return dataList;
+    int courseId = getCourseIdByName(m_chartCourse);
+    if (courseId == -1) {
+        QMessageBox::warning(this, "提示", QString("科目【%1】不存在！").arg(m_chartCourse));
+        return;
+    }
+
+    // 新请求取代旧请求：旧任务尽快停止，已在途的旧批次按代号丢弃
+    m_pendingLoad.cancel();
+    int generation = ++m_loadGeneration;
+    m_loadFitAxis = fitAxis;
+    m_loadReceived = false;
+    m_loadedMin = m_loadedMax = 0;
+
+    QString title = m_chartClassMode
+                        ? QString("%1 - %2 班级成绩趋势图").arg(m_chartClass, m_chartCourse)
+                        : QString("%1 - %2 成绩趋势图").arg(getStudentNameById(m_chartStudentId), m_chartCourse);
+    m_chart->setTitle(title + "（加载中…）");
+
+    QFuture<ChartBatch> future;
+    if (m_chartClassMode) {
+        QString className = m_chartClass;
+        future = QtConcurrent::run([className, courseId, from, to](QPromise<ChartBatch>& promise) {
+            fetchClassTrend(promise, className, courseId, from, to);
+        });
+    } else {
+        QString studentId = m_chartStudentId;
+        int maxPoints = maxVisiblePoints();
+        future = QtConcurrent::run([studentId, courseId, from, to, maxPoints](QPromise<ChartBatch>& promise) {
+            fetchStudentSeries(promise, studentId, courseId, from, to, maxPoints);
+        });
+    }
+    m_pendingLoad = future;
+
+    auto *watcher = new QFutureWatcher<ChartBatch>(this);
+    connect(watcher, &QFutureWatcher<ChartBatch>::resultsReadyAt, this, [this, watcher, generation](int begin, int end) {
+        if (generation != m_loadGeneration) return;
+        for (int i = begin; i < end; i++) {
+            appendBatch(watcher->resultAt(i));
+        }
+    });
+    connect(watcher, &QFutureWatcher<ChartBatch>::finished, this, [this, watcher, generation, title]() {
+        watcher->deleteLater();
+        if (generation != m_loadGeneration) return;
+        finishLoad(title);
+    });
+    watcher->setFuture(future);
+}
+
+// ========== 追加一批数据 ==========
+void ScoreChartWidget::appendBatch(const ChartBatch& batch)
+{
+    if (!batch.error.isEmpty()) {
+        QMessageBox::critical(this, "错误", batch.error);
+        return;
+    }
+
+    // 首批到达时再清空旧数据，加载期间旧图保持可见
+    if (!m_loadReceived) {
+        m_series->clear();
+        m_scatterSeries->clear();
+        m_meanSeries->clear();
+        m_medianSeries->clear();
+        m_q1Series->clear();
+        m_q3Series->clear();
+        m_loadedMin = batch.main.first().x();
+        m_loadReceived = true;
+    }
+    m_loadedMax = batch.main.last().x();
+
+    if (m_chartClassMode) {
+        m_meanSeries->append(batch.main);
+        m_medianSeries->append(batch.median);
+        m_q1Series->append(batch.q1);
+        m_q3Series->append(batch.q3);
+    } else {
+        m_series->append(batch.main);
+        m_scatterSeries->append(batch.main);
+    }
+
+    // 需要适配坐标轴时随批次扩展X轴
+    if (m_loadFitAxis) {
+        setAxisRange(QDateTime::fromMSecsSinceEpoch(qint64(m_loadedMin)).addDays(-1),
+                     QDateTime::fromMSecsSinceEpoch(qint64(m_loadedMax)).addDays(1));
+    }
+}
+
+// ========== 加载完成 ==========
+void ScoreChartWidget::finishLoad(const QString& title)
+{
+    if (m_loadReceived) {
+        m_chart->setTitle(title);
+        return;
+    }
+
+    // 窗口内无数据
+    m_series->clear();
+    m_scatterSeries->clear();
+    m_meanSeries->clear();
+    m_medianSeries->clear();
+    m_q1Series->clear();
+    m_q3Series->clear();
+    m_chart->setTitle(title + "（无数据）");
+    if (m_loadFitAxis) {
+        setAxisRange(QDateTime::currentDateTime().addDays(-7), QDateTime::currentDateTime());
+    }
 }
 
 // ========== 新增：通过学生ID获取姓名 ==========
 QString ScoreChartWidget::getStudentNameById(const QString& studentId)
 {
-    QString sql = "SELECT student_name FROM students WHERE student_id = ?";
+    using Schema::Students;
+    using NameColumns = Schema::Select<Students, Students::StudentName>;
     QSqlQuery query;
-    query.prepare(sql);
+    query.prepare(NameColumns::sql(Schema::columnName<Students>(Students::StudentId) + " = ?"));
     query.addBindValue(studentId);
     if (query.exec() && query.next()) {
-        return query.value(0).toString();
+        return query.value(NameColumns::at<Students::StudentName>()).toString();
     }
     return "未知学生";
 }
+
+// ========== 通过科目名称获取course_id ==========
+int ScoreChartWidget::getCourseIdByName(const QString& courseName)
+{
+    using Schema::Courses;
+    using IdColumns = Schema::Select<Courses, Courses::CourseId>;
+    QSqlQuery query;
+    query.prepare(IdColumns::sql(Schema::columnName<Courses>(Courses::CourseName) + " = ?"));
+    query.addBindValue(courseName);
+    if (query.exec() && query.next()) {
+        return query.value(IdColumns::at<Courses::CourseId>()).toInt();
+    }
+    return -1;
+}
+
+
+// ========== 批量导出趋势图 ==========
+// 当前科目下每个学生一张；班级模式下只导出所选班级的学生
+void ScoreChartWidget::on_btnBatchExport_clicked()
+{
+    QString courseName = ui->cbCourse->currentData().toString();
+    if (courseName.isEmpty()) {
+        QMessageBox::warning(this, "提示", "请先选择科目！");
+        return;
+    }
+    int courseId = getCourseIdByName(courseName);
+    if (courseId == -1) {
+        QMessageBox::warning(this, "提示", QString("科目【%1】不存在！").arg(courseName));
+        return;
+    }
+
+    bool ok = false;
+    QString formatName = QInputDialog::getItem(this, "批量导出", "导出格式：", {"PNG", "SVG", "PDF"}, 0, false, &ok);
+    if (!ok) return;
+    QString outputDir = QFileDialog::getExistingDirectory(this, "选择导出目录", QDir::homePath());
+    if (outputDir.isEmpty()) return;
+
+    ChartExportOptions options;
+    options.mode = ChartExportOptions::PerStudent;
+    ChartExporter::parseFormat(formatName, &options.format);
+    options.courseId = courseId;
+    options.className = ui->cbMode->currentIndex() == 1 ? ui->cbClass->currentData().toString() : QString();
+    options.from = m_dateFrom;
+    options.to = m_dateTo;
+    options.outputDir = outputDir;
+
+    QProgressDialog progressDialog("正在导出趋势图…", "取消", 0, 0, this);
+    progressDialog.setWindowModality(Qt::WindowModal);
+    progressDialog.setMinimumDuration(500);
+
+    QString error;
+    int count = ChartExporter::exportCharts(options, &error, [&progressDialog](int done, int submitted) {
+        progressDialog.setLabelText(QString("正在导出趋势图… 已完成 %1 / %2").arg(done).arg(submitted));
+        return !progressDialog.wasCanceled();
+    });
+    progressDialog.close();
+
+    if (count < 0) {
+        QMessageBox::critical(this, "错误", "批量导出失败：" + error);
+    } else {
+        QMessageBox::information(this, "完成", QString("已导出 %1 张趋势图到：\n%2").arg(count).arg(outputDir));
+    }
+}
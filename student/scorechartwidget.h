@@ -5,6 +5,7 @@
 #include <QChart>
 #include <QLineSeries>
 #include <QScatterSeries>
+#include <QAreaSeries>
 #include <QValueAxis>
 #include <QDateTimeAxis>
 #include <QChartView>
@@ -16,14 +17,25 @@
 #include <QPainter>
 #include <QFont>
 #include <QPen>
-#include <algorithm>
+#include <QTimer>
+#include <QFuture>
 #include "dbmanager.h"
+#include "studentpicker.h"
 
 
     namespace Ui {
     class ScoreChartWidget;
 }
 
+// 后台取数的一批结果：个人趋势只用 main；班级趋势 main 为均值，另含中位数与四分位
+struct ChartBatch {
+    QList<QPointF> main;
+    QList<QPointF> median;
+    QList<QPointF> q1;
+    QList<QPointF> q3;
+    QString error;
+};
+
 class ScoreChartWidget : public QWidget
 {
     Q_OBJECT
@@ -32,26 +44,78 @@ public:
     explicit ScoreChartWidget(QWidget *parent = nullptr);
     ~ScoreChartWidget() override;
 
+    // 趋势图统一样式：坐标轴格式、标题字体、图例（界面与离线导出共用）
+    static void applyChartStyle(QChart *chart, QDateTimeAxis *xAxis, QValueAxis *yAxis);
+
+public slots:
+    // 共用日期范围筛选（空日期表示不限），已有图表时按新范围重新加载
+    void setDateRange(const QDate& from, const QDate& to);
+
 private slots:
     void on_btnLoadCourses_clicked();
     void on_btnGenerateChart_clicked();
     // 新增：加载学生列表到下拉框
     void on_btnLoadStudents_clicked();
+    // 切换个人趋势/班级趋势
+    void on_cbMode_currentIndexChanged(int index);
+    // 重置缩放：回到完整日期范围
+    void on_btnResetZoom_clicked();
+    // 批量导出趋势图（PNG/SVG/PDF）
+    void on_btnBatchExport_clicked();
+    // X轴范围变化（框选缩放/右键缩小），延迟后只加载可见窗口
+    void onAxisRangeChanged(const QDateTime& min, const QDateTime& max);
 
 private:
     void initChartView();
-    // 重构：支持按学生+科目查询成绩数据
-    QList<QPair<QDate, qreal>> queryScoreData(const QString& studentId, const QString& courseName);
     // 新增：获取学生姓名（用于图表标题）
     QString getStudentNameById(const QString& studentId);
+    // 通过科目名称获取course_id（不存在返回-1）
+    int getCourseIdByName(const QString& courseName);
+    // 按当前选择在后台重新加载图表；fitAxis 为 true 时按数据重设X轴，否则只加载当前可见窗口
+    void refreshChart(bool fitAxis);
+    // 追加一批后台结果 / 加载结束
+    void appendBatch(const ChartBatch& batch);
+    void finishLoad(const QString& title);
+    // 设置X轴范围（不触发窗口重载）
+    void setAxisRange(const QDateTime& min, const QDateTime& max);
+    // 绘图区宽度可容纳的点数
+    int maxVisiblePoints() const;
+    // 显示个人序列或班级序列
+    void setClassMode(bool classMode);
 
     Ui::ScoreChartWidget *ui;
     QChart *m_chart;
     QLineSeries *m_series;
     QScatterSeries *m_scatterSeries;
+    // 班级趋势序列：均值线、中位数线、四分位带
+    QLineSeries *m_meanSeries;
+    QLineSeries *m_medianSeries;
+    QLineSeries *m_q1Series;
+    QLineSeries *m_q3Series;
+    QAreaSeries *m_bandSeries;
     QChartView *m_chartView;
     QDateTimeAxis *m_xAxis;
     QValueAxis *m_yAxis;
+
+    // 当前图表的选择（缩放/日期范围变化时据此重新取数）
+    bool m_hasChart = false;
+    bool m_chartClassMode = false;
+    QString m_chartStudentId;
+    QString m_chartClass;
+    QString m_chartCourse;
+    QDate m_dateFrom;
+    QDate m_dateTo;
+    bool m_updatingAxis = false;
+    QTimer *m_zoomTimer;
+    StudentPicker *m_studentPicker;       // 学生搜索选择（cbStudent）
+
+    // 后台加载状态：代号递增，过期批次直接丢弃
+    QFuture<ChartBatch> m_pendingLoad;
+    int m_loadGeneration = 0;
+    bool m_loadFitAxis = false;
+    bool m_loadReceived = false;
+    qreal m_loadedMin = 0;
+    qreal m_loadedMax = 0;
 };
 
 #endif // SCORECHARTWIDGET_H
@@ -0,0 +1,365 @@
+#include "scoreexporter.h"
+#include "dbmanager.h"
+#include "memoryaccounting.h"
+#include <QFileInfo>
+#include <QDir>
+#include <QSaveFile>
+#include <QQueue>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <QtEndian>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+// ========== 列式文件格式（.scol） ==========
+// 文件头：8字节 "SCOLv1\0\0"
+// 行组：每个行组依次存放8列的数据块，每块为 qCompress 输出（4字节大端原始长度 + zlib 流）。
+//       原始编码（小端）：score_id/student_id/course_id 为 int64 差分（首值为原值），
+//       exam_date 为 int32 儒略日，score 为 float64，文本列为 (行数+1) 个 int32 偏移 + UTF-8 字节。
+// 文件尾：UTF-8 JSON 元数据（列定义、各行组行数与数据块偏移/长度），随后 4字节小端 JSON 长度 + "SCOL"。
+// NULL 值：整数写 0，文本写空串。
+namespace {
+
+const char kFileMagic[8] = {'S', 'C', 'O', 'L', 'v', '1', '\0', '\0'};
+const char kFooterMagic[4] = {'S', 'C', 'O', 'L'};
+
+enum ColumnKind { Int64Delta, Int32, Float64, Utf8 };
+struct ColumnDef {
+    const char *name;
+    ColumnKind kind;
+};
+const ColumnDef kColumns[] = {
+    {"score_id", Int64Delta}, {"student_id", Int64Delta}, {"student_name", Utf8}, {"class_name", Utf8},
+    {"course_id", Int64Delta}, {"course_name", Utf8}, {"score", Float64}, {"exam_date", Int32},
+};
+const int kColumnCount = int(sizeof(kColumns) / sizeof(kColumns[0]));
+
+// 文本列：连续的 UTF-8 字节 + 每行起始偏移
+struct TextColumn {
+    QByteArray bytes;
+    QVector<qint32> offsets{0};
+
+    void append(const QString& text) {
+        bytes += text.toUtf8();
+        offsets.append(qint32(bytes.size()));
+    }
+    QByteArrayView at(int row) const {
+        return QByteArrayView(bytes.constData() + offsets[row], offsets[row + 1] - offsets[row]);
+    }
+};
+
+// 一批行（按列存放），在读取线程填充后整体移交给编码任务
+struct RowBatch {
+    int fileIndex = 0;       // CSV 分文件序号
+    QVector<qint64> scoreIds;
+    QVector<qint64> studentIds;
+    TextColumn studentNames;
+    TextColumn classNames;
+    QVector<qint64> courseIds;
+    TextColumn courseNames;
+    QVector<double> scores;
+    QVector<qint32> examDates;
+
+    int rows() const { return scoreIds.size(); }
+    qint64 memoryUsage() const {
+        qint64 fixed = qint64(rows()) * (4 * sizeof(qint64) + sizeof(double) + sizeof(qint32));
+        qint64 text = studentNames.bytes.size() + classNames.bytes.size() + courseNames.bytes.size()
+                      + 3 * qint64(studentNames.offsets.size()) * qint64(sizeof(qint32));
+        return fixed + text;
+    }
+};
+
+// 编码结果：CSV 为一段文本；列式为各列压缩块
+struct EncodedBatch {
+    int fileIndex = 0;
+    int rows = 0;
+    QList<QByteArray> chunks;
+};
+
+// ---------- CSV ----------
+void appendCsvText(QByteArray& out, QByteArrayView text)
+{
+    bool quote = false;
+    for (char ch : text) {
+        if (ch == ',' || ch == '"' || ch == '\n' || ch == '\r') {
+            quote = true;
+            break;
+        }
+    }
+    if (!quote) {
+        out.append(text);
+        return;
+    }
+    out.append('"');
+    for (char ch : text) {
+        if (ch == '"') out.append('"');
+        out.append(ch);
+    }
+    out.append('"');
+}
+
+QByteArray csvHeader()
+{
+    QByteArray header;
+    for (int col = 0; col < kColumnCount; col++) {
+        if (col > 0) header.append(',');
+        header.append(kColumns[col].name);
+    }
+    return header.append('\n');
+}
+
+EncodedBatch encodeCsv(const std::shared_ptr<RowBatch>& batch)
+{
+    QByteArray out;
+    out.reserve(batch->rows() * 64);
+    QHash<qint32, QByteArray> dateText; // 同一批里考试日期重复度高，只格式化一次
+    for (int row = 0; row < batch->rows(); row++) {
+        out.append(QByteArray::number(batch->scoreIds[row])).append(',');
+        out.append(QByteArray::number(batch->studentIds[row])).append(',');
+        appendCsvText(out, batch->studentNames.at(row));
+        out.append(',');
+        appendCsvText(out, batch->classNames.at(row));
+        out.append(',');
+        out.append(QByteArray::number(batch->courseIds[row])).append(',');
+        appendCsvText(out, batch->courseNames.at(row));
+        out.append(',');
+        out.append(QByteArray::number(batch->scores[row], 'g', 10)).append(',');
+        qint32 day = batch->examDates[row];
+        auto it = dateText.find(day);
+        if (it == dateText.end()) {
+            it = dateText.insert(day, QDate::fromJulianDay(day).toString("yyyy-MM-dd").toLatin1());
+        }
+        out.append(it.value()).append('\n');
+    }
+    return {batch->fileIndex, batch->rows(), {out}};
+}
+
+// ---------- 列式 ----------
+template <typename T>
+void appendLittleEndian(QByteArray& out, T value)
+{
+    T le = qToLittleEndian(value);
+    out.append(reinterpret_cast<const char*>(&le), sizeof(T));
+}
+
+QByteArray encodeDelta(const QVector<qint64>& values)
+{
+    QByteArray raw;
+    raw.reserve(values.size() * int(sizeof(qint64)));
+    qint64 previous = 0;
+    for (qint64 value : values) {
+        appendLittleEndian<qint64>(raw, value - previous);
+        previous = value;
+    }
+    return raw;
+}
+
+QByteArray encodeText(const TextColumn& column)
+{
+    QByteArray raw;
+    raw.reserve(column.offsets.size() * int(sizeof(qint32)) + column.bytes.size());
+    for (qint32 offset : column.offsets) appendLittleEndian<qint32>(raw, offset);
+    raw.append(column.bytes);
+    return raw;
+}
+
+EncodedBatch encodeColumnar(const std::shared_ptr<RowBatch>& batch, int level)
+{
+    QByteArray scores, dates;
+    scores.reserve(batch->rows() * int(sizeof(double)));
+    for (double score : batch->scores) {
+        quint64 bits;
+        std::memcpy(&bits, &score, sizeof(bits));
+        appendLittleEndian<quint64>(scores, bits);
+    }
+    dates.reserve(batch->rows() * int(sizeof(qint32)));
+    for (qint32 day : batch->examDates) appendLittleEndian<qint32>(dates, day);
+
+    // 顺序与 kColumns 一致
+    QList<QByteArray> raw = {encodeDelta(batch->scoreIds), encodeDelta(batch->studentIds),
+                             encodeText(batch->studentNames), encodeText(batch->classNames),
+                             encodeDelta(batch->courseIds), encodeText(batch->courseNames), scores, dates};
+    EncodedBatch encoded{batch->fileIndex, batch->rows(), {}};
+    for (const QByteArray& column : raw) {
+        encoded.chunks.append(qCompress(column, level));
+    }
+    return encoded;
+}
+
+// CSV 第 index 个分文件路径：第一个为原路径，其后为 name_2.csv、name_3.csv ...
+QString csvPartPath(const QString& filePath, int index)
+{
+    if (index == 0) return filePath;
+    QFileInfo info(filePath);
+    return info.dir().filePath(QString("%1_%2.%3").arg(info.completeBaseName()).arg(index + 1)
+                                   .arg(info.suffix().isEmpty() ? "csv" : info.suffix()));
+}
+
+} // namespace
+
+qint64 ScoreExporter::exportScores(const ScoreExportOptions& options, QString *errorMessage,
+                                   const std::function<bool(qint64)>& progress)
+{
+    auto fail = [errorMessage](const QString& message) {
+        if (errorMessage) *errorMessage = message;
+        return qint64(-1);
+    };
+    const bool csv = options.format == ScoreExportOptions::Csv;
+    const int batchRows = qMax(1024, options.batchRows);
+
+    DBManager& db = DBManager::getInstance();
+    QString sql = QString("SELECT sc.score_id, sc.student_id, COALESCE(st.student_name, ''), "
+                          "COALESCE(st.class_name, ''), COALESCE(sc.course_id, 0), COALESCE(c.course_name, ''), "
+                          "sc.score, sc.exam_date "
+                          "FROM %1 sc "
+                          "LEFT JOIN students st ON st.student_id = sc.student_id "
+                          "LEFT JOIN courses c ON c.course_id = sc.course_id WHERE 1 = 1%2")
+                      .arg(db.scoreSource(options.from, options.to),
+                           DBManager::dateRangeSql("sc.exam_date", options.from, options.to));
+    if (!options.classPattern.isEmpty()) sql += " AND st.class_name LIKE ?";
+    if (!options.coursePattern.isEmpty()) sql += " AND c.course_name LIKE ?";
+
+    QSqlQuery query(db.threadConnection());
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    if (!options.classPattern.isEmpty()) query.addBindValue(QString("%%1%").arg(options.classPattern));
+    if (!options.coursePattern.isEmpty()) query.addBindValue(QString("%%1%").arg(options.coursePattern));
+    if (!query.exec()) {
+        return fail("查询成绩失败：" + query.lastError().text());
+    }
+
+    // ---------- 写入端：按提交顺序落盘 ----------
+    // 各分文件都保持打开，全部成功后才一起提交，取消/失败时不留下任何分文件
+    std::vector<std::unique_ptr<QSaveFile>> parts;
+    QSaveFile *file = nullptr;
+    int currentFile = -1;
+    qint64 fileOffset = 0;
+    QJsonArray rowGroups;
+    qint64 written = 0;
+    QString writeError;
+
+    auto openFile = [&](int index) {
+        parts.push_back(std::make_unique<QSaveFile>(csv ? csvPartPath(options.filePath, index) : options.filePath));
+        file = parts.back().get();
+        if (!file->open(QIODevice::WriteOnly)) {
+            writeError = QString("无法创建文件：%1").arg(file->fileName());
+            return false;
+        }
+        currentFile = index;
+        QByteArray head = csv ? QByteArray("\xEF\xBB\xBF") + csvHeader() : QByteArray(kFileMagic, sizeof(kFileMagic));
+        fileOffset = file->write(head);
+        return true;
+    };
+    auto writeBatch = [&](const EncodedBatch& encoded) {
+        if (!writeError.isEmpty()) return;
+        if (encoded.fileIndex != currentFile && !openFile(encoded.fileIndex)) return;
+        QJsonArray chunks;
+        for (const QByteArray& chunk : encoded.chunks) {
+            if (file->write(chunk) != chunk.size()) {
+                writeError = "写入文件失败：" + file->errorString();
+                return;
+            }
+            chunks.append(QJsonArray{fileOffset, qint64(chunk.size())});
+            fileOffset += chunk.size();
+        }
+        if (!csv) rowGroups.append(QJsonObject{{"rows", encoded.rows}, {"chunks", chunks}});
+        written += encoded.rows;
+    };
+
+    // ---------- 读取端：逐批读取并提交编码 ----------
+    const int maxInFlight = qMax(2, QThreadPool::globalInstance()->maxThreadCount() * 2);
+    QQueue<QFuture<EncodedBatch>> inFlight;
+    // 在途批次（读取完、尚未写出）的内存记账
+    QQueue<qint64> inFlightBytes;
+    qint64 inFlightTotal = 0;
+    MemoryCharge inFlightCharge("export", "导出在途批次");
+    auto reap = [&](int keep) {
+        while (inFlight.size() > keep) {
+            writeBatch(inFlight.dequeue().result());
+            inFlightTotal -= inFlightBytes.dequeue();
+            inFlightCharge.update(inFlightTotal, inFlight.size());
+        }
+    };
+
+    bool canceled = false;
+    bool more = true;
+    int fileIndex = 0;
+    qint64 rowsInFile = 0;
+    while (more && !canceled && writeError.isEmpty()) {
+        // CSV 在分文件边界处截断批次，保证一批只属于一个文件
+        qint64 limit = batchRows;
+        if (csv) {
+            if (rowsInFile >= options.rowsPerFile) {
+                fileIndex++;
+                rowsInFile = 0;
+            }
+            limit = qMin<qint64>(limit, options.rowsPerFile - rowsInFile);
+        }
+
+        auto batch = std::make_shared<RowBatch>();
+        batch->fileIndex = fileIndex;
+        while (batch->rows() < limit && (more = query.next())) {
+            batch->scoreIds.append(query.value(0).toLongLong());
+            batch->studentIds.append(query.value(1).toLongLong());
+            batch->studentNames.append(query.value(2).toString());
+            batch->classNames.append(query.value(3).toString());
+            batch->courseIds.append(query.value(4).toLongLong());
+            batch->courseNames.append(query.value(5).toString());
+            batch->scores.append(query.value(6).toDouble());
+            batch->examDates.append(qint32(query.value(7).toLongLong()));
+        }
+        if (batch->rows() == 0) break;
+        rowsInFile += batch->rows();
+
+        int level = options.compressionLevel;
+        inFlightBytes.enqueue(batch->memoryUsage());
+        inFlightTotal += inFlightBytes.last();
+        inFlight.enqueue(csv ? QtConcurrent::run(encodeCsv, batch)
+                             : QtConcurrent::run(encodeColumnar, batch, level));
+        inFlightCharge.update(inFlightTotal, inFlight.size());
+        reap(maxInFlight);
+        if (progress && !progress(written)) canceled = true;
+    }
+    if (query.lastError().isValid()) {
+        writeError = "读取成绩失败：" + query.lastError().text();
+    }
+    reap(0);
+
+    if (canceled || !writeError.isEmpty()) {
+        for (const auto& part : parts) part->cancelWriting(); // 未完成的文件不会覆盖目标
+        return fail(canceled ? QString("导出已取消") : writeError);
+    }
+
+    // 空结果也生成文件（只有表头/元数据）
+    if (!file && !openFile(0)) return fail(writeError);
+    if (!csv) {
+        QJsonArray columns;
+        const char *kindNames[] = {"int64_delta", "int32", "float64", "utf8"};
+        for (const ColumnDef& column : kColumns) {
+            columns.append(QJsonObject{{"name", column.name}, {"type", kindNames[column.kind]}});
+        }
+        QByteArray footer = QJsonDocument(QJsonObject{{"version", 1}, {"rows", written}, {"compression", "zlib"},
+                                                      {"columns", columns}, {"row_groups", rowGroups}})
+                                .toJson(QJsonDocument::Compact);
+        file->write(footer);
+        QByteArray tail;
+        appendLittleEndian<quint32>(tail, quint32(footer.size()));
+        tail.append(kFooterMagic, sizeof(kFooterMagic));
+        file->write(tail);
+    }
+    for (size_t i = 0; i < parts.size(); i++) {
+        if (parts[i]->commit()) continue;
+        // 提交中途失败：删掉已提交的分文件，其余放弃
+        QString error = "写入文件失败：" + parts[i]->errorString();
+        for (size_t j = 0; j < i; j++) QFile::remove(parts[j]->fileName());
+        for (size_t j = i + 1; j < parts.size(); j++) parts[j]->cancelWriting();
+        return fail(error);
+    }
+    if (progress) progress(written);
+    return written;
+}
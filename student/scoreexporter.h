@@ -0,0 +1,37 @@
+#ifndef SCOREEXPORTER_H
+#define SCOREEXPORTER_H
+
+#include <QString>
+#include <QDate>
+#include <functional>
+
+// 成绩数据导出参数（供数据分析使用，不经过 Excel）
+struct ScoreExportOptions {
+    enum Format {
+        Csv,        // UTF-8 CSV，超过 rowsPerFile 时拆分为多个文件（每个文件可作为一张工作表打开）
+        Columnar    // 压缩列式文件 .scol，格式见 scoreexporter.cpp
+    };
+
+    Format format = Csv;
+    QString filePath;
+    QString classPattern;      // 班级名模糊匹配，空为全部
+    QString coursePattern;     // 课程名模糊匹配，空为全部
+    QDate from;                // 日期范围，空为不限
+    QDate to;
+    int batchRows = 65536;     // 每批（列式文件的一个行组）行数
+    qint64 rowsPerFile = 1000000; // CSV 单文件行数上限（Excel 单表上限约104万行）
+    int compressionLevel = 6;  // 列式文件 zlib 压缩级别
+};
+
+// 流式导出：在调用线程上以只进游标逐批读取，格式化/压缩交给线程池并行，
+// 按提交顺序写文件；在途批次数有上限，内存占用与总行数无关。
+// 应在工作线程调用（会阻塞直到完成）。
+class ScoreExporter
+{
+public:
+    // progress(已写入行数) 返回 false 时中止；返回导出的行数，失败返回 -1
+    static qint64 exportScores(const ScoreExportOptions& options, QString *errorMessage = nullptr,
+                               const std::function<bool(qint64)>& progress = nullptr);
+};
+
+#endif // SCOREEXPORTER_H
@@ -1,27 +1,62 @@
 #include "scoreinputwidget.h"
 #include "ui_scoreinputwidget.h"
 #include "dbmanager.h"
+#include "schema.h"
+#include "memoryaccounting.h"
+#include "anomalydialog.h"
 #include <QMessageBox>
 #include <QDate>
 #include <QDebug>
 #include <QTableWidgetItem>
+#include <QScrollBar>
+#include <QtConcurrent>
 
 ScoreInputWidget::ScoreInputWidget(QWidget *parent) :
     QWidget(parent),
-    ui(new Ui::ScoreInputWidget)
+    ui(new Ui::ScoreInputWidget),
+    m_studentPicker(nullptr)
 {
     ui->setupUi(this);
     this->setWindowTitle("成绩录入");
+    // 学生下拉框改为边输边查（学号/姓名/拼音首字母），不再一次性加载全部学生
+    m_studentPicker = new StudentPicker(ui->cbStudent);
+    connect(&StudentIndex::getInstance(), &StudentIndex::reloadFailed, this, [this](const QString& reason) {
+        if (isVisible()) QMessageBox::warning(this, "提示", reason);
+    });
 
     // 初始化批量表格列
     ui->tableBatchScore->setColumnCount(5);
     ui->tableBatchScore->setHorizontalHeaderLabels({"学生ID", "学生姓名", "科目", "成绩", "考试日期"});
     // 设置日期默认值为当前日期
     ui->dateEditExam->setDate(QDate::currentDate());
+
+    // 批量表格按页加载：滚动接近底部时再取下一页
+    loadBatchClassList();
+    connect(ui->tableBatchScore->verticalScrollBar(), &QScrollBar::valueChanged, this, [this](int value) {
+        QScrollBar *bar = ui->tableBatchScore->verticalScrollBar();
+        if (m_rosterPager && !m_rosterPager->atEnd() && value >= bar->maximum() - bar->pageStep() / 2) {
+            appendRosterPage();
+        }
+    });
+    // 表格变高（窗口放大）后滚动条可能消失，同样需要补页；排队执行，避免在表格布局过程中改动行数
+    connect(ui->tableBatchScore->verticalScrollBar(), &QScrollBar::rangeChanged, this, [this](int /*min*/, int max) {
+        if (max == 0) QMetaObject::invokeMethod(this, &ScoreInputWidget::fillRosterViewport, Qt::QueuedConnection);
+    });
+
+    // 成绩写入统一走写线程，完成通知回到界面线程
+    connect(&ScoreWriter::getInstance(), &ScoreWriter::writeFinished, this, &ScoreInputWidget::onWriteFinished);
+    connect(&m_anomalyWatcher, &QFutureWatcher<AnomalyReport>::finished, this, &ScoreInputWidget::onAnomalyScanFinished);
+
+    // 批量表格每个单元格一个 QTableWidgetItem（对象 + 每个角色一个 QVariant）
+    MemoryAccounting::getInstance().registerProbe("input", "批量录入表格项", this, [this]() {
+        qint64 items = qint64(ui->tableBatchScore->rowCount()) * ui->tableBatchScore->columnCount();
+        return MemorySample{items, items * qint64(sizeof(QTableWidgetItem) + 2 * sizeof(QVariant) + 32)};
+    });
 }
 
 ScoreInputWidget::~ScoreInputWidget()
 {
+    m_anomalyWatcher.waitForFinished();
     delete ui;
 }
 
@@ -32,14 +67,15 @@ int ScoreInputWidget::getCourseIdByName(const QString& courseName)
     if (courseName.isEmpty()) return -1;
 
     // 查询course_id（防SQL注入：使用预处理）
-    QString sql = "SELECT course_id FROM courses WHERE course_name = ?";
+    using Schema::Courses;
+    using CourseLookup = Schema::Select<Courses, Courses::CourseId>;
     QSqlQuery query;
-    query.prepare(sql);
+    query.prepare(CourseLookup::sql(Schema::columnName<Courses>(Courses::CourseName) + " = ?"));
     query.addBindValue(courseName);
     query.exec();
 
     if (query.next()) {
-        return query.value(0).toInt();
+        return query.value(CourseLookup::at<Courses::CourseId>()).toInt();
     }
     return -1; // 未找到返回-1
 }
@@ -62,10 +98,10 @@ void ScoreInputWidget::on_btnSingleSubmit_clicked()
     }
 
     // 2. 获取输入数据
-    QString studentId = ui->cbStudent->currentData().toString();
+    QString studentId = m_studentPicker->currentStudentId();
     QString courseName = ui->leCourse->text().trimmed();
     QString scoreStr = ui->leScore->text().trimmed();
-    QString examDate = ui->dateEditExam->date().toString("yyyy-MM-dd");
+    QDate examDate = ui->dateEditExam->date();
 
     // 3. 空值校验
     if (studentId.isEmpty() || courseName.isEmpty() || scoreStr.isEmpty()) {
@@ -79,6 +115,12 @@ void ScoreInputWidget::on_btnSingleSubmit_clicked()
         return;
     }
 
+    // 已归档学期只读
+    if (DBManager::getInstance().isArchivedDate(examDate)) {
+        QMessageBox::warning(this, "提示", QString("%1 所在学期已归档，不能再录入成绩！").arg(examDate.toString("yyyy-MM-dd")));
+        return;
+    }
+
     // 5. 关键：获取科目对应的course_id
     int courseId = getCourseIdByName(courseName);
     if (courseId == -1) {
@@ -86,76 +128,98 @@ void ScoreInputWidget::on_btnSingleSubmit_clicked()
         return;
     }
 
-    // 6. 重复数据校验（使用course_id）
-    QString checkSql = "SELECT * FROM scores WHERE student_id = ? AND course_id = ? AND exam_date = ?";
-    QSqlQuery checkQuery;
-    checkQuery.prepare(checkSql);
-    checkQuery.addBindValue(studentId);
-    checkQuery.addBindValue(courseId);
-    checkQuery.addBindValue(examDate);
-    checkQuery.exec();
-
-    if (checkQuery.next()) {
-        QMessageBox::warning(this, "提示", "该学生该科目该日期的成绩已存在！");
+    // 6. 交给成绩写线程：重复校验与插入在写线程的事务内完成，结果异步返回
+    ScoreWrite write;
+    write.studentId = studentId;
+    write.courseId = courseId;
+    write.score = scoreStr.toDouble();
+    write.examDate = examDate;
+    quint64 ticket = ScoreWriter::getInstance().submit(write);
+    m_singleTickets.insert(ticket, QString("%1 %2 %3").arg(ui->cbStudent->currentText(), courseName, scoreStr));
+
+    // 不等待提交，立即清空输入框继续录入
+    ui->leCourse->clear();
+    ui->leScore->clear();
+    ui->leCourse->setFocus();
+}
+
+// ========== 写线程返回的录入结果 ==========
+void ScoreInputWidget::onWriteFinished(const ScoreWriteResult& result)
+{
+    auto single = m_singleTickets.constFind(result.ticket);
+    if (single != m_singleTickets.constEnd()) {
+        QString description = single.value();
+        m_singleTickets.erase(single);
+        if (result.ok) {
+            ui->labWriteStatus->setText(QString("已录入：%1").arg(description));
+        } else {
+            ui->labWriteStatus->setText(QString("录入失败：%1（%2）").arg(description, result.error));
+            qDebug() << "成绩录入失败：" << description << result.error;
+        }
         return;
     }
 
-    // 7. 插入数据库（核心：使用course_id字段）
-    QString insertSql = "INSERT INTO scores (student_id, course_id, score, exam_date) VALUES (?, ?, ?, ?)";
-    QSqlQuery insertQuery;
-    insertQuery.prepare(insertSql);
-    insertQuery.addBindValue(studentId);    // student_id（数字）
-    insertQuery.addBindValue(courseId);     // course_id（数字）
-    insertQuery.addBindValue(scoreStr);     // score（数字）
-    insertQuery.addBindValue(examDate);     // exam_date（字符串）
-
-    // 执行插入并处理结果
-    if (!insertQuery.exec()) {
-        QMessageBox::critical(this, "错误", QString("成绩录入失败：%1").arg(insertQuery.lastError().text()));
-        qDebug() << "插入失败SQL：" << insertSql; // 调试用
+    if (!m_batchTickets.remove(result.ticket)) return; // 其它界面的请求
+    if (result.ok) {
+        m_batchSuccess++;
+    } else {
+        m_batchFail++;
+        qDebug() << "批量插入失败：" << result.error;
+    }
+    if (m_batchTickets.isEmpty()) {
+        ui->labWriteStatus->setText(QString("批量录入完成：成功%1条，失败%2条").arg(m_batchSuccess).arg(m_batchFail));
+        if (m_batchSuccess > 0) startAnomalyScan();
     } else {
-        QMessageBox::information(this, "成功", "成绩录入完成！");
-        // 清空输入框
-        ui->leCourse->clear();
-        ui->leScore->clear();
+        ui->labWriteStatus->setText(QString("批量录入中：剩余%1条").arg(m_batchTickets.size()));
     }
 }
 
-// ========== 加载学生列表到下拉框（带完整校验） ==========
-void ScoreInputWidget::on_btnLoadStudents_clicked()
+// ========== 批量录入后的异常检测 ==========
+// 只扫描本次涉及的科目，早于本次考试日期的成绩只作为基线，不重复报告旧异常
+void ScoreInputWidget::startAnomalyScan()
 {
-    ui->cbStudent->clear();
+    if (m_anomalyWatcher.isRunning() || m_batchCourses.isEmpty()) return;
+    AnomalyOptions options;
+    options.courseIds = m_batchCourses.values();
+    options.reportFrom = m_batchFirstDate;
+    m_batchCourses.clear();
+    m_batchFirstDate = QDate();
+    m_anomalyWatcher.setFuture(QtConcurrent::run([options]() { return AnomalyScanner::scan(options); }));
+}
 
-    // 数据库连接校验
-    if (!DBManager::getInstance().m_db.isOpen()) {
-        QMessageBox::critical(this, "错误", "数据库未连接！");
+void ScoreInputWidget::onAnomalyScanFinished()
+{
+    AnomalyReport report = m_anomalyWatcher.result();
+    // 扫描期间又有批量录入完成：它们的科目留在 m_batchCourses 中，接着再扫一轮
+    // （仍有请求未返回时由最后一个返回的请求发起）
+    if (m_batchTickets.isEmpty()) startAnomalyScan();
+    if (!report.error.isEmpty()) {
+        qWarning() << "录入后异常检测失败：" << report.error;
         return;
     }
-
-    // 查询学生数据
-    QString sql = "SELECT student_id, student_name FROM students";
-    QSqlQuery query = DBManager::getInstance().execQuery(sql);
-
-    // 处理查询错误
-    if (query.lastError().isValid()) {
-        QMessageBox::warning(this, "错误", QString("查询学生失败：%1").arg(query.lastError().text()));
+    QString status = ui->labWriteStatus->text();
+    if (report.findings.isEmpty()) {
+        ui->labWriteStatus->setText(status + "；未发现异常成绩");
         return;
     }
+    ui->labWriteStatus->setText(status + QString("；发现 %1 处可疑成绩").arg(report.findings.size() + report.truncated));
+    AnomalyDialog *dialog = new AnomalyDialog(this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->showReport(report);
+    dialog->show();
+}
 
-    // 无学生数据提示
-    if (!query.next()) {
-        QMessageBox::warning(this, "提示", "students表中暂无学生数据，请先添加！");
+// ========== 刷新学生检索索引（学生表有变动时使用） ==========
+void ScoreInputWidget::on_btnLoadStudents_clicked()
+{
+    // 数据库连接校验
+    if (!DBManager::getInstance().m_db.isOpen()) {
+        QMessageBox::critical(this, "错误", "数据库未连接！");
         return;
     }
 
-    // 重置游标到开头，填充下拉框
-    query.seek(-1);
-    while (query.next()) {
-        QString studentName = query.value(1).toString();
-        QString studentId = query.value(0).toString();
-        QString itemText = QString("%1 (ID:%2)").arg(studentName, studentId);
-        ui->cbStudent->addItem(itemText, studentId);
-    }
+    m_studentPicker->clearSelection();
+    StudentIndex::getInstance().reload();
 }
 
 // ========== 批量录入：加载学生到表格 ==========
@@ -163,6 +227,7 @@ void ScoreInputWidget::on_btnLoadBatchStudents_clicked()
 {
     ui->tableBatchScore->clearContents();
     ui->tableBatchScore->setRowCount(0);
+    m_rosterPager.reset();
 
     // 数据库连接校验
     if (!DBManager::getInstance().m_db.isOpen()) {
@@ -170,43 +235,63 @@ void ScoreInputWidget::on_btnLoadBatchStudents_clicked()
         return;
     }
 
-    // 查询学生数据
-    QString sql = "SELECT student_id, student_name FROM students";
-    QSqlQuery query = DBManager::getInstance().execQuery(sql);
+    // 只加载第一页，其余随滚动加载
+    m_rosterPager = std::make_unique<RosterPager>(ui->cbBatchClass->currentData().toString());
+    appendRosterPage();
 
     // 无学生数据提示
-    if (!query.next()) {
-        QMessageBox::warning(this, "提示", "暂无学生数据！");
-        return;
+    if (ui->tableBatchScore->rowCount() == 0) {
+        QString error = m_rosterPager->lastError();
+        m_rosterPager.reset();
+        QMessageBox::warning(this, "提示", error.isEmpty() ? "暂无学生数据！" : "查询学生失败：" + error);
     }
+}
 
-    // 填充表格
-    query.seek(-1);
-    int row = 0;
-    while (query.next()) {
-        ui->tableBatchScore->insertRow(row);
+void ScoreInputWidget::appendRosterPage()
+{
+    if (!m_rosterPager || m_rosterPager->atEnd()) return;
 
+    QList<RosterRow> rows = m_rosterPager->nextPage();
+    QString today = QDate::currentDate().toString("yyyy-MM-dd");
+    int row = ui->tableBatchScore->rowCount();
+    ui->tableBatchScore->setRowCount(row + rows.size());
+    for (const RosterRow& student : rows) {
         // 学生ID（不可编辑）
-        QTableWidgetItem *idItem = new QTableWidgetItem(query.value(0).toString());
+        QTableWidgetItem *idItem = new QTableWidgetItem(QString::number(student.studentId));
         idItem->setFlags(idItem->flags() & ~Qt::ItemIsEditable);
         ui->tableBatchScore->setItem(row, 0, idItem);
 
         // 学生姓名（不可编辑）
-        QTableWidgetItem *nameItem = new QTableWidgetItem(query.value(1).toString());
+        QTableWidgetItem *nameItem = new QTableWidgetItem(student.name);
         nameItem->setFlags(nameItem->flags() & ~Qt::ItemIsEditable);
         ui->tableBatchScore->setItem(row, 1, nameItem);
 
-        // 科目（空，手动填写）
+        // 科目、成绩（空，手动填写）
         ui->tableBatchScore->setItem(row, 2, new QTableWidgetItem(""));
-
-        // 成绩（空，手动填写）
         ui->tableBatchScore->setItem(row, 3, new QTableWidgetItem(""));
 
         // 日期（当前日期）
-        ui->tableBatchScore->setItem(row, 4, new QTableWidgetItem(QDate::currentDate().toString("yyyy-MM-dd")));
-
+        ui->tableBatchScore->setItem(row, 4, new QTableWidgetItem(today));
         row++;
     }
+    // 等表格按新行数更新滚动范围后再检查是否还要补页
+    QMetaObject::invokeMethod(this, &ScoreInputWidget::fillRosterViewport, Qt::QueuedConnection);
+}
+
+void ScoreInputWidget::fillRosterViewport()
+{
+    if (m_rosterPager && !m_rosterPager->atEnd() && ui->tableBatchScore->verticalScrollBar()->maximum() == 0) {
+        appendRosterPage();
+    }
+}
+
+void ScoreInputWidget::loadBatchClassList()
+{
+    ui->cbBatchClass->clear();
+    ui->cbBatchClass->addItem("全部班级", "");
+    for (const QString& className : RosterPager::classNames()) {
+        ui->cbBatchClass->addItem(className, className);
+    }
 }
 
 // ========== 批量录入：提交批量成绩 ==========
@@ -218,8 +303,9 @@ void ScoreInputWidget::on_btnBatchSubmit_clicked()
         return;
     }
 
-    int successCount = 0;
-    int failCount = 0;
+    // 行校验在界面线程完成，合法行一次性交给写线程分组提交
+    QList<ScoreWrite> writes;
+    int invalidCount = 0;
 
     // 遍历表格行
     for (int row = 0; row < ui->tableBatchScore->rowCount(); row++) {
@@ -230,7 +316,7 @@ void ScoreInputWidget::on_btnBatchSubmit_clicked()
         QTableWidgetItem *dateItem = ui->tableBatchScore->item(row, 4);
 
         if (!idItem || !courseItem || !scoreItem || !dateItem) {
-            failCount++;
+            invalidCount++;
             continue;
         }
 
@@ -238,42 +324,51 @@ void ScoreInputWidget::on_btnBatchSubmit_clicked()
         QString studentId = idItem->text().trimmed();
         QString courseName = courseItem->text().trimmed();
         QString scoreStr = scoreItem->text().trimmed();
-        QString examDate = dateItem->text().trimmed();
+        QDate examDate = QDate::fromString(dateItem->text().trimmed(), "yyyy-MM-dd");
 
         // 基础校验
-        if (courseName.isEmpty() || scoreStr.isEmpty() || !validateScore(scoreStr)) {
-            failCount++;
+        if (courseName.isEmpty() || scoreStr.isEmpty() || !validateScore(scoreStr) || !examDate.isValid()
+            || DBManager::getInstance().isArchivedDate(examDate)) {
+            invalidCount++;
             continue;
         }
 
         // 获取course_id
         int courseId = getCourseIdByName(courseName);
         if (courseId == -1) {
-            failCount++;
+            invalidCount++;
             continue;
         }
 
-        // 插入数据库
-        QString insertSql = "INSERT INTO scores (student_id, course_id, score, exam_date) VALUES (?, ?, ?, ?)";
-        QSqlQuery insertQuery;
-        insertQuery.prepare(insertSql);
-        insertQuery.addBindValue(studentId);
-        insertQuery.addBindValue(courseId);
-        insertQuery.addBindValue(scoreStr);
-        insertQuery.addBindValue(examDate);
-
-        if (insertQuery.exec()) {
-            successCount++;
-        } else {
-            failCount++;
-            qDebug() << "批量插入失败行" << row << "：" << insertQuery.lastError().text();
-        }
+        m_batchCourses.insert(courseId);
+        if (!m_batchFirstDate.isValid() || examDate < m_batchFirstDate) m_batchFirstDate = examDate;
+
+        ScoreWrite write;
+        write.studentId = studentId;
+        write.courseId = courseId;
+        write.score = scoreStr.toDouble();
+        write.examDate = examDate;
+        write.rejectDuplicate = false; // 批量录入沿用原逻辑，不做重复校验
+        writes.append(write);
+    }
+
+    // 上一次批量提交的结果仍在返回中时，计数累加
+    if (m_batchTickets.isEmpty()) {
+        m_batchSuccess = 0;
+        m_batchFail = 0;
     }
+    m_batchFail += invalidCount;
+    const QList<quint64> tickets = ScoreWriter::getInstance().submitBatch(writes);
+    for (quint64 ticket : tickets) m_batchTickets.insert(ticket);
 
-    // 显示结果
-    QMessageBox::information(this, "批量录入结果",
-                             QString("成功录入：%1条\n失败：%2条").arg(successCount).arg(failCount));
+    // 结果由写线程异步返回，显示在状态栏
+    if (m_batchTickets.isEmpty()) {
+        ui->labWriteStatus->setText(QString("批量录入完成：成功%1条，失败%2条").arg(m_batchSuccess).arg(m_batchFail));
+    } else {
+        ui->labWriteStatus->setText(QString("批量录入中：剩余%1条").arg(m_batchTickets.size()));
+    }
     // 清空表格
     ui->tableBatchScore->clearContents();
     ui->tableBatchScore->setRowCount(0);
+    m_rosterPager.reset();
 }
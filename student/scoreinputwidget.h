@@ -4,6 +4,14 @@
 #include <QWidget>
 #include <QSqlQuery>
 #include <QDate>
+#include "studentpicker.h"
+#include "rosterpager.h"
+#include "scorewriter.h"
+#include "anomalyscanner.h"
+#include <QFutureWatcher>
+#include <QHash>
+#include <QSet>
+#include <memory>
 
 namespace Ui {
 class ScoreInputWidget;
@@ -26,14 +34,35 @@ private slots:
     void on_btnLoadBatchStudents_clicked();
     // 批量提交成绩
     void on_btnBatchSubmit_clicked();
+    // 写线程返回的录入结果
+    void onWriteFinished(const ScoreWriteResult& result);
+    // 批量录入后的异常检测完成
+    void onAnomalyScanFinished();
 
 private:
     // 工具函数：通过科目名称获取course_id
     int getCourseIdByName(const QString& courseName);
     // 工具函数：校验成绩合法性（0-100的数字）
     bool validateScore(const QString& scoreStr);
+    // 批量表格追加下一页学生（滚动到底部时调用）
+    void appendRosterPage();
+    // 已加载的行撑不出滚动条时继续取页，否则永远等不到滚动
+    void fillRosterViewport();
+    // 班级筛选下拉框
+    void loadBatchClassList();
+    // 批量录入全部返回后，在后台检查本次涉及的科目
+    void startAnomalyScan();
 
     Ui::ScoreInputWidget *ui;
+    StudentPicker *m_studentPicker; // 学生搜索选择（cbStudent）
+    std::unique_ptr<RosterPager> m_rosterPager; // 批量表格的分页读取状态
+    QHash<quint64, QString> m_singleTickets; // 单条录入中的请求号 -> 显示文字
+    QSet<quint64> m_batchTickets;            // 批量录入中尚未返回的请求号
+    int m_batchSuccess = 0;
+    int m_batchFail = 0;
+    QSet<int> m_batchCourses;                // 本轮批量录入涉及的科目与最早考试日期
+    QDate m_batchFirstDate;
+    QFutureWatcher<AnomalyReport> m_anomalyWatcher;
 };
 
 #endif // SCOREINPUTWIDGET_H
@@ -0,0 +1,222 @@
+#include "scorepivot.h"
+#include "dbmanager.h"
+#include "schema.h"
+#include <QHash>
+#include <cmath>
+#include <limits>
+
+const float *PivotMatrix::column(Measure measure, int course) const
+{
+    const std::vector<float>& values = measure == Latest ? latest : measure == Best ? best : average;
+    return values.data() + cell(0, course);
+}
+
+qint64 PivotMatrix::memoryUsage() const
+{
+    qint64 bytes = qint64(latest.capacity() + best.capacity() + average.capacity()) * qint64(sizeof(float))
+                   + qint64(latestDay.capacity()) * qint64(sizeof(qint32))
+                   + qint64(counts.capacity()) * qint64(sizeof(quint16))
+                   + qint64(studentIds.capacity()) * qint64(sizeof(qint64))
+                   + qint64(courseIds.capacity()) * qint64(sizeof(int));
+    for (const QStringList *names : {&studentNames, &classNames, &courseNames}) {
+        for (const QString& name : *names) bytes += qint64(sizeof(QString)) + 16 + name.size() * 2;
+    }
+    return bytes;
+}
+
+// ========== 构建矩阵 ==========
+std::shared_ptr<const PivotMatrix> ScorePivot::build(const QDate& from, const QDate& to, const QString& classPattern,
+                                                     QString *errorMessage)
+{
+    auto fail = [errorMessage](const QString& message) {
+        if (errorMessage) *errorMessage = message;
+        return std::shared_ptr<const PivotMatrix>();
+    };
+
+    DBManager& db = DBManager::getInstance();
+    QSqlDatabase connection = db.threadConnection();
+    auto matrix = std::make_shared<PivotMatrix>();
+
+    // 1. 学生行：按班级、学号排列，学号 -> 行下标
+    using Schema::Students;
+    using StudentRows = Schema::Select<Students, Students::StudentId, Students::StudentName, Students::ClassName>;
+    QString studentSql = StudentRows::sql(classPattern.isEmpty() ? QString() : "class_name LIKE ?")
+                         + " ORDER BY class_name, student_id";
+    QSqlQuery studentQuery(connection);
+    studentQuery.setForwardOnly(true);
+    studentQuery.prepare(studentSql);
+    if (!classPattern.isEmpty()) studentQuery.addBindValue(QString("%%1%").arg(classPattern));
+    if (!studentQuery.exec()) return fail("查询学生失败：" + studentQuery.lastError().text());
+    QHash<qint64, int> studentRow;
+    while (studentQuery.next()) {
+        qint64 id = studentQuery.value(StudentRows::at<Students::StudentId>()).toLongLong();
+        studentRow.insert(id, matrix->studentIds.size());
+        matrix->studentIds.append(id);
+        matrix->studentNames.append(studentQuery.value(StudentRows::at<Students::StudentName>()).toString());
+        matrix->classNames.append(studentQuery.value(StudentRows::at<Students::ClassName>()).toString());
+    }
+
+    // 2. 科目列：course_id -> 列下标
+    using Schema::Courses;
+    using CourseColumns = Schema::Select<Courses, Courses::CourseId, Courses::CourseName>;
+    QSqlQuery courseQuery(connection);
+    courseQuery.setForwardOnly(true);
+    if (!courseQuery.exec(CourseColumns::sql() + " ORDER BY course_id")) {
+        return fail("查询课程失败：" + courseQuery.lastError().text());
+    }
+    QHash<int, int> courseColumn;
+    while (courseQuery.next()) {
+        int id = courseQuery.value(CourseColumns::at<Courses::CourseId>()).toInt();
+        courseColumn.insert(id, matrix->courseIds.size());
+        matrix->courseIds.append(id);
+        matrix->courseNames.append(courseQuery.value(CourseColumns::at<Courses::CourseName>()).toString());
+    }
+
+    const qsizetype cells = qsizetype(matrix->studentCount()) * matrix->courseCount();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    matrix->latest.assign(cells, nan);
+    matrix->best.assign(cells, nan);
+    matrix->average.assign(cells, 0.0f); // 扫描时先存总分
+    matrix->latestDay.assign(cells, std::numeric_limits<qint32>::min());
+    matrix->counts.assign(cells, 0);
+    if (cells == 0) return matrix;
+
+    // 3. 一次扫描成绩：只取四个定长列，班级条件下推到子查询
+    using Schema::Scores;
+    using ScoreCells = Schema::Select<Scores, Scores::StudentId, Scores::CourseId, Scores::Score, Scores::ExamDate>;
+    QString scoreSql = ScoreCells::sql("course_id IS NOT NULL" + DBManager::dateRangeSql("exam_date", from, to),
+                                       db.scoreSource(from, to) + " sc");
+    if (!classPattern.isEmpty()) scoreSql += " AND student_id IN (SELECT student_id FROM students WHERE class_name LIKE ?)";
+    QSqlQuery scoreQuery(connection);
+    scoreQuery.setForwardOnly(true);
+    scoreQuery.prepare(scoreSql);
+    if (!classPattern.isEmpty()) scoreQuery.addBindValue(QString("%%1%").arg(classPattern));
+    if (!scoreQuery.exec()) return fail("查询成绩失败：" + scoreQuery.lastError().text());
+
+    // 学生/科目不在映射中（已删除或班级不匹配）的行直接跳过
+    while (scoreQuery.next()) {
+        matrix->scannedRows++;
+        auto student = studentRow.constFind(scoreQuery.value(ScoreCells::at<Scores::StudentId>()).toLongLong());
+        auto course = courseColumn.constFind(scoreQuery.value(ScoreCells::at<Scores::CourseId>()).toInt());
+        if (student == studentRow.constEnd() || course == courseColumn.constEnd()) continue;
+
+        qsizetype index = matrix->cell(student.value(), course.value());
+        float score = float(DBManager::scoreAt(scoreQuery, ScoreCells::at<Scores::Score>()));
+        qint32 day = qint32(scoreQuery.value(ScoreCells::at<Scores::ExamDate>()).toLongLong());
+
+        if (day >= matrix->latestDay[index]) {
+            matrix->latestDay[index] = day;
+            matrix->latest[index] = score;
+        }
+        if (!(matrix->best[index] >= score)) matrix->best[index] = score; // NaN 时直接取新值
+        matrix->average[index] += score;
+        if (matrix->counts[index] < std::numeric_limits<quint16>::max()) matrix->counts[index]++;
+    }
+
+    for (qsizetype i = 0; i < cells; i++) {
+        matrix->average[i] = matrix->counts[i] > 0 ? matrix->average[i] / matrix->counts[i] : nan;
+    }
+    return matrix;
+}
+
+// ========== 相关系数 ==========
+namespace {
+
+// 一对科目的六个累加量。x/y 为已按列均值中心化的成绩（缺失记0），mx/my 为有无成绩（1/0），
+// 用乘以掩码代替分支；按 kLanes 路独立累加，不依赖浮点重结合即可被向量化
+struct PairSums {
+    double n = 0, sx = 0, sy = 0, sxy = 0, sxx = 0, syy = 0;
+};
+
+PairSums pairSums(const float *x, const float *mx, const float *y, const float *my, qsizetype count)
+{
+    constexpr int kLanes = 8;
+    float n[kLanes] = {}, sx[kLanes] = {}, sy[kLanes] = {}, sxy[kLanes] = {}, sxx[kLanes] = {}, syy[kLanes] = {};
+    qsizetype i = 0;
+    for (; i + kLanes <= count; i += kLanes) {
+        for (int k = 0; k < kLanes; k++) {
+            const float a = x[i + k], b = y[i + k], ma = mx[i + k], mb = my[i + k];
+            n[k] += ma * mb;
+            sx[k] += a * mb;
+            sy[k] += b * ma;
+            sxy[k] += a * b;
+            sxx[k] += a * a * mb;
+            syy[k] += b * b * ma;
+        }
+    }
+    PairSums sums;
+    for (int k = 0; k < kLanes; k++) {
+        sums.n += n[k];
+        sums.sx += sx[k];
+        sums.sy += sy[k];
+        sums.sxy += sxy[k];
+        sums.sxx += sxx[k];
+        sums.syy += syy[k];
+    }
+    for (; i < count; i++) {
+        const float a = x[i], b = y[i], ma = mx[i], mb = my[i];
+        sums.n += ma * mb;
+        sums.sx += a * mb;
+        sums.sy += b * ma;
+        sums.sxy += a * b;
+        sums.sxx += a * a * mb;
+        sums.syy += b * b * ma;
+    }
+    return sums;
+}
+
+} // namespace
+
+PivotCorrelation ScorePivot::correlate(const PivotMatrix& matrix, PivotMatrix::Measure measure, int minPairs)
+{
+    PivotCorrelation result;
+    result.measure = measure;
+    const int courses = matrix.courseCount();
+    const int students = matrix.studentCount();
+    result.courseCount = courses;
+    result.r.assign(size_t(courses) * courses, std::numeric_limits<double>::quiet_NaN());
+    result.pairs.assign(size_t(courses) * courses, 0);
+
+    // 每科中心化一次（减去该科均值），避免大数相减损失精度
+    std::vector<float> centered(size_t(courses) * students, 0.0f);
+    std::vector<float> present(size_t(courses) * students, 0.0f);
+    for (int c = 0; c < courses; c++) {
+        const float *values = matrix.column(measure, c);
+        double total = 0;
+        int count = 0;
+        for (int s = 0; s < students; s++) {
+            if (!std::isnan(values[s])) {
+                total += values[s];
+                count++;
+            }
+        }
+        const float mean = count > 0 ? float(total / count) : 0.0f;
+        float *x = centered.data() + size_t(c) * students;
+        float *m = present.data() + size_t(c) * students;
+        for (int s = 0; s < students; s++) {
+            if (!std::isnan(values[s])) {
+                x[s] = values[s] - mean;
+                m[s] = 1.0f;
+            }
+        }
+    }
+
+    for (int a = 0; a < courses; a++) {
+        for (int b = a; b < courses; b++) {
+            PairSums sums = pairSums(centered.data() + size_t(a) * students, present.data() + size_t(a) * students,
+                                     centered.data() + size_t(b) * students, present.data() + size_t(b) * students,
+                                     students);
+            qint32 pairs = qint32(std::llround(sums.n));
+            double r = std::numeric_limits<double>::quiet_NaN();
+            if (pairs >= minPairs) {
+                double cov = sums.sxy - sums.sx * sums.sy / sums.n;
+                double varX = sums.sxx - sums.sx * sums.sx / sums.n;
+                double varY = sums.syy - sums.sy * sums.sy / sums.n;
+                if (varX > 0 && varY > 0) r = qBound(-1.0, cov / std::sqrt(varX * varY), 1.0);
+            }
+            result.r[size_t(a) * courses + b] = result.r[size_t(b) * courses + a] = r;
+            result.pairs[size_t(a) * courses + b] = result.pairs[size_t(b) * courses + a] = pairs;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,64 @@
+#ifndef SCOREPIVOT_H
+#define SCOREPIVOT_H
+
+#include <QString>
+#include <QStringList>
+#include <QDate>
+#include <QVector>
+#include <memory>
+#include <vector>
+
+// 学生×科目 成绩矩阵。按科目列优先连续存放（每个科目一段长度为 studentCount 的数组），
+// 空单元格为 NaN；5万学生×30科目 每种取值约 6MB
+struct PivotMatrix {
+    enum Measure { Latest, Best, Average };
+
+    QVector<qint64> studentIds;
+    QStringList studentNames;
+    QStringList classNames;
+    QVector<int> courseIds;
+    QStringList courseNames;
+
+    std::vector<float> latest;          // 最近一次考试成绩
+    std::vector<float> best;            // 最高分
+    std::vector<float> average;         // 平均分
+    std::vector<qint32> latestDay;      // 最近一次考试日期（儒略日）
+    std::vector<quint16> counts;        // 考试次数
+
+    qint64 scannedRows = 0;
+
+    int studentCount() const { return studentIds.size(); }
+    int courseCount() const { return courseIds.size(); }
+    // 矩阵占用的堆内存（估算，字节）
+    qint64 memoryUsage() const;
+    qsizetype cell(int student, int course) const { return qsizetype(course) * studentIds.size() + student; }
+    // 某种取值的一列（科目），长度为 studentCount
+    const float *column(Measure measure, int course) const;
+    float value(Measure measure, int student, int course) const { return column(measure, course)[student]; }
+};
+
+// 科目间相关系数矩阵（对称，courseCount×courseCount，行优先）
+struct PivotCorrelation {
+    PivotMatrix::Measure measure = PivotMatrix::Average;
+    int courseCount = 0;
+    std::vector<double> r;      // 皮尔逊相关系数，样本不足时为 NaN
+    std::vector<qint32> pairs;  // 两科都有成绩的学生数
+
+    double at(int a, int b) const { return r[size_t(a) * courseCount + b]; }
+    qint32 pairCount(int a, int b) const { return pairs[size_t(a) * courseCount + b]; }
+};
+
+// 成绩透视：一次只进扫描成绩表填充稠密矩阵（学生/科目先映射为连续下标），
+// 相关系数按列成对计算，内层为无分支的定宽累加循环便于编译器向量化
+class ScorePivot
+{
+public:
+    // 应在工作线程调用；classPattern 为班级名模糊匹配（空为全部），失败返回空指针
+    static std::shared_ptr<const PivotMatrix> build(const QDate& from, const QDate& to, const QString& classPattern,
+                                                    QString *errorMessage = nullptr);
+
+    // 两科都有成绩的学生少于 minPairs 时结果为 NaN
+    static PivotCorrelation correlate(const PivotMatrix& matrix, PivotMatrix::Measure measure, int minPairs = 3);
+};
+
+#endif // SCOREPIVOT_H
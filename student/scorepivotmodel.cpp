@@ -0,0 +1,144 @@
+#include "scorepivotmodel.h"
+#include <QColor>
+#include <cmath>
+
+// ========== 成绩矩阵 ==========
+PivotTableModel::PivotTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+void PivotTableModel::setMatrix(std::shared_ptr<const PivotMatrix> matrix)
+{
+    beginResetModel();
+    m_matrix = std::move(matrix);
+    endResetModel();
+}
+
+void PivotTableModel::setMeasure(PivotMatrix::Measure measure)
+{
+    if (measure == m_measure) return;
+    m_measure = measure;
+    // 只是取值口径变化，行列不变
+    if (m_matrix && m_matrix->courseCount() > 0) {
+        emit dataChanged(index(0, FixedColumnCount), index(rowCount() - 1, columnCount() - 1));
+    }
+}
+
+int PivotTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() || !m_matrix ? 0 : m_matrix->studentCount();
+}
+
+int PivotTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() || !m_matrix ? 0 : FixedColumnCount + m_matrix->courseCount();
+}
+
+QVariant PivotTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!m_matrix || !index.isValid()) return QVariant();
+    const int student = index.row();
+    const int column = index.column();
+
+    if (column < FixedColumnCount) {
+        if (role != Qt::DisplayRole) return QVariant();
+        switch (column) {
+        case IdColumn: return m_matrix->studentIds.at(student);
+        case NameColumn: return m_matrix->studentNames.at(student);
+        default: return m_matrix->classNames.at(student);
+        }
+    }
+
+    const int course = column - FixedColumnCount;
+    const float value = m_matrix->value(m_measure, student, course);
+    switch (role) {
+    case Qt::DisplayRole:
+        // 缺考为空；返回数值以便代理模型按数值排序
+        if (std::isnan(value)) return QVariant();
+        return m_measure == PivotMatrix::Average ? QVariant(std::round(value * 10) / 10.0) : QVariant(double(value));
+    case Qt::TextAlignmentRole:
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    case Qt::ForegroundRole:
+        return (!std::isnan(value) && value < 60) ? QVariant(QColor(Qt::red)) : QVariant();
+    case Qt::ToolTipRole: {
+        qsizetype cell = m_matrix->cell(student, course);
+        if (m_matrix->counts[cell] == 0) return QVariant();
+        return QString("考试%1次 最近：%2（%3） 最高：%4 平均：%5")
+            .arg(m_matrix->counts[cell])
+            .arg(m_matrix->latest[cell])
+            .arg(QDate::fromJulianDay(m_matrix->latestDay[cell]).toString("yyyy-MM-dd"))
+            .arg(m_matrix->best[cell])
+            .arg(m_matrix->average[cell], 0, 'f', 1);
+    }
+    default:
+        return QVariant();
+    }
+}
+
+QVariant PivotTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) return QVariant();
+    if (orientation == Qt::Vertical) return section + 1;
+    switch (section) {
+    case IdColumn: return "学号";
+    case NameColumn: return "姓名";
+    case ClassColumn: return "班级";
+    default:
+        return m_matrix ? m_matrix->courseNames.value(section - FixedColumnCount) : QVariant();
+    }
+}
+
+// ========== 相关系数 ==========
+CorrelationTableModel::CorrelationTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+void CorrelationTableModel::setCorrelation(const PivotCorrelation& correlation, const QStringList& courseNames)
+{
+    beginResetModel();
+    m_correlation = correlation;
+    m_courseNames = courseNames;
+    endResetModel();
+}
+
+int CorrelationTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_correlation.courseCount;
+}
+
+int CorrelationTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_correlation.courseCount;
+}
+
+QVariant CorrelationTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid()) return QVariant();
+    const double r = m_correlation.at(index.row(), index.column());
+    switch (role) {
+    case Qt::DisplayRole:
+        return std::isnan(r) ? QString("--") : QString::number(r, 'f', 2);
+    case Qt::TextAlignmentRole:
+        return int(Qt::AlignCenter);
+    case Qt::BackgroundRole: {
+        if (std::isnan(r)) return QVariant();
+        // |r| 越大颜色越深
+        int shade = 255 - int(std::abs(r) * 155);
+        return r >= 0 ? QColor(255, shade, shade) : QColor(shade, shade, 255);
+    }
+    case Qt::ToolTipRole:
+        return QString("%1 × %2：两科都有成绩的学生 %3 人")
+            .arg(m_courseNames.value(index.row()), m_courseNames.value(index.column()))
+            .arg(m_correlation.pairCount(index.row(), index.column()));
+    default:
+        return QVariant();
+    }
+}
+
+QVariant CorrelationTableModel::headerData(int section, Qt::Orientation /*orientation*/, int role) const
+{
+    if (role != Qt::DisplayRole) return QVariant();
+    return m_courseNames.value(section);
+}
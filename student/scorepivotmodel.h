@@ -0,0 +1,53 @@
+#ifndef SCOREPIVOTMODEL_H
+#define SCOREPIVOTMODEL_H
+
+#include <QAbstractTableModel>
+#include <memory>
+#include "scorepivot.h"
+
+// 学生×科目 成绩矩阵的只读表格模型：不复制数据，单元格按需从矩阵取值
+// 列：学号、姓名、班级、各科目
+class PivotTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum FixedColumn { IdColumn, NameColumn, ClassColumn, FixedColumnCount };
+
+    explicit PivotTableModel(QObject *parent = nullptr);
+
+    void setMatrix(std::shared_ptr<const PivotMatrix> matrix);
+    void setMeasure(PivotMatrix::Measure measure);
+    PivotMatrix::Measure measure() const { return m_measure; }
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    std::shared_ptr<const PivotMatrix> m_matrix;
+    PivotMatrix::Measure m_measure = PivotMatrix::Latest;
+};
+
+// 科目间相关系数矩阵模型，单元格按系数着色（正相关红、负相关蓝）
+class CorrelationTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit CorrelationTableModel(QObject *parent = nullptr);
+
+    void setCorrelation(const PivotCorrelation& correlation, const QStringList& courseNames);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    PivotCorrelation m_correlation;
+    QStringList m_courseNames;
+};
+
+#endif // SCOREPIVOTMODEL_H
@@ -0,0 +1,158 @@
+#include "scorepivotwidget.h"
+#include "ui_scorepivotwidget.h"
+#include "scorepivotmodel.h"
+#include "collationsortproxy.h"
+#include "datasnapshot.h"
+#include "memoryaccounting.h"
+#include "rosterpager.h"
+#include <QElapsedTimer>
+#include <QHeaderView>
+#include <QtConcurrent>
+
+ScorePivotWidget::ScorePivotWidget(QWidget *parent) :
+    QWidget(parent),
+    ui(new Ui::ScorePivotWidget),
+    m_matrixModel(new PivotTableModel(this)),
+    m_matrixProxy(new CollationSortProxy(this)),
+    m_correlationModel(new CorrelationTableModel(this))
+{
+    ui->setupUi(this);
+    this->setWindowTitle("成绩矩阵");
+
+    // 姓名/班级按拼音排序，成绩列按数值排序（空单元格排在最前）
+    m_matrixProxy->setCollatedColumns({PivotTableModel::NameColumn, PivotTableModel::ClassColumn});
+    m_matrixProxy->setSourceModel(m_matrixModel);
+    ui->tableMatrix->setModel(m_matrixProxy);
+    ui->tableMatrix->setSortingEnabled(true);
+    ui->tableMatrix->setSelectionBehavior(QAbstractItemView::SelectRows);
+    // 5万行时不按内容计算行高
+    ui->tableMatrix->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    ui->tableCorrelation->setModel(m_correlationModel);
+
+    loadClassList();
+    connect(ui->cbxPivotClass, &QComboBox::currentIndexChanged, this, &ScorePivotWidget::on_btnPivotRefresh_clicked);
+    connect(ui->cbxMeasure, &QComboBox::currentIndexChanged, this, &ScorePivotWidget::onMeasureChanged);
+    connect(&m_watcher, &QFutureWatcher<BuildResult>::finished, this, &ScorePivotWidget::onBuildFinished);
+
+    MemoryAccounting& accounting = MemoryAccounting::getInstance();
+    accounting.registerProbe("pivot", "成绩矩阵", this, [this]() {
+        if (!m_matrix) return MemorySample();
+        return MemorySample{qint64(m_matrix->studentCount()) * m_matrix->courseCount(), m_matrix->memoryUsage()};
+    });
+    accounting.registerProbe("pivot", "姓名/班级排序键", this, [this]() {
+        return MemorySample{m_matrixProxy->cachedKeyCount(), qint64(m_matrixProxy->cacheMemoryUsage())};
+    });
+    // 超出预算时：页面不可见则释放矩阵，切换回本页时重建
+    accounting.registerTrimHandler("pivot", this, [this]() {
+        if (isVisible() || !m_matrix || m_watcher.isRunning()) return;
+        m_matrixModel->setMatrix(nullptr);
+        m_correlationModel->setCorrelation(PivotCorrelation(), QStringList());
+        m_matrixProxy->clearKeyCache();
+        m_matrix.reset();
+        m_dirty = true;
+        ui->labPivotStatus->setText("内存不足，已释放矩阵");
+    });
+}
+
+ScorePivotWidget::~ScorePivotWidget()
+{
+    m_watcher.waitForFinished();
+    delete ui;
+}
+
+void ScorePivotWidget::loadClassList()
+{
+    DataSnapshot& snapshot = DataSnapshot::getInstance();
+    ui->cbxPivotClass->clear();
+    ui->cbxPivotClass->addItem("全部");
+    ui->cbxPivotClass->addItems(snapshot.isLoaded() ? snapshot.classNames() : RosterPager::classNames());
+}
+
+void ScorePivotWidget::setDateRange(const QDate& from, const QDate& to)
+{
+    m_dateFrom = from;
+    m_dateTo = to;
+    m_dirty = true;
+    if (isVisible()) rebuild();
+}
+
+void ScorePivotWidget::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    // 首次切换到本页时才扫描成绩
+    if (m_dirty) rebuild();
+}
+
+void ScorePivotWidget::on_btnPivotRefresh_clicked()
+{
+    m_dirty = true;
+    rebuild();
+}
+
+// ========== 重建矩阵（工作线程） ==========
+void ScorePivotWidget::rebuild()
+{
+    if (m_watcher.isRunning()) {
+        m_rebuildQueued = true;
+        return;
+    }
+    m_dirty = false;
+    ui->labPivotStatus->setText("正在统计...");
+    ui->btnPivotRefresh->setEnabled(false);
+
+    QDate from = m_dateFrom;
+    QDate to = m_dateTo;
+    QString className = ui->cbxPivotClass->currentText();
+    QString classPattern = className == "全部" ? QString() : className;
+    auto measure = PivotMatrix::Measure(ui->cbxMeasure->currentIndex());
+    m_watcher.setFuture(QtConcurrent::run([from, to, classPattern, measure]() {
+        QElapsedTimer timer;
+        timer.start();
+        BuildResult result;
+        result.matrix = ScorePivot::build(from, to, classPattern, &result.error);
+        if (result.matrix) result.correlation = ScorePivot::correlate(*result.matrix, measure);
+        result.elapsedMs = timer.elapsed();
+        return result;
+    }));
+}
+
+void ScorePivotWidget::onBuildFinished()
+{
+    ui->btnPivotRefresh->setEnabled(true);
+    BuildResult result = m_watcher.result();
+    if (m_rebuildQueued) {
+        // 统计期间条件又变了，丢弃这次结果
+        m_rebuildQueued = false;
+        rebuild();
+        return;
+    }
+    if (!result.matrix) {
+        ui->labPivotStatus->setText("统计失败：" + result.error);
+        return;
+    }
+
+    m_matrix = result.matrix;
+    // 统计期间切换过取值口径时按当前口径重算相关系数
+    auto measure = PivotMatrix::Measure(ui->cbxMeasure->currentIndex());
+    m_matrixModel->setMeasure(measure);
+    m_matrixModel->setMatrix(m_matrix);
+    m_correlationModel->setCorrelation(result.correlation.measure == measure
+                                           ? result.correlation : ScorePivot::correlate(*m_matrix, measure),
+                                       m_matrix->courseNames);
+    ui->tableCorrelation->resizeColumnsToContents();
+    ui->labPivotStatus->setText(QString("学生 %1 人 × 科目 %2 门，扫描成绩 %3 条，用时 %4 ms")
+                                    .arg(m_matrix->studentCount())
+                                    .arg(m_matrix->courseCount())
+                                    .arg(m_matrix->scannedRows)
+                                    .arg(result.elapsedMs));
+}
+
+// 切换取值口径：矩阵不用重建，只重算相关系数（按列成对累加，5万×30 约几十毫秒）
+void ScorePivotWidget::onMeasureChanged(int index)
+{
+    auto measure = PivotMatrix::Measure(index);
+    m_matrixModel->setMeasure(measure);
+    if (m_matrix && !m_watcher.isRunning()) {
+        m_correlationModel->setCorrelation(ScorePivot::correlate(*m_matrix, measure), m_matrix->courseNames);
+    }
+}
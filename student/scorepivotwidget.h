@@ -0,0 +1,62 @@
+#ifndef SCOREPIVOTWIDGET_H
+#define SCOREPIVOTWIDGET_H
+
+#include <QWidget>
+#include <QDate>
+#include <QFutureWatcher>
+#include <memory>
+#include "scorepivot.h"
+
+class PivotTableModel;
+class CorrelationTableModel;
+class CollationSortProxy;
+
+namespace Ui {
+class ScorePivotWidget;
+}
+
+// 成绩矩阵页：每个学生一行、每个科目一列（最近/最高/平均成绩），另附科目间相关系数
+class ScorePivotWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ScorePivotWidget(QWidget *parent = nullptr);
+    ~ScorePivotWidget() override;
+
+public slots:
+    // 共用日期范围筛选（空日期表示不限）；页面可见时立即重建，否则切换到本页时再建
+    void setDateRange(const QDate& from, const QDate& to);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+
+private slots:
+    void on_btnPivotRefresh_clicked();
+    void onMeasureChanged(int index);
+    void onBuildFinished();
+
+private:
+    struct BuildResult {
+        std::shared_ptr<const PivotMatrix> matrix;
+        PivotCorrelation correlation;
+        QString error;
+        qint64 elapsedMs = 0;
+    };
+
+    void loadClassList();
+    void rebuild();
+
+    Ui::ScorePivotWidget *ui;
+    PivotTableModel *m_matrixModel;
+    CollationSortProxy *m_matrixProxy;
+    CorrelationTableModel *m_correlationModel;
+    QFutureWatcher<BuildResult> m_watcher;
+    std::shared_ptr<const PivotMatrix> m_matrix;
+    QDate m_dateFrom;
+    QDate m_dateTo;
+    bool m_dirty = true;        // 条件变化后尚未重建
+    bool m_rebuildQueued = false; // 重建进行中又有新条件
+};
+
+#endif // SCOREPIVOTWIDGET_H
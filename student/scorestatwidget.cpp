@@ -16,7 +16,40 @@
 #include <QFont>
 #include <QAxObject>
 #include <QVariant>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <QStyledItemDelegate>
 #include "dbmanager.h"
+#include "anomalydialog.h"
+#include "backgroundtask.h"
+#include "collationsortproxy.h"
+#include "datasnapshot.h"
+#include "gpadialog.h"
+#include "memoryaccounting.h"
+#include "resultset.h"
+#include "schema.h"
+#include "schooloverviewdialog.h"
+#include "scoreexporter.h"
+#include "transcriptgenerator.h"
+#include <QSignalBlocker>
+#include <memory>
+
+// 考试日期列显示：存储为儒略日整数，显示为 yyyy-MM-dd（排序仍按整数进行）
+class DayNumberDelegate : public QStyledItemDelegate
+{
+public:
+    using QStyledItemDelegate::QStyledItemDelegate;
+
+    QString displayText(const QVariant &value, const QLocale &/*locale*/) const override
+    {
+        return DBManager::fromDayNumber(value).toString("yyyy-MM-dd");
+    }
+};
+
+// Excel 导出的列（表格中可见的四列，外键列导出为名称）
+static constexpr std::array<Schema::Scores::Column, 4> kExportColumns{{
+    Schema::Scores::StudentId, Schema::Scores::CourseId, Schema::Scores::Score, Schema::Scores::ExamDate}};
 
 // 构造函数
 ScoreStatWidget::ScoreStatWidget(QWidget *parent) : QWidget(parent), ui(new Ui::ScoreStatWidget)
@@ -25,7 +58,9 @@ ScoreStatWidget::ScoreStatWidget(QWidget *parent) : QWidget(parent), ui(new Ui::
     this->setWindowTitle("成绩统计");
 
     initModel();
+    registerMemoryProbes();
     loadFilterOptions();
+    connect(&DataSnapshot::getInstance(), &DataSnapshot::rebuilt, this, &ScoreStatWidget::refreshFilterOptions);
 
     connect(ui->cbxClass, &QComboBox::currentIndexChanged, this, &ScoreStatWidget::filterData);
 
@@ -50,36 +85,26 @@ ScoreStatWidget::~ScoreStatWidget()
 // 初始化Model/View：核心修复关联配置
 void ScoreStatWidget::initModel()
 {
-    // 1. 创建关联模型：主表为scores
+    // 1. 创建关联模型：主表为 scores_all（当前成绩 + 已归档学期分区）
     m_relModel = new QSqlRelationalTableModel(this);
-    m_relModel->setTable("scores");
-
-
-    int studentIdCol = m_relModel->fieldIndex("student_id");
-    int courseIdCol = m_relModel->fieldIndex("course_id");
-    int scoreCol = m_relModel->fieldIndex("score");
-    int examDateCol = m_relModel->fieldIndex("exam_date");
-
+    m_relModel->setTable("scores_all");
 
-    if (studentIdCol != -1) {
-        m_relModel->setRelation(studentIdCol, QSqlRelation("students", "student_id", "student_name"));
-    }
-
-    if (courseIdCol != -1) {
-        m_relModel->setRelation(courseIdCol, QSqlRelation("courses", "course_id", "course_name"));
-    }
 
+    // scores_all 与 scores 列序相同（启动时已核对），列下标取编译期常量
+    using Schema::Scores;
+    m_relModel->setRelation(Scores::StudentId, QSqlRelation(Schema::tableName<Schema::Students>(),
+                                                            Schema::columnName<Schema::Students>(Schema::Students::StudentId),
+                                                            Schema::columnName<Schema::Students>(Schema::Students::StudentName)));
+    m_relModel->setRelation(Scores::CourseId, QSqlRelation(Schema::tableName<Schema::Courses>(),
+                                                           Schema::columnName<Schema::Courses>(Schema::Courses::CourseId),
+                                                           Schema::columnName<Schema::Courses>(Schema::Courses::CourseName)));
 
     m_relModel->setEditStrategy(QSqlTableModel::OnManualSubmit);
 
-    if (studentIdCol != -1)
-        m_relModel->setHeaderData(studentIdCol, Qt::Horizontal, "学生姓名");
-    if (courseIdCol != -1)
-        m_relModel->setHeaderData(courseIdCol, Qt::Horizontal, "课程名称");
-    if (scoreCol != -1)
-        m_relModel->setHeaderData(scoreCol, Qt::Horizontal, "成绩");
-    if (examDateCol != -1)
-        m_relModel->setHeaderData(examDateCol, Qt::Horizontal, "考试日期");
+    m_relModel->setHeaderData(Scores::StudentId, Qt::Horizontal, "学生姓名");
+    m_relModel->setHeaderData(Scores::CourseId, Qt::Horizontal, "课程名称");
+    m_relModel->setHeaderData(Scores::Score, Qt::Horizontal, "成绩");
+    m_relModel->setHeaderData(Scores::ExamDate, Qt::Horizontal, "考试日期");
 
 
     if (!m_relModel->select()) {
@@ -88,7 +113,9 @@ void ScoreStatWidget::initModel()
     }
 
 
-    m_proxyModel = new QSortFilterProxyModel(this);
+    // 学生姓名/课程名称列按拼音序排序（排序键按名称缓存），其它列按数值
+    m_proxyModel = new CollationSortProxy(this);
+    m_proxyModel->setCollatedColumns({Scores::StudentId, Scores::CourseId});
     m_proxyModel->setSourceModel(m_relModel);
     m_proxyModel->setFilterCaseSensitivity(Qt::CaseInsensitive);
 
@@ -98,39 +125,69 @@ void ScoreStatWidget::initModel()
     ui->tableView->setModel(m_proxyModel);
 
 
-    int scoreIdCol = m_relModel->fieldIndex("score_id");
-    if (scoreIdCol != -1) {
-        ui->tableView->hideColumn(scoreIdCol);
-    }
+    ui->tableView->hideColumn(Scores::ScoreId);
+    ui->tableView->setItemDelegateForColumn(Scores::ExamDate, new DayNumberDelegate(ui->tableView));
 }
 
+// ========== 内存记账 ==========
+void ScoreStatWidget::registerMemoryProbes()
+{
+    MemoryAccounting& accounting = MemoryAccounting::getInstance();
+    // 已取回的行由查询结果按单元格缓存（QVariant + 文本），按行数×列数估算
+    accounting.registerProbe("stat", "成绩表行缓存", this, [this]() {
+        constexpr qint64 cellBytes = sizeof(QVariant) + 16;
+        qint64 cells = qint64(m_relModel->rowCount()) * m_relModel->columnCount();
+        return MemorySample{cells, cells * cellBytes};
+    });
+    // 代理模型的行映射（源行/代理行各一个下标）与拼音排序键缓存
+    accounting.registerProbe("stat", "排序/筛选映射", this, [this]() {
+        qint64 rows = m_proxyModel->rowCount();
+        return MemorySample{m_proxyModel->cachedKeyCount(),
+                            qint64(m_proxyModel->cacheMemoryUsage()) + rows * 2 * qint64(sizeof(int))};
+    });
+    // 超出预算时：页面不可见则丢弃排序键并重新查询（只保留首批取回的行）
+    accounting.registerTrimHandler("stat", this, [this]() {
+        if (isVisible()) return;
+        m_proxyModel->clearKeyCache();
+        m_relModel->select();
+    });
+}
 
 void ScoreStatWidget::loadFilterOptions()
 {
-
-    QString sqlClass = "SELECT DISTINCT class_name FROM students WHERE class_name IS NOT NULL ORDER BY class_name";
-    QSqlQuery queryClass = DBManager::getInstance().execQuery(sqlClass);
-
-    ui->cbxClass->clear();
-    ui->cbxClass->addItem("全部");
-    while (queryClass.next()) {
-        QString className = queryClass.value(0).toString().trimmed();
-        if (!className.isEmpty()) {
-            ui->cbxClass->addItem(className);
+    // 启动快照已映射时直接取字典（即使已过期也先用，后台重建完成后 refreshFilterOptions 更新）
+    DataSnapshot& snapshot = DataSnapshot::getInstance();
+    if (snapshot.isLoaded()) {
+        fillFilterOptions(snapshot.classNames(), snapshot.courseNames());
+    } else {
+        using Schema::Students;
+        using Schema::Courses;
+        using ClassColumns = Schema::Select<Students, Students::ClassName>;
+        using CourseColumns = Schema::Select<Courses, Courses::CourseName>;
+
+        QStringList classes;
+        QString sqlClass = QString("SELECT DISTINCT %1 FROM %2 WHERE %1 IS NOT NULL ORDER BY %1")
+                               .arg(ClassColumns::columnList(), Schema::tableName<Students>());
+        QSqlQuery queryClass = DBManager::getInstance().execQuery(sqlClass);
+        while (queryClass.next()) {
+            QString className = queryClass.value(ClassColumns::at<Students::ClassName>()).toString().trimmed();
+            if (!className.isEmpty()) {
+                classes << className;
+            }
         }
-    }
-
-    // ===== 加载课程列表 =====
-    QString sqlCourse = "SELECT DISTINCT course_name FROM courses WHERE course_name IS NOT NULL ORDER BY course_name";
-    QSqlQuery queryCourse = DBManager::getInstance().execQuery(sqlCourse);
 
-    ui->cbxCourse->clear();
-    ui->cbxCourse->addItem("全部");
-    while (queryCourse.next()) {
-        QString courseName = queryCourse.value(0).toString().trimmed();
-        if (!courseName.isEmpty()) {
-            ui->cbxCourse->addItem(courseName);
+        // ===== 加载课程列表 =====
+        QStringList courses;
+        QString sqlCourse = QString("SELECT DISTINCT %1 FROM %2 WHERE %1 IS NOT NULL ORDER BY %1")
+                                .arg(CourseColumns::columnList(), Schema::tableName<Courses>());
+        QSqlQuery queryCourse = DBManager::getInstance().execQuery(sqlCourse);
+        while (queryCourse.next()) {
+            QString courseName = queryCourse.value(CourseColumns::at<Courses::CourseName>()).toString().trimmed();
+            if (!courseName.isEmpty()) {
+                courses << courseName;
+            }
         }
+        fillFilterOptions(classes, courses);
     }
 
     // 空数据提示
@@ -142,6 +199,37 @@ void ScoreStatWidget::loadFilterOptions()
     }
 }
 
+void ScoreStatWidget::fillFilterOptions(const QStringList& classes, const QStringList& courses)
+{
+    ui->cbxClass->clear();
+    ui->cbxClass->addItem("全部");
+    ui->cbxClass->addItems(classes);
+
+    ui->cbxCourse->clear();
+    ui->cbxCourse->addItem("全部");
+    ui->cbxCourse->addItems(courses);
+}
+
+// 启动快照重建完成：更新下拉框并保留当前选择，选择已不存在时重新筛选
+void ScoreStatWidget::refreshFilterOptions()
+{
+    DataSnapshot& snapshot = DataSnapshot::getInstance();
+    QString currentClass = ui->cbxClass->currentText();
+    QString currentCourse = ui->cbxCourse->currentText();
+    {
+        const QSignalBlocker classBlocker(ui->cbxClass);
+        const QSignalBlocker courseBlocker(ui->cbxCourse);
+        fillFilterOptions(snapshot.classNames(), snapshot.courseNames());
+        ui->cbxClass->setCurrentText(currentClass);
+        ui->cbxCourse->setCurrentText(currentCourse);
+    }
+    if (ui->cbxClass->currentText() != currentClass || ui->cbxCourse->currentText() != currentCourse) {
+        filterData();
+    } else {
+        statScores();
+    }
+}
+
 // 核心修复：筛选数据（适配代理模型+关联字段）
 void ScoreStatWidget::filterData()
 {
@@ -150,21 +238,30 @@ void ScoreStatWidget::filterData()
 
     QString filterString;
 
-    // 班级筛选：明确指定scores.student_id关联students表
+    // 班级筛选：明确指定scores_all.student_id关联students表
     if (targetClass != "全部") {
-        filterString += QString("scores.student_id IN (SELECT student_id FROM students WHERE class_name LIKE '%%1%')")
+        filterString += QString("scores_all.student_id IN (SELECT student_id FROM students WHERE class_name LIKE '%%1%')")
         .arg(targetClass);
     }
 
-    // 课程筛选：明确指定scores.course_id关联courses表
+    // 课程筛选：明确指定scores_all.course_id关联courses表
     if (targetCourse != "全部") {
         if (!filterString.isEmpty()) {
             filterString += " AND ";
         }
-        filterString += QString("scores.course_id IN (SELECT course_id FROM courses WHERE course_name LIKE '%%1%')")
+        filterString += QString("scores_all.course_id IN (SELECT course_id FROM courses WHERE course_name LIKE '%%1%')")
                             .arg(targetCourse);
     }
 
+    // 日期范围：整数比较，视图会把条件下推到各分区的 exam_date 索引
+    QString dateFilter = DBManager::dateRangeSql("scores_all.exam_date", m_dateFrom, m_dateTo);
+    if (!dateFilter.isEmpty()) {
+        if (filterString.isEmpty()) {
+            filterString = "1 = 1";
+        }
+        filterString += dateFilter;
+    }
+
     m_relModel->setFilter(filterString);
     if (!m_relModel->select()) {
         QMessageBox::critical(this, "错误", "筛选数据失败：" + m_relModel->lastError().text());
@@ -175,45 +272,77 @@ void ScoreStatWidget::filterData()
     statScores();
 }
 
-// ========== 修复统计逻辑：基于筛选后的结果 ==========
+// 共用日期范围变化：重新筛选
+void ScoreStatWidget::setDateRange(const QDate& from, const QDate& to)
+{
+    m_dateFrom = from;
+    m_dateTo = to;
+    filterData();
+}
+
+void ScoreStatWidget::reload()
+{
+    filterData();
+}
+
+// ========== 统计逻辑：读取预聚合的 score_summary，代价与分组数成正比 ==========
 void ScoreStatWidget::statScores()
 {
-    float avgScore = 0.0f;
-    float maxScore = -1.0f;
-    float minScore = 101.0f;
-    int validCount = 0;
-
-    // 成绩列索引：从模型获取，避免硬编码
-    int scoreCol = m_relModel->fieldIndex("score");
-    if (scoreCol == -1) {
-        ui->labAvg->setText("平均分：--");
-        ui->labMax->setText("最高分：--");
-        ui->labMin->setText("最低分：--");
-        return;
-    }
+    QString targetClass = ui->cbxClass->currentText().trimmed();
+    QString targetCourse = ui->cbxCourse->currentText().trimmed();
 
-    for (int row = 0; row < m_proxyModel->rowCount(); row++) {
-        QModelIndex scoreIndex = m_proxyModel->index(row, scoreCol);
-        if (!scoreIndex.isValid()) continue;
+    QString classPattern = targetClass != "全部" ? targetClass : QString();
+    QString coursePattern = targetCourse != "全部" ? targetCourse : QString();
+
+    // 不限日期时直接用启动快照中的 班级×科目 预聚合（快照与库版本一致才会返回结果）
+    SnapshotStats stats;
+    bool fromSnapshot = !m_dateFrom.isValid() && !m_dateTo.isValid()
+                        && DataSnapshot::getInstance().summarize(classPattern, coursePattern, &stats);
+    if (!fromSnapshot) {
+        // 筛选条件与 filterData 保持一致（模糊匹配班级/课程名）
+        QString sql = "SELECT SUM(cnt), SUM(total), SUM(total_sq), MIN(min_score), MAX(max_score) "
+                      "FROM score_summary WHERE 1 = 1";
+        QVariantList binds;
+        if (!classPattern.isEmpty()) {
+            sql += " AND class_name LIKE ?";
+            binds << QString("%%1%").arg(classPattern);
+        }
+        if (!coursePattern.isEmpty()) {
+            sql += " AND course_id IN (SELECT course_id FROM courses WHERE course_name LIKE ?)";
+            binds << QString("%%1%").arg(coursePattern);
+        }
+        sql += DBManager::dateRangeSql("exam_date", m_dateFrom, m_dateTo);
 
-        float score = m_proxyModel->data(scoreIndex).toFloat();
-        if (score >= 0 && score <= 100) {
-            avgScore += score;
-            maxScore = qMax(maxScore, score);
-            minScore = qMin(minScore, score);
-            validCount++;
+        QSqlQuery query;
+        query.prepare(sql);
+        for (const QVariant& value : binds) {
+            query.addBindValue(value);
+        }
+
+        if (query.exec() && query.next()) {
+            stats.count = query.value(0).toLongLong();
+            stats.total = query.value(1).toDouble();
+            stats.totalSq = query.value(2).toDouble();
+            stats.minScore = query.value(3).toDouble();
+            stats.maxScore = query.value(4).toDouble();
+        } else {
+            qWarning() << "读取成绩汇总失败：" << query.lastError().text();
         }
     }
 
-    if (validCount > 0) {
-        avgScore /= validCount;
+    if (stats.count > 0) {
+        double avgScore = stats.total / stats.count;
+        // 总体标准差：sqrt(E[x²] - E[x]²)，浮点误差可能略小于0
+        double stdScore = std::sqrt(qMax(0.0, stats.totalSq / stats.count - avgScore * avgScore));
         ui->labAvg->setText(QString("平均分：%1").arg(avgScore, 0, 'f', 1));
-        ui->labMax->setText(QString("最高分：%1").arg(maxScore));
-        ui->labMin->setText(QString("最低分：%1").arg(minScore));
+        ui->labMax->setText(QString("最高分：%1").arg(stats.maxScore));
+        ui->labMin->setText(QString("最低分：%1").arg(stats.minScore));
+        ui->labStd->setText(QString("标准差：%1").arg(stdScore, 0, 'f', 2));
     } else {
         ui->labAvg->setText("平均分：--");
         ui->labMax->setText("最高分：--");
         ui->labMin->setText("最低分：--");
+        ui->labStd->setText("标准差：--");
     }
 }
 
@@ -234,6 +363,22 @@ bool ScoreStatWidget::exportToExcel(const QString &filePath)
         return false;
     }
 
+    // 先按当前筛选/排序从库中读出结果集，查询失败时不启动 Excel
+    QString error;
+    ResultSet rows = fetchFilteredRows(&error);
+    if (!error.isEmpty()) {
+        QMessageBox::critical(this, "错误", "读取导出数据失败：" + error);
+        return false;
+    }
+    // 名称列按表格相同的排序规则（拼音序）排列，其它列已由 SQL 排好
+    std::vector<qsizetype> order;
+    int sortColumn = m_proxyModel->sortColumn();
+    auto exportColumn = std::find(kExportColumns.begin(), kExportColumns.end(), sortColumn);
+    if (m_proxyModel->isCollatedColumn(sortColumn) && exportColumn != kExportColumns.end()) {
+        order = rows.collatedOrder(int(exportColumn - kExportColumns.begin()), m_proxyModel->collator(),
+                                   m_proxyModel->sortOrder());
+    }
+
 #ifdef Q_OS_WIN
     system("taskkill /f /im EXCEL.EXE >nul 2>&1");
 #endif
@@ -274,12 +419,12 @@ bool ScoreStatWidget::exportToExcel(const QString &filePath)
 
     try {
         // ========== 1. 写入表头（用Cells定位，彻底避免Range拼接错误） ==========
-        QStringList headerList = {"学生姓名", "课程名称", "成绩", "考试日期"};
-        for (int col = 0; col < headerList.size(); col++) {
+        // 表头取表格模型中对应列的标题，与 fetchFilteredRows 的列序一致
+        for (int col = 0; col < int(kExportColumns.size()); col++) {
             QAxObject *cell = workSheet->querySubObject("Cells(int, int)", 1, col + 1);
             if (!cell) continue;
 
-            cell->dynamicCall("SetValue(const QVariant&)", headerList[col]);
+            cell->dynamicCall("SetValue(const QVariant&)", m_relModel->headerData(kExportColumns[col], Qt::Horizontal));
             cell->querySubObject("Font")->setProperty("Bold", true);
             cell->querySubObject("Interior")->setProperty("Color", QColor(200, 200, 200).rgb());
             cell->querySubObject("Borders")->setProperty("LineStyle", 1);
@@ -288,71 +433,39 @@ bool ScoreStatWidget::exportToExcel(const QString &filePath)
             delete cell;
         }
 
-        // ========== 2. 写入数据（同样用Cells定位）==========
-        int rowCount = m_proxyModel->rowCount();
-
-        // 关键修复：使用代理模型，而不是原始模型
-        // 获取代理模型中的列索引（这些是显示给用户看到的列）
-        int proxyModelColumnCount = m_proxyModel->columnCount();
-        int studentNameCol = -1;
-        int courseNameCol = -1;
-        int scoreCol = -1;
-        int examDateCol = -1;
-
-        // 根据表头文字找到对应的列索引
-        for (int col = 0; col < proxyModelColumnCount; col++) {
-            QString header = m_proxyModel->headerData(col, Qt::Horizontal).toString();
-            if (header == "学生姓名") {
-                studentNameCol = col;
-            } else if (header == "课程名称") {
-                courseNameCol = col;
-            } else if (header == "成绩") {
-                scoreCol = col;
-            } else if (header == "考试日期") {
-                examDateCol = col;
+        // ========== 2. 写入数据：结果集分块整区写入 ==========
+        MemoryCharge resultCharge("export", "Excel 结果集", rows.memoryUsage(), rows.rowCount());
+        MemoryCharge blockCharge("export", "Excel 写入块");
+        const int columnCount = rows.columnCount();
+        const qsizetype chunkRows = 2000; // 每次 Range 写入的行数，限制临时 QVariant 的峰值内存
+        for (qsizetype first = 0; first < rows.rowCount(); first += chunkRows) {
+            qsizetype last = qMin(first + chunkRows, rows.rowCount());
+            QVariantList block;
+            block.reserve(last - first);
+            for (qsizetype i = first; i < last; i++) {
+                qsizetype row = order.empty() ? i : order[size_t(i)];
+                QVariantList cells;
+                cells.reserve(columnCount);
+                for (int col = 0; col < columnCount; col++) {
+                    if (rows.columnType(col) == ResultSet::Real && !rows.isNull(row, col)) {
+                        cells << rows.real(row, col);
+                    } else {
+                        cells << rows.displayText(row, col);
+                    }
+                }
+                block << QVariant(cells);
             }
-        }
-
-        // 验证所有必需的列都已找到
-        if (studentNameCol == -1 || courseNameCol == -1 || scoreCol == -1 || examDateCol == -1) {
-            QMessageBox::critical(this, "错误", "无法确定数据列的位置！");
-            workBook->dynamicCall("Close(false)");
-            excel->dynamicCall("Quit()");
-            delete workSheet;
-            delete workBook;
-            delete workBooks;
-            delete excel;
-            return false;
-        }
-
-        for (int row = 0; row < rowCount; row++) {
-            // 学生姓名（第1列）
-            QAxObject *cellA = workSheet->querySubObject("Cells(int, int)", row + 2, 1);
-            cellA->dynamicCall("SetValue(const QVariant&)", m_proxyModel->data(m_proxyModel->index(row, studentNameCol), Qt::DisplayRole));
-            cellA->querySubObject("Borders")->setProperty("LineStyle", 1);
-            cellA->setProperty("HorizontalAlignment", -4108);
-            delete cellA;
-
-            // 课程名称（第2列）
-            QAxObject *cellB = workSheet->querySubObject("Cells(int, int)", row + 2, 2);
-            cellB->dynamicCall("SetValue(const QVariant&)", m_proxyModel->data(m_proxyModel->index(row, courseNameCol), Qt::DisplayRole));
-            cellB->querySubObject("Borders")->setProperty("LineStyle", 1);
-            cellB->setProperty("HorizontalAlignment", -4108);
-            delete cellB;
-
-            // 成绩（第3列）
-            QAxObject *cellC = workSheet->querySubObject("Cells(int, int)", row + 2, 3);
-            cellC->dynamicCall("SetValue(const QVariant&)", m_proxyModel->data(m_proxyModel->index(row, scoreCol), Qt::DisplayRole));
-            cellC->querySubObject("Borders")->setProperty("LineStyle", 1);
-            cellC->setProperty("HorizontalAlignment", -4108);
-            delete cellC;
-
-            // 考试日期（第4列）
-            QAxObject *cellD = workSheet->querySubObject("Cells(int, int)", row + 2, 4);
-            cellD->dynamicCall("SetValue(const QVariant&)", m_proxyModel->data(m_proxyModel->index(row, examDateCol), Qt::DisplayRole));
-            cellD->querySubObject("Borders")->setProperty("LineStyle", 1);
-            cellD->setProperty("HorizontalAlignment", -4108);
-            delete cellD;
+            // 每个单元格一个 QVariant，文本另算
+            blockCharge.update(qint64(block.size()) * columnCount * qint64(sizeof(QVariant) + 16), block.size());
+            QAxObject *range = workSheet->querySubObject("Range(const QString&)",
+                                                         QString("A%1:%2%3").arg(first + 2)
+                                                             .arg(QChar('A' + int(kExportColumns.size()) - 1))
+                                                             .arg(last + 1));
+            if (!range) continue;
+            range->setProperty("Value", QVariant(block));
+            range->querySubObject("Borders")->setProperty("LineStyle", 1);
+            range->setProperty("HorizontalAlignment", -4108);
+            delete range;
         }
 
         // ========== 3. 设置列宽 ==========
@@ -398,6 +511,174 @@ bool ScoreStatWidget::exportToExcel(const QString &filePath)
         return false;
     }
 }
+// 导出用结果集：与表格相同的筛选条件和排序，文本列存入竞技场，不经过模型逐格取值
+ResultSet ScoreStatWidget::fetchFilteredRows(QString *errorMessage) const
+{
+    using Schema::Scores;
+    using Schema::Students;
+    using Schema::Courses;
+    // 导出列与 kExportColumns 一一对应：外键列换成名称
+    auto exportExpr = [](Scores::Column column) {
+        switch (column) {
+        case Scores::StudentId: return Schema::qualified<Students>("st", Students::StudentName);
+        case Scores::CourseId: return Schema::qualified<Courses>("c", Courses::CourseName);
+        default: return Schema::qualified<Scores>("scores_all", column);
+        }
+    };
+    QStringList selectList;
+    QList<ResultSet::ColumnType> types;
+    for (Scores::Column column : kExportColumns) {
+        selectList << exportExpr(column);
+        types << (column == Scores::Score ? ResultSet::Real
+                  : column == Scores::ExamDate ? ResultSet::Date : ResultSet::Text);
+    }
+    QString sql = QString("SELECT %1 FROM scores_all "
+                          "LEFT JOIN %2 st ON st.%3 = scores_all.%4 "
+                          "LEFT JOIN %5 c ON c.%6 = scores_all.%7")
+                      .arg(selectList.join(", "),
+                           Schema::tableName<Students>(), Schema::columnName<Students>(Students::StudentId),
+                           Schema::columnName<Scores>(Scores::StudentId),
+                           Schema::tableName<Courses>(), Schema::columnName<Courses>(Courses::CourseId),
+                           Schema::columnName<Scores>(Scores::CourseId));
+    if (!m_relModel->filter().isEmpty()) {
+        sql += " WHERE " + m_relModel->filter();
+    }
+
+    // 表格按列头排序时保持相同顺序（代理模型列下标即 scores 列序）；
+    // 名称列的 ORDER BY 只能按二进制排序，与表格的拼音序不一致，交给调用方排列
+    int sortColumn = m_proxyModel->sortColumn();
+    QString orderBy;
+    if (sortColumn > Scores::ScoreId && sortColumn < Scores::ColumnCount && !m_proxyModel->isCollatedColumn(sortColumn)) {
+        orderBy = exportExpr(static_cast<Scores::Column>(sortColumn));
+    }
+    if (sortColumn >= 0 && !orderBy.isEmpty()) {
+        sql += QString(" ORDER BY %1 %2").arg(orderBy, m_proxyModel->sortOrder() == Qt::AscendingOrder ? "ASC" : "DESC");
+    }
+
+    QSqlQuery query(DBManager::getInstance().m_db);
+    query.setForwardOnly(true);
+    if (!query.exec(sql)) {
+        qCritical() << "导出查询失败：" << query.lastError().text();
+        if (errorMessage) *errorMessage = query.lastError().text();
+        return ResultSet();
+    }
+    ResultSet rows = ResultSet::fromQuery(query, types);
+    if (query.lastError().isValid()) {
+        qCritical() << "导出读取失败：" << query.lastError().text();
+        if (errorMessage) *errorMessage = query.lastError().text();
+        return ResultSet();
+    }
+    return rows;
+}
+
+// 数据导出：在后台线程流式导出当前班级/课程/日期筛选下的全部成绩
+void ScoreStatWidget::on_btnExportData_clicked()
+{
+    QString selectedFilter;
+    QString filePath = QFileDialog::getSaveFileName(
+        this, "导出成绩数据",
+        QDir::homePath() + "/" + QString("scores_%1.csv").arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")),
+        "CSV文件 (*.csv);;压缩列式文件 (*.scol)", &selectedFilter);
+    if (filePath.isEmpty()) return;
+
+    ScoreExportOptions options;
+    options.format = (selectedFilter.contains("scol") || filePath.endsWith(".scol", Qt::CaseInsensitive))
+                         ? ScoreExportOptions::Columnar : ScoreExportOptions::Csv;
+    if (options.format == ScoreExportOptions::Columnar && !filePath.endsWith(".scol", Qt::CaseInsensitive)) {
+        filePath.replace(QRegularExpression("\\.csv$", QRegularExpression::CaseInsensitiveOption), "");
+        filePath += ".scol";
+    }
+    options.filePath = filePath;
+    QString targetClass = ui->cbxClass->currentText().trimmed();
+    QString targetCourse = ui->cbxCourse->currentText().trimmed();
+    options.classPattern = targetClass == "全部" ? QString() : targetClass;
+    options.coursePattern = targetCourse == "全部" ? QString() : targetCourse;
+    options.from = m_dateFrom;
+    options.to = m_dateTo;
+
+    auto result = std::make_shared<qint64>(0);
+    auto error = std::make_shared<QString>();
+    ui->btnExportData->setEnabled(false);
+    runWithProgress(this, "导出数据", "正在导出... 已写入 %1 行",
+                    [options, result, error](TaskProgress& progress) {
+                        *result = ScoreExporter::exportScores(options, error.get(), [&progress](qint64 written) {
+                            return progress.update(written);
+                        });
+                    },
+                    [this, result, error, filePath]() {
+                        ui->btnExportData->setEnabled(true);
+                        if (*result < 0) {
+                            QMessageBox::warning(this, "导出数据", "导出失败：" + *error);
+                        } else {
+                            QMessageBox::information(this, "导出数据", QString("已导出 %1 行到：\n%2").arg(*result).arg(filePath));
+                        }
+                    });
+}
+
+// 批量生成成绩单：当前班级（"全部"为全校）与日期范围，不受课程筛选限制
+void ScoreStatWidget::on_btnTranscripts_clicked()
+{
+    QString dir = QFileDialog::getExistingDirectory(this, "选择成绩单保存目录", QDir::homePath());
+    if (dir.isEmpty()) return;
+
+    TranscriptOptions options;
+    options.outputDir = dir;
+    QString targetClass = ui->cbxClass->currentText().trimmed();
+    options.className = targetClass == "全部" ? QString() : targetClass;
+    options.from = m_dateFrom;
+    options.to = m_dateTo;
+
+    auto result = std::make_shared<int>(0);
+    auto error = std::make_shared<QString>();
+    ui->btnTranscripts->setEnabled(false);
+    runWithProgress(this, "生成成绩单", "正在生成成绩单... 已完成 %1 份",
+                    [options, result, error](TaskProgress& progress) {
+                        *result = TranscriptGenerator::generate(options, error.get(), [&progress](int written, int /*submitted*/) {
+                            return progress.update(written);
+                        });
+                    },
+                    [this, result, error, dir]() {
+                        ui->btnTranscripts->setEnabled(true);
+                        if (*result < 0) {
+                            QMessageBox::warning(this, "生成成绩单", "生成失败：" + *error);
+                        } else {
+                            QMessageBox::information(this, "生成成绩单", QString("已生成 %1 份成绩单到：\n%2").arg(*result).arg(dir));
+                        }
+                    });
+}
+
+// 全校总览：使用当前日期范围，不受班级/课程筛选限制
+void ScoreStatWidget::on_btnOverview_clicked()
+{
+    SchoolOverviewDialog *dialog = new SchoolOverviewDialog(m_dateFrom, m_dateTo, this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->show();
+}
+
+// GPA与排名：按学期计算，不受日期范围/课程筛选限制
+void ScoreStatWidget::on_btnGpa_clicked()
+{
+    QString targetClass = ui->cbxClass->currentText().trimmed();
+    GpaDialog *dialog = new GpaDialog(targetClass == "全部" ? QString() : targetClass, this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->show();
+}
+
+// 异常检测：当前班级（"全部"为全校）与日期范围，不受课程筛选限制
+void ScoreStatWidget::on_btnAnomalies_clicked()
+{
+    AnomalyOptions options;
+    QString targetClass = ui->cbxClass->currentText().trimmed();
+    options.className = targetClass == "全部" ? QString() : targetClass;
+    options.from = m_dateFrom;
+    options.to = m_dateTo;
+
+    AnomalyDialog *dialog = new AnomalyDialog(this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->show();
+    dialog->scan(options);
+}
+
 // 槽函数：班级下拉框变化
 void ScoreStatWidget::on_cbxClass_currentTextChanged(const QString &/*arg1*/)
 {
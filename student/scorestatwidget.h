@@ -3,7 +3,9 @@
 
 #include <QWidget>
 #include <QSqlRelationalTableModel>
-#include <QSortFilterProxyModel>
+#include "collationsortproxy.h"
+#include <QDate>
+#include "resultset.h"
 
 namespace Ui {
 class ScoreStatWidget;
@@ -17,6 +19,12 @@ public:
     explicit ScoreStatWidget(QWidget *parent = nullptr);
     ~ScoreStatWidget() override;
 
+public slots:
+    // 共用日期范围筛选（空日期表示不限）
+    void setDateRange(const QDate& from, const QDate& to);
+    // 数据被外部修改（如时间点恢复）后重新查询
+    void reload();
+
 private slots:
     // 班级下拉框变化
     void on_cbxClass_currentTextChanged(const QString &arg1);
@@ -24,12 +32,25 @@ private slots:
     void on_cbxCourse_currentTextChanged(const QString &arg1);
     // 新增：生成Excel报表
     void on_btnExportExcel_clicked();
+    // 导出筛选结果为 CSV / 压缩列式文件（流式，不经过 Excel）
+    void on_btnExportData_clicked();
+    // 按当前班级/日期范围批量生成每个学生的 PDF 成绩单
+    void on_btnTranscripts_clicked();
+    // 全校 班级×科目 总览（并行统计）
+    void on_btnOverview_clicked();
+    // 学期 GPA 与班级/全校排名（当前班级，"全部"为全校）
+    void on_btnGpa_clicked();
+    // 当前班级/日期范围内的成绩突变与可疑批次
+    void on_btnAnomalies_clicked();
+    // 启动快照重建完成后刷新下拉框
+    void refreshFilterOptions();
 
 private:
     // 初始化Model/View架构
     void initModel();
     // 加载筛选下拉框数据
     void loadFilterOptions();
+    void fillFilterOptions(const QStringList& classes, const QStringList& courses);
     // 执行数据筛选
     void filterData();
     // 统计成绩（平均分/最高分/最低分）
@@ -40,12 +61,18 @@ private:
     void loadCourseList();
     // 新增：生成Excel报表
     bool exportToExcel(const QString &filePath);
+    // 登记内存记账探针（模型行缓存、排序键缓存）与超预算回收
+    void registerMemoryProbes();
 
     Ui::ScoreStatWidget *ui;
     QSqlRelationalTableModel *m_relModel; // 关联模型
-    QSortFilterProxyModel *m_proxyModel;  // 代理模型（筛选用）
+    CollationSortProxy *m_proxyModel;     // 代理模型（筛选/按拼音排序）
+    QDate m_dateFrom;                     // 日期范围（空为不限）
+    QDate m_dateTo;
     QStringList getTableHeaders() const;
-    QVector<QStringList> getFilteredData() const;
+    // 当前筛选/排序下的全部行（学生姓名、课程名称、成绩、考试日期）；
+    // 按名称列排序时 SQL 不排序，由调用方用 CollationSortProxy 的排序规则排列
+    ResultSet fetchFilteredRows(QString *errorMessage = nullptr) const;
 };
 
 #endif // SCORESTATWIDGET_H
@@ -0,0 +1,194 @@
+#include "scorewriter.h"
+#include "dbmanager.h"
+#include "schema.h"
+#include "memoryaccounting.h"
+#include <QThread>
+
+ScoreWriter::ScoreWriter()
+    : m_maxDelayMs(DBManager::getInstance().config().writerDelayMs)
+    , m_maxBatch(DBManager::getInstance().config().writerBatch)
+{
+    // 未配置时按后端取批量大小
+    if (m_maxBatch <= 0) m_maxBatch = DBManager::getInstance().dialect().batchSize();
+    m_clock.start();
+    // 排队中的写请求（学号字符串按短串估算）
+    MemoryAccounting::getInstance().registerProbe("writer", "待写入请求", this, [this]() {
+        qint64 pending = pendingCount();
+        return MemorySample{pending, pending * qint64(sizeof(Pending) + 32)};
+    });
+}
+
+ScoreWriter::~ScoreWriter()
+{
+    shutdown();
+}
+
+void ScoreWriter::ensureStarted()
+{
+    // 调用方持有 m_mutex
+    if (m_thread || m_stopping) return;
+    m_thread = QThread::create([this]() { writerLoop(); });
+    m_thread->setObjectName("ScoreWriter");
+    m_thread->start();
+}
+
+quint64 ScoreWriter::submit(const ScoreWrite& write)
+{
+    return submitBatch({write}).value(0);
+}
+
+QList<quint64> ScoreWriter::submitBatch(const QList<ScoreWrite>& writes)
+{
+    QList<quint64> tickets;
+    int pending = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_stopping) return tickets;
+        ensureStarted();
+        qint64 now = m_clock.elapsed();
+        for (const ScoreWrite& write : writes) {
+            tickets.append(m_nextTicket);
+            m_queue.enqueue({m_nextTicket++, now, write});
+        }
+        pending = m_queue.size();
+        m_wakeup.wakeAll();
+    }
+    emit pendingChanged(pending);
+    return tickets;
+}
+
+void ScoreWriter::setCommitBounds(int maxDelayMs, int maxBatch)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maxDelayMs = qMax(0, maxDelayMs);
+    m_maxBatch = qMax(1, maxBatch);
+    m_wakeup.wakeAll();
+}
+
+int ScoreWriter::pendingCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_queue.size();
+}
+
+void ScoreWriter::shutdown()
+{
+    QThread *thread = nullptr;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopping = true;
+        m_wakeup.wakeAll();
+        thread = m_thread;
+        m_thread = nullptr;
+    }
+    if (thread) {
+        thread->wait();
+        delete thread;
+    }
+}
+
+// ========== 写线程 ==========
+void ScoreWriter::writerLoop()
+{
+    forever {
+        QList<Pending> group;
+        int remaining = 0;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_queue.isEmpty() && !m_stopping) {
+                m_wakeup.wait(&m_mutex);
+            }
+            if (m_queue.isEmpty()) break; // 停止且已写完
+
+            // 分组窗口：从队首请求入队起最多等待 maxDelayMs，攒满 maxBatch 条立即提交
+            while (!m_stopping && m_queue.size() < m_maxBatch) {
+                qint64 waitMs = m_queue.head().enqueuedAt + m_maxDelayMs - m_clock.elapsed();
+                if (waitMs <= 0) break;
+                m_wakeup.wait(&m_mutex, QDeadlineTimer(waitMs));
+            }
+            while (!m_queue.isEmpty() && group.size() < m_maxBatch) {
+                group.append(m_queue.dequeue());
+            }
+            remaining = m_queue.size();
+        }
+        emit pendingChanged(remaining);
+
+        QElapsedTimer timer;
+        timer.start();
+        const QList<ScoreWriteResult> results = writeGroup(group);
+        emit batchCommitted(group.size(), timer.elapsed());
+        for (const ScoreWriteResult& result : results) {
+            emit writeFinished(result);
+        }
+    }
+}
+
+QList<ScoreWriteResult> ScoreWriter::writeGroup(const QList<Pending>& group)
+{
+    using Schema::Scores;
+    DBManager& manager = DBManager::getInstance();
+    QSqlDatabase db = manager.threadConnection();
+    bool savepoints = manager.dialect().errorAbortsTransaction();
+
+    QList<ScoreWriteResult> results;
+    results.reserve(group.size());
+    auto failAll = [&](const QString& error) {
+        results.clear();
+        for (const Pending& pending : group) results.append({pending.ticket, false, error, -1});
+        return results;
+    };
+    if (!db.transaction()) {
+        return failAll("开启事务失败：" + db.lastError().text());
+    }
+
+    QSqlQuery checkQuery(db);
+    checkQuery.prepare(QString("SELECT 1 FROM %1 WHERE %2 = ? AND %3 = ? AND %4 = ?")
+                           .arg(Schema::tableName<Scores>(), Schema::columnName<Scores>(Scores::StudentId),
+                                Schema::columnName<Scores>(Scores::CourseId), Schema::columnName<Scores>(Scores::ExamDate)));
+    QSqlQuery insertQuery(db);
+    // 绑定顺序与列清单一致
+    insertQuery.prepare(Schema::Select<Scores, Scores::StudentId, Scores::CourseId, Scores::Score, Scores::ExamDate>::insertSql());
+    QSqlQuery savepoint(db);
+
+    for (const Pending& pending : group) {
+        const ScoreWrite& write = pending.write;
+        ScoreWriteResult result{pending.ticket, false, QString(), -1};
+
+        // 重复校验与插入在同一事务内，同组内先写入的记录也能被检查到
+        if (write.rejectDuplicate) {
+            checkQuery.addBindValue(write.studentId);
+            checkQuery.addBindValue(write.courseId);
+            DBManager::bindDate(checkQuery, write.examDate);
+            if (checkQuery.exec() && checkQuery.next()) {
+                checkQuery.finish();
+                result.error = "该学生该科目该日期的成绩已存在";
+                results.append(result);
+                continue;
+            }
+            checkQuery.finish();
+        }
+
+        // PostgreSQL 中单条语句失败会使整个事务失效，用保存点只回退这一条
+        if (savepoints) savepoint.exec("SAVEPOINT score_write");
+        insertQuery.addBindValue(write.studentId);
+        insertQuery.addBindValue(write.courseId);
+        DBManager::bindScore(insertQuery, write.score);
+        DBManager::bindDate(insertQuery, write.examDate);
+        if (insertQuery.exec()) {
+            result.ok = true;
+            result.scoreId = insertQuery.lastInsertId().toLongLong();
+            if (savepoints) savepoint.exec("RELEASE SAVEPOINT score_write");
+        } else {
+            result.error = insertQuery.lastError().text();
+            if (savepoints) savepoint.exec("ROLLBACK TO SAVEPOINT score_write");
+        }
+        results.append(result);
+    }
+
+    if (!db.commit()) {
+        QString error = "提交失败：" + db.lastError().text();
+        db.rollback();
+        return failAll(error);
+    }
+    return results;
+}
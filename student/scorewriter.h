@@ -0,0 +1,87 @@
+#ifndef SCOREWRITER_H
+#define SCOREWRITER_H
+
+#include <QObject>
+#include <QDate>
+#include <QQueue>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+
+class QThread;
+
+// 一条成绩写入请求
+struct ScoreWrite {
+    QString studentId;
+    int courseId = -1;
+    double score = 0;
+    QDate examDate;
+    bool rejectDuplicate = true; // 同一学生+科目+日期已有成绩时拒绝
+};
+
+// 写入结果（通过 ScoreWriter::writeFinished 异步返回）
+struct ScoreWriteResult {
+    quint64 ticket = 0;
+    bool ok = false;
+    QString error;
+    qint64 scoreId = -1;
+};
+
+// 成绩写入线程：所有界面的写请求进入同一队列，由唯一的写线程用独立连接分组提交。
+// 队首请求等待不超过 maxDelayMs、或攒满 maxBatch 条即开一个事务写入并提交，
+// 多个录入员/导入同时写时不再争抢写锁，提交（fsync）开销由一组请求分摊。
+class ScoreWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    static ScoreWriter& getInstance() {
+        static ScoreWriter instance;
+        return instance;
+    }
+
+    // 线程安全；返回请求号，结果由 writeFinished 带回
+    quint64 submit(const ScoreWrite& write);
+    QList<quint64> submitBatch(const QList<ScoreWrite>& writes);
+
+    // 分组提交的延迟/批量上限（缺省取数据库配置）
+    void setCommitBounds(int maxDelayMs, int maxBatch);
+    int pendingCount() const;
+
+    // 写完队列中剩余请求后停止写线程（程序退出前调用）
+    void shutdown();
+
+signals:
+    void writeFinished(const ScoreWriteResult& result);
+    // 一组提交完成：行数、事务耗时
+    void batchCommitted(int rows, qint64 elapsedMs);
+    void pendingChanged(int pending);
+
+private:
+    ScoreWriter();
+    ~ScoreWriter() override;
+    ScoreWriter(const ScoreWriter&) = delete;
+    ScoreWriter& operator=(const ScoreWriter&) = delete;
+
+    struct Pending {
+        quint64 ticket;
+        qint64 enqueuedAt; // m_clock 毫秒
+        ScoreWrite write;
+    };
+
+    void ensureStarted();
+    void writerLoop();
+    QList<ScoreWriteResult> writeGroup(const QList<Pending>& group);
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_wakeup;
+    QQueue<Pending> m_queue;
+    QElapsedTimer m_clock;
+    quint64 m_nextTicket = 1;
+    int m_maxDelayMs;
+    int m_maxBatch;
+    bool m_stopping = false;
+    QThread *m_thread = nullptr;
+};
+
+#endif // SCOREWRITER_H
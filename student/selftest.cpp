@@ -0,0 +1,184 @@
+#include "selftest.h"
+#include "dbmanager.h"
+#include "sqldialect.h"
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QSettings>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QVersionNumber>
+
+namespace {
+
+struct Checker {
+    QStringList lines;
+    int failed = 0;
+
+    void check(bool ok, const QString& what)
+    {
+        lines << (ok ? "PASS " : "FAIL ") + what;
+        if (!ok) failed++;
+    }
+};
+
+// 写一份只有 [database] 节的配置文件并按正式流程读取
+DatabaseConfig loadConfig(const QString& iniPath, const QString& driver, const QString& database, int poolSize)
+{
+    {
+        QSettings settings(iniPath, QSettings::IniFormat);
+        settings.clear();
+        settings.beginGroup("database");
+        settings.setValue("driver", driver);
+        settings.setValue("database", database);
+        settings.setValue("pool_size", poolSize);
+        settings.setValue("writer_batch", 0);
+        settings.endGroup();
+    }
+    return DatabaseConfig::load(iniPath);
+}
+
+// ========== 各后端生成的语句与策略 ==========
+void checkDialects(Checker& c, const QString& iniPath)
+{
+    const int cores = qMax(1, QThread::idealThreadCount());
+    struct Case {
+        const char *driver;
+        SqlDialect::Backend backend;
+        QVersionNumber tooOld;   // 不支持窗口函数的最后一个版本
+        QVersionNumber minimum;  // 支持窗口函数的最低版本
+        int batchSize;
+    };
+    const Case cases[] = {
+        {"qsqlite", SqlDialect::SQLite, QVersionNumber(3, 24), QVersionNumber(3, 25), 2000},
+        {"qpsql", SqlDialect::PostgreSQL, QVersionNumber(8, 3), QVersionNumber(8, 4), 500},
+        {"qmysql", SqlDialect::MySQL, QVersionNumber(5, 7), QVersionNumber(8, 0), 500},
+    };
+    for (const Case& item : cases) {
+        // 连接池大于核数两倍，核对服务器端的上限
+        DatabaseConfig config = loadConfig(iniPath, item.driver, "selftest", cores * 4);
+        SqlDialect dialect = SqlDialect::forDriver(config.driver, item.minimum);
+        const QString name = dialect.name();
+
+        c.check(SqlDialect::isSupportedDriver(config.driver) && dialect.backend() == item.backend
+                    && config.isSQLite() == (item.backend == SqlDialect::SQLite),
+                name + "：配置驱动 " + config.driver);
+        c.check(dialect.limitClause(20) == " LIMIT 20" && dialect.limitClause(20, 40) == " LIMIT 20 OFFSET 40",
+                name + "：分页子句");
+        c.check(dialect.supportsWindowFunctions()
+                    && !SqlDialect::forDriver(config.driver, item.tooOld).supportsWindowFunctions()
+                    && SqlDialect::forDriver(config.driver).supportsWindowFunctions(),
+                name + QString("：窗口函数自 %1 起启用，版本未知时启用").arg(item.minimum.toString()));
+        c.check(dialect.batchSize() == item.batchSize, name + QString("：批量大小 %1").arg(item.batchSize));
+        if (item.backend == SqlDialect::SQLite) {
+            c.check(dialect.readerConnections(config.poolSize) == cores && dialect.readerConnections(1) == cores,
+                    name + QString("：读连接数按核数（%1）").arg(cores));
+        } else {
+            c.check(dialect.readerConnections(config.poolSize) == cores * 2 && dialect.readerConnections(0) == 1
+                        && dialect.readerConnections(2) == qMin(2, cores * 2),
+                    name + QString("：读连接数按连接池，限制在 1~%1").arg(cores * 2));
+        }
+        c.check(dialect.errorAbortsTransaction() == (item.backend == SqlDialect::PostgreSQL), name + "：保存点隔离单行错误");
+
+        QString ignore = dialect.insertIgnoreSql("kv", {"k", "v"});
+        QString upsert = dialect.upsertSql("kv", {"k", "v"}, {"k"}, {"v"});
+        switch (item.backend) {
+        case SqlDialect::PostgreSQL:
+            c.check(ignore == "INSERT INTO kv (k, v) VALUES (?, ?) ON CONFLICT DO NOTHING"
+                        && upsert == "INSERT INTO kv (k, v) VALUES (?, ?) ON CONFLICT (k) DO UPDATE SET v = excluded.v",
+                    name + "：冲突处理语句");
+            break;
+        case SqlDialect::MySQL:
+            c.check(ignore == "INSERT IGNORE INTO kv (k, v) VALUES (?, ?)"
+                        && upsert == "INSERT INTO kv (k, v) VALUES (?, ?) ON DUPLICATE KEY UPDATE v = VALUES(v)",
+                    name + "：冲突处理语句");
+            break;
+        default:
+            c.check(ignore == "INSERT OR IGNORE INTO kv (k, v) VALUES (?, ?)"
+                        && upsert == "INSERT INTO kv (k, v) VALUES (?, ?) ON CONFLICT (k) DO UPDATE SET v = excluded.v",
+                    name + "：冲突处理语句");
+            break;
+        }
+    }
+}
+
+// ========== SQLite 替身库上实际执行 ==========
+void checkStandIn(Checker& c, const QString& iniPath, const QString& dbPath)
+{
+    DatabaseConfig config = loadConfig(iniPath, "qsqlite", dbPath, 3);
+    if (!QSqlDatabase::isDriverAvailable(config.driver)) {
+        c.check(false, "替身库：未安装驱动 " + config.driver);
+        return;
+    }
+    QSqlDatabase db = QSqlDatabase::addDatabase(config.driver, "selftest");
+    db.setDatabaseName(config.database);
+    if (!db.open()) {
+        c.check(false, "替身库：打开失败 " + db.lastError().text());
+        return;
+    }
+
+    QSqlQuery query(db);
+    QVersionNumber version = query.exec("SELECT sqlite_version()") && query.next()
+                                 ? QVersionNumber::fromString(query.value(0).toString())
+                                 : QVersionNumber();
+    SqlDialect dialect = SqlDialect::forDriver(config.driver, version);
+    c.check(dialect.isSQLite() && !version.isNull(), "替身库：SQLite " + version.toString());
+    // 成绩写线程的取值：writer_batch 为 0 时按后端
+    c.check((config.writerBatch > 0 ? config.writerBatch : dialect.batchSize()) == 2000, "替身库：写线程批量大小");
+
+    auto exec = [&](const QString& sql, const QVariantList& values) {
+        if (!query.prepare(sql)) return false;
+        for (const QVariant& value : values) query.addBindValue(value);
+        return query.exec();
+    };
+    auto valueOf = [&](int key) {
+        return exec("SELECT v FROM kv WHERE k = ?", {key}) && query.next() ? query.value(0).toString() : QString();
+    };
+
+    c.check(query.exec("CREATE TABLE kv (k INTEGER PRIMARY KEY, v TEXT NOT NULL)"), "替身库：建表");
+    const QString ignore = dialect.insertIgnoreSql("kv", {"k", "v"});
+    c.check(exec(ignore, {1, "a"}) && exec(ignore, {1, "b"}) && valueOf(1) == "a", "替身库：冲突时忽略");
+    c.check(exec(dialect.upsertSql("kv", {"k", "v"}, {"k"}, {"v"}), {1, "b"}) && valueOf(1) == "b",
+            "替身库：冲突时更新");
+    c.check(exec(dialect.insertIgnoreSql("kv", {"k", "v"}, "SELECT k + 1, 'c' FROM kv WHERE k = 1"), {})
+                && valueOf(2) == "c",
+            "替身库：INSERT ... SELECT 冲突时忽略");
+
+    bool inserted = db.transaction();
+    for (int k = 3; inserted && k <= 10; k++) inserted = exec(ignore, {k, QString::number(k)});
+    inserted = inserted && db.commit();
+    QList<int> page;
+    if (inserted && query.exec("SELECT k FROM kv ORDER BY k" + dialect.limitClause(3, 3))) {
+        while (query.next()) page << query.value(0).toInt();
+    }
+    c.check(page == QList<int>{4, 5, 6}, "替身库：分页（第2页，每页3条）");
+
+    c.check(dialect.supportsWindowFunctions() == (version >= QVersionNumber(3, 25)), "替身库：窗口函数开关与库版本一致");
+    if (dialect.supportsWindowFunctions()) {
+        bool ok = query.exec("SELECT k, ROW_NUMBER() OVER (ORDER BY k DESC) FROM kv ORDER BY k" + dialect.limitClause(1))
+                  && query.next() && query.value(1).toInt() == 10;
+        c.check(ok, "替身库：窗口函数");
+    }
+    query.finish();
+    db.close();
+}
+
+} // namespace
+
+bool SelfTest::run(QString *report)
+{
+    Checker c;
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        if (report) *report = "FAIL 无法创建临时目录";
+        return false;
+    }
+    const QString iniPath = dir.filePath("studentdb.ini");
+    checkDialects(c, iniPath);
+    checkStandIn(c, iniPath, dir.filePath("selftest.db"));
+    QSqlDatabase::removeDatabase("selftest");
+
+    c.lines << QString("共 %1 项，失败 %2 项").arg(c.lines.size()).arg(c.failed);
+    if (report) *report = c.lines.join('\n');
+    return c.failed == 0;
+}
@@ -0,0 +1,17 @@
+#ifndef SELFTEST_H
+#define SELFTEST_H
+
+#include <QString>
+
+// 数据库方言自检（无界面，不访问正式库）：
+//   1. 对 SQLite/PostgreSQL/MySQL 各版本核对分页子句、窗口函数开关、批量大小与读连接数；
+//   2. 按 DatabaseConfig 打开临时 SQLite 库作为替身，实际执行 upsert/insert-or-ignore/分页/窗口函数语句。
+// 服务器后端只核对生成的语句与策略，不连接真实服务器。
+class SelfTest
+{
+public:
+    // 全部通过返回 true；report 为逐项结果（失败项以 FAIL 开头）
+    static bool run(QString *report);
+};
+
+#endif // SELFTEST_H
@@ -0,0 +1,88 @@
+#include "sqldialect.h"
+#include <QThread>
+
+SqlDialect SqlDialect::forDriver(const QString& driverName, const QVersionNumber& serverVersion)
+{
+    SqlDialect dialect;
+    if (driverName == "QPSQL") {
+        dialect.m_backend = PostgreSQL;
+    } else if (driverName == "QMYSQL" || driverName == "QMARIADB") {
+        dialect.m_backend = MySQL;
+    }
+    dialect.m_version = serverVersion;
+    return dialect;
+}
+
+bool SqlDialect::isSupportedDriver(const QString& driverName)
+{
+    return QStringList{"QSQLITE", "QPSQL", "QMYSQL", "QMARIADB"}.contains(driverName);
+}
+
+QString SqlDialect::name() const
+{
+    switch (m_backend) {
+    case PostgreSQL: return "PostgreSQL";
+    case MySQL: return "MySQL";
+    default: return "SQLite";
+    }
+}
+
+QString SqlDialect::placeholders(int count)
+{
+    QStringList marks;
+    for (int i = 0; i < count; i++) marks << "?";
+    return marks.join(", ");
+}
+
+QString SqlDialect::upsertSql(const QString& table, const QStringList& columns,
+                              const QStringList& conflictColumns, const QStringList& updateColumns) const
+{
+    QString insert = QString("INSERT INTO %1 (%2) VALUES (%3)")
+                         .arg(table, columns.join(", "), placeholders(columns.size()));
+    QStringList assignments;
+    for (const QString& column : updateColumns) {
+        assignments << (m_backend == MySQL ? QString("%1 = VALUES(%1)").arg(column)
+                                           : QString("%1 = excluded.%1").arg(column));
+    }
+    if (m_backend == MySQL) {
+        return insert + " ON DUPLICATE KEY UPDATE " + assignments.join(", ");
+    }
+    // SQLite 3.24+ 与 PostgreSQL 语法相同
+    return insert + QString(" ON CONFLICT (%1) DO UPDATE SET %2").arg(conflictColumns.join(", "), assignments.join(", "));
+}
+
+QString SqlDialect::insertIgnoreSql(const QString& table, const QStringList& columns, const QString& source) const
+{
+    QString body = QString("INTO %1 (%2) %3")
+                       .arg(table, columns.join(", "),
+                            source.isEmpty() ? QString("VALUES (%1)").arg(placeholders(columns.size())) : source);
+    switch (m_backend) {
+    case PostgreSQL: return "INSERT " + body + " ON CONFLICT DO NOTHING";
+    case MySQL: return "INSERT IGNORE " + body;
+    default: return "INSERT OR IGNORE " + body;
+    }
+}
+
+QString SqlDialect::limitClause(qint64 limit, qint64 offset) const
+{
+    // 三种后端都支持 LIMIT/OFFSET；偏移为0时省略，便于走键集分页
+    return offset > 0 ? QString(" LIMIT %1 OFFSET %2").arg(limit).arg(offset)
+                      : QString(" LIMIT %1").arg(limit);
+}
+
+bool SqlDialect::supportsWindowFunctions() const
+{
+    if (m_version.isNull()) return true; // 版本未知时按新版本处理
+    switch (m_backend) {
+    case PostgreSQL: return m_version >= QVersionNumber(8, 4);
+    case MySQL: return m_version >= QVersionNumber(8, 0);
+    default: return m_version >= QVersionNumber(3, 25);
+    }
+}
+
+int SqlDialect::readerConnections(int poolSize) const
+{
+    int cores = qMax(1, QThread::idealThreadCount());
+    if (m_backend == SQLite) return cores;
+    return qBound(1, poolSize, cores * 2);
+}
@@ -0,0 +1,52 @@
+#ifndef SQLDIALECT_H
+#define SQLDIALECT_H
+
+#include <QString>
+#include <QStringList>
+#include <QVersionNumber>
+
+// 数据库方言：屏蔽 SQLite / PostgreSQL / MySQL 在 upsert、分页、窗口函数上的差异，
+// 并给出各后端的连接与批量写入策略
+class SqlDialect
+{
+public:
+    enum Backend { SQLite, PostgreSQL, MySQL };
+
+    SqlDialect() = default;
+    // 按 Qt 驱动名（QSQLITE/QPSQL/QMYSQL）确定方言，未知驱动按 SQLite 语法处理
+    static SqlDialect forDriver(const QString& driverName, const QVersionNumber& serverVersion = QVersionNumber());
+    static bool isSupportedDriver(const QString& driverName);
+
+    Backend backend() const { return m_backend; }
+    bool isSQLite() const { return m_backend == SQLite; }
+    QString name() const;
+    QVersionNumber serverVersion() const { return m_version; }
+
+    // ========== 语法 ==========
+    // 插入，主键/唯一键冲突时更新 updateColumns
+    QString upsertSql(const QString& table, const QStringList& columns,
+                      const QStringList& conflictColumns, const QStringList& updateColumns) const;
+    // 插入，冲突时忽略；source 为 VALUES (...) 或 SELECT 子句，缺省按列数生成占位符
+    QString insertIgnoreSql(const QString& table, const QStringList& columns, const QString& source = QString()) const;
+    // 分页子句（含前导空格）
+    QString limitClause(qint64 limit, qint64 offset = 0) const;
+    // 窗口函数（ROW_NUMBER/COUNT OVER）：SQLite 3.25+、MySQL 8.0+、PostgreSQL 8.4+
+    bool supportsWindowFunctions() const;
+
+    // ========== 连接与批量策略 ==========
+    // 批量写入（成绩写线程分组提交）时每个事务包含的行数：SQLite 单写者，提交（fsync）是主要开销，
+    // 服务器端写入并发，较小的事务减少锁持有时间
+    int batchSize() const { return m_backend == SQLite ? 2000 : 500; }
+    // 并行读取使用的连接数上限：SQLite 在WAL下按核数开读连接；服务器按连接池大小
+    int readerConnections(int poolSize) const;
+    // 语句失败后事务是否整体失效（PostgreSQL），需要用保存点隔离单行错误
+    bool errorAbortsTransaction() const { return m_backend == PostgreSQL; }
+
+private:
+    static QString placeholders(int count);
+
+    Backend m_backend = SQLite;
+    QVersionNumber m_version;
+};
+
+#endif // SQLDIALECT_H
@@ -1,4 +1,4 @@
-QT += core gui sql charts sql axcontainer
+QT += core gui sql charts sql axcontainer network concurrent svg
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -10,29 +10,90 @@ CONFIG += c++17
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    anomalydialog.cpp \
+    anomalyscanner.cpp \
+    authservice.cpp \
+    backgroundtask.cpp \
+    chartexporter.cpp \
+    collationsortproxy.cpp \
+    daterangebar.cpp \
+    datasnapshot.cpp \
     dbmanager.cpp \
+    gpadialog.cpp \
+    gpaengine.cpp \
+    gpasettingsdialog.cpp \
+    loadtest.cpp \
     loginwidget.cpp \
     main.cpp \
     mainwindow.cpp \
+    memoryaccounting.cpp \
+    memorydiagnosticsdialog.cpp \
+    resultset.cpp \
+    rosterpager.cpp \
+    schooloverview.cpp \
+    schooloverviewdialog.cpp \
     scorechartwidget.cpp \
+    scoreexporter.cpp \
     scoreinputwidget.cpp \
-    scorestatwidget.cpp
+    scorepivot.cpp \
+    scorepivotmodel.cpp \
+    scorepivotwidget.cpp \
+    scorestatwidget.cpp \
+    scorewriter.cpp \
+    selftest.cpp \
+    sqldialect.cpp \
+    studentindex.cpp \
+    studentpicker.cpp \
+    transcriptgenerator.cpp
 
 HEADERS += \
+    anomalydialog.h \
+    anomalyscanner.h \
+    authservice.h \
+    backgroundtask.h \
+    chartexporter.h \
+    collationsortproxy.h \
+    daterangebar.h \
+    datasnapshot.h \
     dbmanager.h \
+    gpadialog.h \
+    gpaengine.h \
+    gpasettingsdialog.h \
+    loadtest.h \
     loginwidget.h \
     mainwindow.h \
+    memoryaccounting.h \
+    memorydiagnosticsdialog.h \
+    resultset.h \
+    rosterpager.h \
+    schema.h \
+    schooloverview.h \
+    schooloverviewdialog.h \
     scorechartwidget.h \
+    scoreexporter.h \
     scoreinputwidget.h \
-    scorestatwidget.h
+    scorepivot.h \
+    scorepivotmodel.h \
+    scorepivotwidget.h \
+    scorestatwidget.h \
+    scorewriter.h \
+    selftest.h \
+    sqldialect.h \
+    studentindex.h \
+    studentpicker.h \
+    transcriptgenerator.h
 
 FORMS += \
     ScoreChartWidget.ui \
     scoreinputwidget.ui \
+    scorepivotwidget.ui \
     ScoreStatWidget.ui \
     loginwidget.ui \
     mainwindow.ui \
 
+# 进程常驻内存（GetProcessMemoryInfo）
+win32: LIBS += -lpsapi
+
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
@@ -0,0 +1,206 @@
+#include "studentindex.h"
+#include "dbmanager.h"
+#include "schema.h"
+#include "memoryaccounting.h"
+#include <QCollator>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+#include <algorithm>
+
+static const int kMaxGram = 3;
+
+// ========== 拼音首字母 ==========
+// 中文排序规则按拼音排序，每个声母取排序最靠前的一个字作边界，
+// 二分找到不大于该字的最后一个边界即为首字母（无需内置拼音表）
+static const char16_t kInitialBoundaries[] = u"阿八嚓哒妸发旮哈讥咔垃痳拏噢妑七呥仨他穵夕丫帀";
+static const char kInitialLetters[] = "abcdefghjklmnopqrstwxyz";
+
+QString StudentIndex::pinyinInitials(const QString& name)
+{
+    // 每个线程一个排序器，批量计算时不重复创建
+    thread_local QCollator collator(QLocale(QLocale::Chinese, QLocale::China));
+    const int boundaryCount = int(sizeof(kInitialLetters)) - 1;
+
+    QString initials;
+    for (QChar ch : name) {
+        ushort code = ch.unicode();
+        if (code < 0x4E00 || code > 0x9FA5) {
+            if (ch.isLetterOrNumber()) initials += ch.toLower();
+            continue;
+        }
+        QString text(ch);
+        int lo = 0, hi = boundaryCount; // 第一个大于 ch 的边界
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (collator.compare(QString(QChar(kInitialBoundaries[mid])), text) <= 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo > 0) initials += QLatin1Char(kInitialLetters[lo - 1]);
+    }
+    return initials;
+}
+
+// ========== 索引构建 ==========
+// n-gram 编码：最多3个UTF-16字符，每个占16位，长度不同的 gram 不会冲突（字符非0）
+quint64 StudentIndex::gramKey(const QString& text, int pos, int length)
+{
+    quint64 key = 0;
+    for (int i = 0; i < length; i++) {
+        key = (key << 16) | text.at(pos + i).unicode();
+    }
+    return key;
+}
+
+StudentIndex::StudentIndex()
+{
+    MemoryAccounting::getInstance().registerProbe("index", "学生检索索引", this, [this]() {
+        return MemorySample{size(), memoryUsage()};
+    });
+}
+
+std::shared_ptr<const StudentIndex::Data> StudentIndex::build(QVector<StudentEntry> entries)
+{
+    auto data = std::make_shared<Data>();
+    data->entries = std::move(entries);
+    data->idKeys.reserve(data->entries.size());
+    data->nameKeys.reserve(data->entries.size());
+
+    for (int index = 0; index < data->entries.size(); index++) {
+        const StudentEntry& entry = data->entries.at(index);
+        data->idKeys.append(entry.studentId.toLower());
+        data->nameKeys.append(entry.name.toLower());
+
+        for (const QString& key : {data->idKeys.last(), data->nameKeys.last(), entry.initials}) {
+            for (int length = 1; length <= kMaxGram; length++) {
+                for (int pos = 0; pos + length <= key.size(); pos++) {
+                    QVector<int>& posting = data->postings[gramKey(key, pos, length)];
+                    // 条目按下标顺序加入，同一条目内重复的 gram 只记一次
+                    if (posting.isEmpty() || posting.last() != index) posting.append(index);
+                }
+            }
+        }
+    }
+    // 字符串按 UTF-16 载荷 + 头部估算，倒排表按节点 + 下标数组估算
+    auto textBytes = [](const QString& text) { return qint64(sizeof(QString)) + 16 + text.size() * 2; };
+    for (int index = 0; index < data->entries.size(); index++) {
+        const StudentEntry& entry = data->entries.at(index);
+        data->bytes += textBytes(entry.studentId) + textBytes(entry.name) + textBytes(entry.className)
+                       + textBytes(entry.initials) + textBytes(data->idKeys.at(index)) + textBytes(data->nameKeys.at(index));
+    }
+    for (QVector<int>& posting : data->postings) {
+        posting.squeeze();
+        data->bytes += qint64(sizeof(quint64) + sizeof(QVector<int>) + sizeof(void *)) + 16 + posting.size() * qint64(sizeof(int));
+    }
+    return data;
+}
+
+void StudentIndex::reload()
+{
+    if (m_loading) return;
+    m_loading = true;
+
+    using DataPtr = std::shared_ptr<const Data>;
+    auto *watcher = new QFutureWatcher<DataPtr>(this);
+    connect(watcher, &QFutureWatcher<DataPtr>::finished, this, [this, watcher]() {
+        m_loading = false;
+        DataPtr data = watcher->result();
+        watcher->deleteLater();
+        if (!data) {
+            emit reloadFailed("students表中暂无学生数据，请先添加！");
+            return;
+        }
+        // 索引整体替换，search 只在主线程调用，无需加锁
+        m_data = data;
+        emit reloaded(m_data->entries.size());
+    });
+
+    // 查询、拼音计算与倒排表构建都在工作线程完成
+    watcher->setFuture(QtConcurrent::run([]() -> DataPtr {
+        QVector<StudentEntry> entries;
+        QSqlQuery query(DBManager::getInstance().threadConnection());
+        query.setForwardOnly(true);
+        using Schema::Students;
+        using IndexSelect = Schema::Select<Students, Students::StudentId, Students::StudentName, Students::ClassName>;
+        if (!query.exec(IndexSelect::sql() + " ORDER BY " + Schema::columnName<Students>(Students::StudentId))) {
+            qCritical() << "加载学生索引失败：" << query.lastError().text();
+            return nullptr;
+        }
+        while (query.next()) {
+            StudentEntry entry;
+            entry.studentId = query.value(IndexSelect::at<Students::StudentId>()).toString();
+            entry.name = query.value(IndexSelect::at<Students::StudentName>()).toString();
+            entry.className = query.value(IndexSelect::at<Students::ClassName>()).toString();
+            entry.initials = pinyinInitials(entry.name);
+            entries.append(entry);
+        }
+        if (entries.isEmpty()) return nullptr;
+        return build(std::move(entries));
+    }));
+}
+
+// ========== 检索 ==========
+QList<StudentEntry> StudentIndex::search(const QString& text, int limit) const
+{
+    QList<StudentEntry> results;
+    QString needle = text.trimmed().toLower();
+    if (!m_data || needle.isEmpty() || limit <= 0) return results;
+    const Data& data = *m_data;
+
+    // 候选集：短输入直接取倒排表；长输入取最短的三元组倒排表，再用其余三元组过滤
+    QVector<int> candidates;
+    if (needle.size() <= kMaxGram) {
+        candidates = data.postings.value(gramKey(needle, 0, needle.size()));
+    } else {
+        QList<const QVector<int>*> lists;
+        for (int pos = 0; pos + kMaxGram <= needle.size(); pos++) {
+            auto it = data.postings.constFind(gramKey(needle, pos, kMaxGram));
+            if (it == data.postings.constEnd()) return results;
+            lists.append(&it.value());
+        }
+        std::sort(lists.begin(), lists.end(), [](const QVector<int>* a, const QVector<int>* b) {
+            return a->size() < b->size();
+        });
+        for (int index : *lists.first()) {
+            bool inAll = std::all_of(lists.begin() + 1, lists.end(), [index](const QVector<int>* list) {
+                return std::binary_search(list->begin(), list->end(), index);
+            });
+            const StudentEntry& entry = data.entries.at(index);
+            // 三元组都命中不代表连续出现，最终确认一次
+            if (inAll && (data.idKeys.at(index).contains(needle) || data.nameKeys.at(index).contains(needle)
+                          || entry.initials.contains(needle))) {
+                candidates.append(index);
+            }
+        }
+    }
+
+    // 排序键：匹配等级、姓名长度、学号
+    auto rankOf = [&](int index) {
+        if (data.idKeys.at(index) == needle) return 0;
+        if (data.idKeys.at(index).startsWith(needle)) return 1;
+        if (data.nameKeys.at(index).startsWith(needle)) return 2;
+        if (data.entries.at(index).initials.startsWith(needle)) return 3;
+        return 4;
+    };
+    struct Ranked { int rank; int index; };
+    QVector<Ranked> ranked;
+    ranked.reserve(candidates.size());
+    for (int index : candidates) ranked.append({rankOf(index), index});
+
+    auto less = [&](const Ranked& a, const Ranked& b) {
+        if (a.rank != b.rank) return a.rank < b.rank;
+        int lengthA = data.nameKeys.at(a.index).size();
+        int lengthB = data.nameKeys.at(b.index).size();
+        if (lengthA != lengthB) return lengthA < lengthB;
+        return a.index < b.index;
+    };
+    int count = qMin(limit, int(ranked.size()));
+    std::partial_sort(ranked.begin(), ranked.begin() + count, ranked.end(), less);
+
+    for (int i = 0; i < count; i++) {
+        results.append(data.entries.at(ranked.at(i).index));
+    }
+    return results;
+}
@@ -0,0 +1,71 @@
+#ifndef STUDENTINDEX_H
+#define STUDENTINDEX_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QVector>
+#include <memory>
+
+// 搜索结果/索引条目
+struct StudentEntry {
+    QString studentId;
+    QString name;
+    QString className;
+    QString initials;   // 姓名拼音首字母（小写），如 张三 -> zs
+
+    QString displayText() const { return QString("%1 - %2").arg(studentId, name); }
+};
+
+// 学生内存检索索引：对 学号、姓名、拼音首字母 建 1~3 字符的 n-gram 倒排表。
+// 不超过3个字符的输入直接取倒排表，更长的输入取各三元组倒排表的交集再校验，
+// 每次按键只触及候选条目，不扫描全部学生。
+class StudentIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    static StudentIndex& getInstance() {
+        static StudentIndex instance;
+        return instance;
+    }
+
+    // 在工作线程从数据库重建索引，完成后发出 reloaded
+    void reload();
+    bool isLoaded() const { return m_data != nullptr; }
+    bool isLoading() const { return m_loading; }
+    int size() const { return m_data ? m_data->entries.size() : 0; }
+    // 索引占用的堆内存（构建时估算，字节）
+    qint64 memoryUsage() const { return m_data ? m_data->bytes : 0; }
+
+    // 匹配度最高的前 limit 个学生：学号完全匹配 > 学号前缀 > 姓名前缀 > 首字母前缀 > 包含
+    QList<StudentEntry> search(const QString& text, int limit) const;
+
+    // 汉字的拼音首字母（小写），非汉字原样小写返回
+    static QString pinyinInitials(const QString& name);
+
+signals:
+    void reloaded(int count);
+    void reloadFailed(const QString& reason);
+
+private:
+    StudentIndex();
+    StudentIndex(const StudentIndex&) = delete;
+    StudentIndex& operator=(const StudentIndex&) = delete;
+
+    struct Data {
+        QVector<StudentEntry> entries;
+        QVector<QString> idKeys;        // 小写学号
+        QVector<QString> nameKeys;      // 小写姓名
+        QHash<quint64, QVector<int>> postings; // n-gram -> 条目下标（升序）
+        qint64 bytes = 0;               // 估算的堆内存
+    };
+    static std::shared_ptr<const Data> build(QVector<StudentEntry> entries);
+    static quint64 gramKey(const QString& text, int pos, int length);
+
+    std::shared_ptr<const Data> m_data;
+    bool m_loading = false;
+};
+
+#endif // STUDENTINDEX_H
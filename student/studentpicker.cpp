@@ -0,0 +1,111 @@
+#include "studentpicker.h"
+#include <QComboBox>
+#include <QCompleter>
+#include <QLineEdit>
+#include <QAbstractItemView>
+
+// ========== 候选模型 ==========
+void StudentMatchModel::setMatches(const QList<StudentEntry>& matches)
+{
+    beginResetModel();
+    m_matches = matches;
+    endResetModel();
+}
+
+int StudentMatchModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_matches.size();
+}
+
+QVariant StudentMatchModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_matches.size()) return QVariant();
+    const StudentEntry& entry = m_matches.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+        return entry.className.isEmpty() ? entry.displayText()
+                                         : QString("%1（%2）").arg(entry.displayText(), entry.className);
+    case Qt::EditRole:
+        return entry.displayText();
+    case Qt::UserRole:
+        return entry.studentId;
+    default:
+        return QVariant();
+    }
+}
+
+// ========== 选择器 ==========
+StudentPicker::StudentPicker(QComboBox *comboBox, int topK)
+    : QObject(comboBox)
+    , m_comboBox(comboBox)
+    , m_completer(new QCompleter(this))
+    , m_model(new StudentMatchModel(this))
+    , m_topK(topK)
+{
+    m_comboBox->clear();
+    m_comboBox->setEditable(true);
+    m_comboBox->setInsertPolicy(QComboBox::NoInsert);
+    m_comboBox->lineEdit()->setPlaceholderText("输入学号/姓名/拼音首字母搜索");
+
+    // 候选已由索引排好序，补全器不再二次过滤
+    m_completer->setModel(m_model);
+    m_completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    m_completer->setMaxVisibleItems(qMin(m_topK, 12));
+    m_comboBox->setCompleter(m_completer);
+
+    connect(m_comboBox->lineEdit(), &QLineEdit::textEdited, this, &StudentPicker::onTextEdited);
+    connect(m_comboBox->lineEdit(), &QLineEdit::editingFinished, this, &StudentPicker::onEditingFinished);
+    connect(m_completer, QOverload<const QModelIndex&>::of(&QCompleter::activated),
+            this, &StudentPicker::onActivated);
+
+    StudentIndex& index = StudentIndex::getInstance();
+    connect(&index, &StudentIndex::reloaded, this, [this]() {
+        // 索引就绪前已输入的内容，加载完成后补一次查询
+        if (m_comboBox->lineEdit()->hasFocus()) onTextEdited(m_comboBox->lineEdit()->text());
+    });
+    if (!index.isLoaded()) index.reload();
+}
+
+QString StudentPicker::currentStudentId() const
+{
+    return m_comboBox->currentData().toString();
+}
+
+void StudentPicker::clearSelection()
+{
+    m_comboBox->clear();
+    m_model->setMatches({});
+}
+
+void StudentPicker::onTextEdited(const QString& text)
+{
+    m_model->setMatches(StudentIndex::getInstance().search(text, m_topK));
+    if (m_model->rowCount() > 0) {
+        m_completer->complete();
+    } else {
+        m_completer->popup()->hide();
+    }
+}
+
+void StudentPicker::onActivated(const QModelIndex& index)
+{
+    // 补全器的 index 属于内部代理模型，按行号取回候选
+    int row = index.row();
+    if (row < 0 || row >= m_model->rowCount()) return;
+    const StudentEntry entry = m_model->entryAt(row);
+
+    m_comboBox->clear();
+    m_comboBox->addItem(entry.displayText(), entry.studentId);
+    m_comboBox->setCurrentIndex(0);
+    emit studentSelected(entry.studentId);
+}
+
+void StudentPicker::onEditingFinished()
+{
+    // 未从候选中选择时，输入框恢复为当前选中的学生
+    if (m_comboBox->currentIndex() >= 0) {
+        m_comboBox->lineEdit()->setText(m_comboBox->currentText());
+    } else {
+        m_comboBox->lineEdit()->clear();
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef STUDENTPICKER_H
+#define STUDENTPICKER_H
+
+#include <QObject>
+#include <QAbstractListModel>
+#include "studentindex.h"
+
+class QComboBox;
+class QCompleter;
+
+// 补全候选：只保存当前输入的前K个结果
+class StudentMatchModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit StudentMatchModel(QObject *parent = nullptr) : QAbstractListModel(parent) {}
+
+    void setMatches(const QList<StudentEntry>& matches);
+    const StudentEntry& entryAt(int row) const { return m_matches.at(row); }
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+private:
+    QList<StudentEntry> m_matches;
+};
+
+// 学生搜索选择器：把下拉框改为可输入，按 学号/姓名/拼音首字母 边输边查。
+// 下拉框只保留选中的学生（itemData 为学号），原有 currentData() 取值方式不变。
+class StudentPicker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StudentPicker(QComboBox *comboBox, int topK = 20);
+
+    QString currentStudentId() const;
+    void clearSelection();
+
+signals:
+    void studentSelected(const QString& studentId);
+
+private slots:
+    void onTextEdited(const QString& text);
+    void onActivated(const QModelIndex& index);
+    void onEditingFinished();
+
+private:
+    QComboBox *m_comboBox;
+    QCompleter *m_completer;
+    StudentMatchModel *m_model;
+    int m_topK;
+};
+
+#endif // STUDENTPICKER_H
@@ -0,0 +1,316 @@
+#include "transcriptgenerator.h"
+#include "dbmanager.h"
+#include "memoryaccounting.h"
+#include <QDir>
+#include <QFuture>
+#include <QMutex>
+#include <QPageLayout>
+#include <QPageSize>
+#include <QPdfWriter>
+#include <QQueue>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QSet>
+#include <QTextDocument>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// 一名学生的成绩（扫描时按科目汇总，明细按日期有序）
+struct TranscriptRecord {
+    struct Exam {
+        QDate date;
+        double score;
+    };
+    struct Course {
+        QString name;
+        QList<Exam> exams;
+        double total = 0;
+        double best = 0;
+        double worst = 0;
+
+        double average() const { return exams.isEmpty() ? 0 : total / exams.size(); }
+    };
+
+    QString studentId;
+    QString name;
+    QString className;
+    QString gender;
+    QList<Course> courses;
+
+    qint64 memoryUsage() const {
+        qint64 bytes = qint64(sizeof(TranscriptRecord)) + (studentId.size() + name.size() + className.size()) * 2;
+        for (const Course& course : courses) {
+            bytes += qint64(sizeof(Course)) + course.name.size() * 2 + course.exams.size() * qint64(sizeof(Exam));
+        }
+        return bytes;
+    }
+};
+
+// 所有成绩单共用的页眉与样式
+struct TranscriptHeading {
+    QString title;
+    QString rangeText;
+    QString generatedAt;
+};
+
+// 排版模板：文档对象、样式表与字体只初始化一次，每张成绩单只替换正文
+class TranscriptLayout
+{
+public:
+    TranscriptLayout()
+    {
+        m_document.setDefaultStyleSheet(
+            "h1 { font-size: 16pt; text-align: center; margin-bottom: 4px; }"
+            "p.sub { text-align: center; color: #555555; margin-top: 0px; }"
+            "table { border-collapse: collapse; margin-top: 8px; }"
+            "th { background-color: #dddddd; padding: 3px 6px; }"
+            "td { padding: 3px 6px; }"
+            "td.num { text-align: right; }"
+            ".fail { color: #cc0000; }"
+            "p.foot { color: #555555; font-size: 8pt; }");
+        QFont font = m_document.defaultFont();
+        font.setPointSize(10);
+        m_document.setDefaultFont(font);
+    }
+
+    bool write(const TranscriptRecord& record, const TranscriptHeading& heading, const QString& path)
+    {
+        m_document.setHtml(html(record, heading));
+
+        // 先写入临时文件，完整生成后才替换目标
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) return false;
+        {
+            QPdfWriter writer(&file);
+            writer.setTitle(QString("%1 - %2").arg(heading.title, record.name));
+            writer.setCreator("学生成绩管理系统");
+            writer.setPageLayout(QPageLayout(QPageSize(QPageSize::A4), QPageLayout::Portrait,
+                                             QMarginsF(15, 15, 15, 15), QPageLayout::Millimeter));
+            m_document.print(&writer); // 按页面尺寸分页
+        }
+        return file.commit();
+    }
+
+private:
+    static QString scoreCell(double score, int precision)
+    {
+        return QString("<td class=\"num%1\">%2</td>").arg(score < 60 ? " fail" : "").arg(score, 0, 'f', precision);
+    }
+
+    static QString html(const TranscriptRecord& record, const TranscriptHeading& heading)
+    {
+        QString body;
+        body.reserve(4096);
+        body += QString("<h1>%1</h1><p class=\"sub\">%2</p>").arg(heading.title.toHtmlEscaped(), heading.rangeText);
+        body += QString("<table width=\"100%\"><tr><td>学号：%1</td><td>姓名：%2</td><td>班级：%3</td><td>性别：%4</td></tr></table>")
+                    .arg(record.studentId.toHtmlEscaped(), record.name.toHtmlEscaped(),
+                         record.className.toHtmlEscaped(), record.gender.toHtmlEscaped());
+
+        // 科目汇总
+        body += "<table border=\"1\" width=\"100%\"><tr><th>科目</th><th>考试次数</th><th>平均分</th>"
+                "<th>最高分</th><th>最低分</th><th>最近成绩</th></tr>";
+        double averageSum = 0;
+        int failed = 0;
+        for (const TranscriptRecord::Course& course : record.courses) {
+            double average = course.average();
+            averageSum += average;
+            if (average < 60) failed++;
+            body += QString("<tr><td>%1</td><td class=\"num\">%2</td>").arg(course.name.toHtmlEscaped()).arg(course.exams.size());
+            body += scoreCell(average, 1) + scoreCell(course.best, 1) + scoreCell(course.worst, 1)
+                    + scoreCell(course.exams.last().score, 1) + "</tr>";
+        }
+        body += "</table>";
+        body += QString("<p>科目平均分：%1　　不及格科目：%2 门</p>")
+                    .arg(record.courses.isEmpty() ? 0.0 : averageSum / record.courses.size(), 0, 'f', 1)
+                    .arg(failed);
+
+        // 考试明细
+        body += "<table border=\"1\" width=\"100%\"><tr><th>科目</th><th>考试日期</th><th>成绩</th></tr>";
+        for (const TranscriptRecord::Course& course : record.courses) {
+            for (const TranscriptRecord::Exam& exam : course.exams) {
+                body += QString("<tr><td>%1</td><td>%2</td>").arg(course.name.toHtmlEscaped(), exam.date.toString("yyyy-MM-dd"));
+                body += scoreCell(exam.score, 1) + "</tr>";
+            }
+        }
+        body += "</table>";
+        body += QString("<p class=\"foot\">生成时间：%1</p>").arg(heading.generatedAt);
+        return body;
+    }
+
+    QTextDocument m_document;
+};
+
+// 排版模板池：归一次 generate() 调用所有，任务借出、用完归还（数量不超过并发任务数），
+// 调用结束时随之释放，不会在线程池线程上存活到 QApplication 之后
+class LayoutPool
+{
+public:
+    std::unique_ptr<TranscriptLayout> take()
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_free.empty()) return std::make_unique<TranscriptLayout>();
+        std::unique_ptr<TranscriptLayout> layout = std::move(m_free.back());
+        m_free.pop_back();
+        return layout;
+    }
+
+    void give(std::unique_ptr<TranscriptLayout> layout)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_free.push_back(std::move(layout));
+    }
+
+private:
+    QMutex m_mutex;
+    std::vector<std::unique_ptr<TranscriptLayout>> m_free;
+};
+
+bool writeTranscript(LayoutPool *pool, std::shared_ptr<const TranscriptRecord> record,
+                     std::shared_ptr<const TranscriptHeading> heading, const QString& path)
+{
+    std::unique_ptr<TranscriptLayout> layout = pool->take();
+    bool ok = layout->write(*record, *heading, path);
+    pool->give(std::move(layout));
+    return ok;
+}
+
+// 文件/目录名中去掉路径非法字符
+QString safeFileName(const QString& name)
+{
+    QString result = name;
+    result.replace(QRegularExpression(R"([\\/:*?"<>|\s])"), "_");
+    return result.isEmpty() ? QString("未分班") : result;
+}
+
+} // namespace
+
+int TranscriptGenerator::generate(const TranscriptOptions& options, QString *errorMessage,
+                                  const std::function<bool(int, int)>& progress)
+{
+    auto fail = [errorMessage](const QString& message) {
+        if (errorMessage) *errorMessage = message;
+        return -1;
+    };
+
+    QDir outputDir(options.outputDir);
+    if (!outputDir.mkpath(".")) {
+        return fail(QString("无法创建输出目录：%1").arg(options.outputDir));
+    }
+
+    auto heading = std::make_shared<TranscriptHeading>();
+    heading->rangeText = (options.from.isValid() || options.to.isValid())
+                             ? QString("%1 ~ %2").arg(options.from.isValid() ? options.from.toString("yyyy-MM-dd") : "不限",
+                                                      options.to.isValid() ? options.to.toString("yyyy-MM-dd") : "不限")
+                             : QString("全部成绩");
+    heading->title = options.title.isEmpty() ? QString("学生成绩单") : options.title;
+    heading->generatedAt = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm");
+
+    // 一次有序扫描：学号→科目→日期，内存中只保留当前学生
+    QString sql = QString(
+                      "SELECT sc.student_id, st.student_name, st.class_name, st.gender, sc.course_id, c.course_name, "
+                      "sc.exam_date, sc.score "
+                      "FROM %1 sc "
+                      "JOIN students st ON st.student_id = sc.student_id "
+                      "JOIN courses c ON c.course_id = sc.course_id "
+                      "WHERE sc.score >= 0 AND sc.score <= 100%2%3 "
+                      "ORDER BY sc.student_id, sc.course_id, sc.exam_date")
+                      .arg(DBManager::getInstance().scoreSource(options.from, options.to),
+                           QString(options.className.isEmpty() ? "" : " AND st.class_name = ?"),
+                           DBManager::dateRangeSql("sc.exam_date", options.from, options.to));
+    QSqlQuery query(DBManager::getInstance().threadConnection());
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    if (!options.className.isEmpty()) query.addBindValue(options.className);
+    if (!query.exec()) {
+        return fail("查询成绩失败：" + query.lastError().text());
+    }
+
+    // 限制在途的排版任务数，扫描不会远远领先于写文件；每条返回路径都先 reap(0) 再释放模板池
+    LayoutPool layouts;
+    const int maxInFlight = qMax(2, QThreadPool::globalInstance()->maxThreadCount() * 2);
+    QQueue<QFuture<bool>> inFlight;
+    QQueue<qint64> inFlightBytes;
+    qint64 inFlightTotal = 0;
+    MemoryCharge inFlightCharge("export", "成绩单在途");
+    int submitted = 0;
+    int written = 0;
+    bool canceled = false;
+    auto reap = [&](int keep) {
+        while (inFlight.size() > keep) {
+            if (inFlight.dequeue().result()) written++;
+            inFlightTotal -= inFlightBytes.dequeue();
+            inFlightCharge.update(inFlightTotal, inFlight.size());
+        }
+    };
+
+    QSet<QString> classDirs;
+    auto flush = [&](std::shared_ptr<TranscriptRecord>& record) {
+        if (!record || record->courses.isEmpty() || canceled) return;
+        QString dirName = safeFileName(record->className);
+        if (!classDirs.contains(dirName)) {
+            outputDir.mkpath(dirName);
+            classDirs.insert(dirName);
+        }
+        QString path = outputDir.filePath(QString("%1/%2_%3.pdf").arg(dirName, safeFileName(record->studentId),
+                                                                       safeFileName(record->name)));
+        inFlightBytes.enqueue(record->memoryUsage());
+        inFlightTotal += inFlightBytes.last();
+        inFlight.enqueue(QtConcurrent::run(writeTranscript, &layouts, std::shared_ptr<const TranscriptRecord>(record),
+                                           heading, path));
+        inFlightCharge.update(inFlightTotal, inFlight.size());
+        record.reset();
+        submitted++;
+        reap(maxInFlight);
+        if (progress && !progress(written, submitted)) canceled = true;
+    };
+
+    std::shared_ptr<TranscriptRecord> record;
+    qint64 currentStudent = -1;
+    int currentCourse = -1;
+    while (query.next() && !canceled) {
+        qint64 studentId = query.value(0).toLongLong();
+        if (studentId != currentStudent) {
+            flush(record);
+            currentStudent = studentId;
+            currentCourse = -1;
+            record = std::make_shared<TranscriptRecord>();
+            record->studentId = query.value(0).toString();
+            record->name = query.value(1).toString();
+            record->className = query.value(2).toString();
+            record->gender = query.value(3).toString();
+        }
+        int courseId = query.value(4).toInt();
+        double score = DBManager::scoreAt(query, 7);
+        if (courseId != currentCourse) {
+            currentCourse = courseId;
+            TranscriptRecord::Course course;
+            course.name = query.value(5).toString();
+            course.best = score;
+            course.worst = score;
+            record->courses.append(course);
+        }
+        TranscriptRecord::Course& course = record->courses.last();
+        course.exams.append({DBManager::dateAt(query, 6), score});
+        course.total += score;
+        course.best = qMax(course.best, score);
+        course.worst = qMin(course.worst, score);
+    }
+    if (query.lastError().isValid()) {
+        reap(0);
+        return fail("读取成绩失败：" + query.lastError().text());
+    }
+    flush(record);
+    reap(0);
+
+    if (canceled) {
+        return fail(QString("生成已取消，已完成 %1 份成绩单").arg(written));
+    }
+    if (written < submitted) {
+        return fail(QString("部分成绩单写入失败：成功 %1 / %2").arg(written).arg(submitted));
+    }
+    return written;
+}
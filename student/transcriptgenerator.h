@@ -0,0 +1,28 @@
+#ifndef TRANSCRIPTGENERATOR_H
+#define TRANSCRIPTGENERATOR_H
+
+#include <QString>
+#include <QDate>
+#include <functional>
+
+// 成绩单批量生成参数
+struct TranscriptOptions {
+    QString outputDir;        // 按班级分子目录：<目录>/<班级>/<学号>_<姓名>.pdf
+    QString className;        // 空为全部班级
+    QDate from;               // 学期日期范围，空为不限
+    QDate to;
+    QString title;            // 页眉标题，空时按日期范围生成
+};
+
+// 学生成绩单批量生成：一次按 学号→科目→日期 有序扫描全部成绩，逐个学生汇总；
+// 排版（QTextDocument）与写 PDF（QPdfWriter）在线程池并行完成，排版模板在一次生成中复用（数量不超过并发任务数）。
+// 不依赖界面，可在 offscreen 平台下运行。
+class TranscriptGenerator
+{
+public:
+    // progress(已完成, 已提交) 返回 false 时中止；返回生成的成绩单数，失败返回 -1
+    static int generate(const TranscriptOptions& options, QString *errorMessage = nullptr,
+                        const std::function<bool(int, int)>& progress = nullptr);
+};
+
+#endif // TRANSCRIPTGENERATOR_H